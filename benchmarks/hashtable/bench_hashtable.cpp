@@ -66,6 +66,7 @@ void RunBenchmark(api::Context& ctx, core::DefaultReduceConfig& base_config) {
         core::DefaultReduceConfigSelect<table_impl> >
     phase(ctx, 0, key_ex, red_fn, emit_fn,
           config);
+    phase.Initialize(ctx.mem_limit() / 2);
 
     common::StatsTimerStart timer;
 
@@ -102,7 +103,7 @@ int main(int argc, char* argv[]) {
                   "Load in byte to be inserted");
 
     clp.AddString('h', "hash-table", "H", hashtable,
-                  "Set hashtable: probing or bucket");
+                  "Set hashtable: probing, tagged or bucket");
 
     clp.AddUInt('w', "workers", "W", workers,
                 "Open hashtable with W workers, default = 1.");
@@ -127,6 +128,9 @@ int main(int argc, char* argv[]) {
         [&](api::Context& ctx) {
             if (hashtable == "bucket")
                 return RunBenchmark<core::ReduceTableImpl::BUCKET>(ctx, config);
+            else if (hashtable == "tagged")
+                return RunBenchmark<core::ReduceTableImpl::TAGGED_PROBING>(
+                    ctx, config);
             else
                 return RunBenchmark<core::ReduceTableImpl::PROBING>(ctx, config);
         });
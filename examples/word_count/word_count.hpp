@@ -60,14 +60,15 @@ auto WordCount(const DIA<std::string, InputStack>&input) {
 
 using FastWordCountPair = std::pair<common::FastString, size_t>;
 
-//! An optimized WordCount user program: reads a DIA containing std::string
-//! words, and returns a DIA containing WordCountPairs. In the reduce step our
-//! FastString implementation is used to reduce the number of allocations.
-template <typename InputStack>
-auto FastWordCount(const DIA<std::string, InputStack>&input) {
+//! An optimized WordCount user program: reads a DIA containing std::string or
+//! FastString lines, and returns a DIA containing WordCountPairs. In the reduce
+//! step our FastString implementation is used to reduce the number of
+//! allocations.
+template <typename Line, typename InputStack>
+auto FastWordCount(const DIA<Line, InputStack>&input) {
 
     auto word_pairs = input.template FlatMap<FastWordCountPair>(
-        [](const std::string& line, auto emit) -> void {
+        [](const Line& line, auto emit) -> void {
                 /* map lambda: emit each word */
             common::SplitView(
                 line, ' ', [&](const common::StringView& sv) {
@@ -57,7 +57,8 @@ static void RunFastWordCount(
     const std::vector<std::string>& input_filelist, const std::string& output) {
     ctx.enable_consume();
 
-    auto lines = ReadLines(ctx, input_filelist);
+    // lines reference the read buffer, no std::string is constructed.
+    auto lines = ReadLines<common::FastString>(ctx, input_filelist);
 
     auto word_pairs = FastWordCount(lines);
 
@@ -123,6 +123,48 @@ TEST(GroupByNode, Median) {
     api::RunLocalTests(start_func);
 }
 
+TEST(GroupByNode, HashGroupingSum) {
+
+    auto start_func =
+        [](Context& ctx) {
+            size_t n = 100000;
+            static constexpr size_t m = 1000;
+
+            auto sizets = Generate(ctx, n);
+
+            auto modulo_keyfn = [](size_t in) { return (in % m); };
+
+            auto sum_fn =
+                [](auto& r, size_t key) {
+                    size_t res = 0;
+                    while (r.HasNext()) {
+                        size_t n = r.Next();
+                        die_unequal(n % m, key);
+                        res += n;
+                    }
+                    return res;
+                };
+
+            // group by hashing to compute sum and gather results
+            auto reduced = sizets.GroupByKey<size_t>(
+                modulo_keyfn, sum_fn, api::HashGroupByConfig());
+            std::vector<size_t> out_vec = reduced.AllGather();
+
+            // compute vector with expected results
+            std::vector<size_t> res_vec(m, 0);
+            for (size_t t = 0; t < n; ++t) {
+                res_vec[t % m] += t;
+            }
+
+            std::sort(out_vec.begin(), out_vec.end());
+            std::sort(res_vec.begin(), res_vec.end());
+
+            ASSERT_EQ(res_vec, out_vec);
+        };
+
+    api::RunLocalTests(start_func);
+}
+
 TEST(GroupByNode, GroupToIndexCorrectResults) {
 
     auto start_func =
@@ -399,6 +399,32 @@ TEST(Operations, GenerateFilterRebalance) {
     api::RunLocalTests(start_func);
 }
 
+TEST(Operations, CachePushesBatchesInOrderThroughStatefulMap) {
+
+    static constexpr size_t test_size = 10000;
+
+    auto start_func =
+        [](Context& ctx) {
+
+            auto dia1 = Generate(ctx, test_size).Cache().Execute();
+
+            // the Map's state must see all items in order, regardless of
+            // whether they are pushed one by one or in batches.
+            bool first = true;
+            size_t prev = 0;
+            auto in_order = dia1.Map(
+                [&first, &prev](const size_t& index) -> size_t {
+                    size_t ok = (first || prev + 1 == index) ? 1 : 0;
+                    first = false, prev = index;
+                    return ok;
+                });
+
+            ASSERT_EQ(test_size, in_order.Sum());
+        };
+
+    api::RunLocalTests(start_func);
+}
+
 TEST(Operations, MapResultsCorrectChangingType) {
 
     auto start_func =
@@ -19,9 +19,11 @@
 #include <thrill/api/write_binary.hpp>
 #include <thrill/api/write_lines.hpp>
 #include <thrill/api/write_lines_one.hpp>
+#include <thrill/common/fast_string.hpp>
 #include <thrill/common/logger.hpp>
 #include <thrill/common/system_exception.hpp>
 #include <thrill/core/file_io.hpp>
+#include <thrill/core/gzip.hpp>
 
 #include <sys/stat.h>
 
@@ -29,7 +31,9 @@
 #include <cstdlib>
 #include <fstream>
 #include <functional>
+#include <iterator>
 #include <random>
+#include <sstream>
 #include <string>
 #include <utility>
 #include <vector>
@@ -93,6 +97,112 @@ TEST(IO, ReadPartOfFolderCompressed) {
     api::RunLocalTests(start_func);
 }
 
+TEST(IO, ReadLinesFastStringEqualsString) {
+    auto start_func =
+        [](Context& ctx) {
+            // inputs with compressed files, and with lines spanning blocks
+            for (const char* glob :
+                 { "inputs/read_ints/read*", "inputs/wordcount.in" })
+            {
+                std::vector<std::string> lines = ReadLines(ctx, glob).AllGather();
+
+                // FastStrings reference the read buffer, gathering copies them
+                std::vector<std::string> fast_lines =
+                    ReadLines<common::FastString>(ctx, glob)
+                    .Map([](const common::FastString& line) {
+                             return line.ToString();
+                         })
+                    .AllGather();
+
+                ASSERT_EQ(lines, fast_lines);
+            }
+        };
+
+    api::RunLocalTests(start_func);
+}
+
+TEST(IO, ReadLinesAsyncAndMmap) {
+    // expected lines read with std::getline
+    std::vector<std::string> expected;
+    {
+        std::ifstream in("inputs/wordcount.in");
+        std::string line;
+        while (std::getline(in, line))
+            expected.emplace_back(line);
+    }
+
+    auto start_func =
+        [&expected](Context& ctx) {
+            std::vector<std::string> lines =
+                ReadLines(ctx, "inputs/wordcount.in").AllGather();
+            ASSERT_EQ(expected, lines);
+        };
+
+    // read ahead asynchronously, then map the file
+    for (bool use_mmap : { false, true }) {
+        core::default_read_mmap = use_mmap;
+        api::RunLocalTests(start_func);
+    }
+    core::default_read_mmap = false;
+}
+
+TEST(IO, ReadLinesSplitBgzf) {
+    if (!core::HaveZlib()) return;
+
+    core::TemporaryDirectory tmpdir;
+    std::string path = tmpdir.get() + "/wordcount.in.gz";
+
+    std::vector<std::string> expected;
+    {
+        std::ifstream in("inputs/wordcount.in");
+        std::string text((std::istreambuf_iterator<char>(in)),
+                         std::istreambuf_iterator<char>());
+
+        // compress into small BGZF blocks, which split lines, and append the
+        // empty end of file block.
+        std::ofstream out(path, std::ios::binary);
+        std::vector<char> block(core::bgzf_max_block_size);
+        for (size_t i = 0; i < text.size(); i += 1000) {
+            size_t size = std::min<size_t>(1000, text.size() - i);
+            size_t bsize = core::BgzfCompress(
+                text.data() + i, size, block.data(), block.size());
+            ASSERT_NE(0u, bsize);
+            out.write(block.data(), bsize);
+        }
+        size_t bsize = core::BgzfCompress(
+            text.data(), 0, block.data(), block.size());
+        ASSERT_EQ(28u, bsize);
+        out.write(block.data(), bsize);
+
+        std::istringstream lines(text);
+        std::string line;
+        while (std::getline(lines, line))
+            expected.emplace_back(line);
+    }
+
+    core::SysFileList files = core::GlobFileSizePrefixSum({ path });
+    ASSERT_TRUE(files.list[0].is_bgzf);
+    ASSERT_FALSE(files.contains_unsplittable);
+
+    auto start_func =
+        [&](Context& ctx) {
+            std::vector<std::string> lines = ReadLines(ctx, path).AllGather();
+            ASSERT_EQ(expected, lines);
+
+            // mixed with an uncompressed file
+            lines = ReadLines(
+                ctx, std::vector<std::string>{ "inputs/wordcount.in", path })
+                    .AllGather();
+            ASSERT_EQ(2 * expected.size(), lines.size());
+            ASSERT_TRUE(std::equal(expected.begin(), expected.end(),
+                                   lines.begin()));
+            ASSERT_TRUE(std::equal(expected.begin(), expected.end(),
+                                   lines.begin() + expected.size()));
+        };
+
+    api::RunLocalTests(start_func);
+}
+
 TEST(IO, GenerateFromFileRandomIntegers) {
     api::RunLocalSameThread(
         [](api::Context& ctx) {
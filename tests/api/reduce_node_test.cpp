@@ -100,6 +100,56 @@ TEST(ReduceNode, ReduceModuloPairsCorrectResults) {
     api::RunLocalTests(start_func);
 }
 
+//! Test counting skewed keys with spreading of heavy hitter keys
+TEST(ReduceNode, ReduceSkewedKeysSpreadHeavyHitters) {
+
+    static constexpr size_t test_size = 10000u;
+
+    auto start_func =
+        [](Context& ctx) {
+
+            using IntPair = std::pair<size_t, size_t>;
+
+            // half of all items have key zero, the others have distinct keys
+            auto integers = Generate(
+                ctx, test_size,
+                [](const size_t& index) {
+                    return IntPair(index % 2 == 0 ? 0 : index, 1);
+                });
+
+            auto add_function = [](const IntPair& a, const IntPair& b) {
+                                    return IntPair(a.first, a.second + b.second);
+                                };
+
+            // flush the pre phase often to make key zero occur repeatedly
+            api::DefaultReduceConfig config;
+            config.spread_heavy_hitters_ = true;
+            config.limit_partition_fill_rate_ = 0.01;
+
+            auto check = [](std::vector<IntPair> out_vec) {
+                             std::sort(out_vec.begin(), out_vec.end());
+
+                             ASSERT_EQ(test_size / 2 + 1, out_vec.size());
+                             ASSERT_EQ(IntPair(0, test_size / 2), out_vec[0]);
+                             for (size_t i = 1; i < out_vec.size(); ++i) {
+                                 ASSERT_EQ(IntPair(2 * i - 1, 1), out_vec[i]);
+                             }
+                         };
+
+            check(integers.Keep().ReduceByKey(
+                      [](const IntPair& p) { return p.first; },
+                      add_function, config).AllGather());
+
+            auto add_counts = [](const size_t& a, const size_t& b) {
+                                  return a + b;
+                              };
+
+            check(integers.ReducePair(add_counts, config).AllGather());
+        };
+
+    api::RunLocalTests(start_func);
+}
+
 TEST(ReduceNode, ReduceToIndexCorrectResults) {
 
     auto start_func =
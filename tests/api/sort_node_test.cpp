@@ -275,4 +275,239 @@ TEST(Sort, SortZeroIntegers) {
     api::RunLocalTests(start_func);
 }
 
+TEST(Sort, SortRandomIntegersMultiLevel) {
+
+    auto start_func =
+        [](Context& ctx) {
+
+            std::default_random_engine generator(std::random_device { } ());
+            std::uniform_int_distribution<int> distribution(0, 1000);
+
+            auto integers = Generate(
+                ctx, 100000,
+                [&distribution, &generator](const size_t&) -> int {
+                    return distribution(generator);
+                });
+
+            // force the two-level sample sort
+            api::DefaultSortConfig config;
+            config.multi_level_threshold_ = 2;
+
+            auto sorted = integers.Sort(
+                std::less<int>(), api::DefaultSortAlgorithm(), config);
+
+            std::vector<int> out_vec = sorted.AllGather();
+
+            for (size_t i = 0; i < out_vec.size() - 1; i++) {
+                ASSERT_FALSE(out_vec[i + 1] < out_vec[i]);
+            }
+
+            ASSERT_EQ(100000u, out_vec.size());
+        };
+
+    api::RunLocalTests(start_func);
+}
+
+TEST(Sort, SortRandomIntegersDistributedSplitters) {
+
+    auto start_func =
+        [](Context& ctx) {
+
+            std::default_random_engine generator(std::random_device { } ());
+            std::uniform_int_distribution<int> distribution(0, 1000);
+
+            auto integers = Generate(
+                ctx, 100000,
+                [&distribution, &generator](const size_t&) -> int {
+                    return distribution(generator);
+                });
+
+            api::DefaultSortConfig config;
+            config.distributed_splitter_selection_ = true;
+
+            auto sorted1 = integers.Sort(
+                std::less<int>(), api::DefaultSortAlgorithm(), config);
+
+            // also with the two-level sample sort
+            config.multi_level_threshold_ = 2;
+
+            auto sorted2 = integers.Sort(
+                std::less<int>(), api::DefaultSortAlgorithm(), config);
+
+            std::vector<int> out_vec1 = sorted1.AllGather();
+            std::vector<int> out_vec2 = sorted2.AllGather();
+
+            for (size_t i = 0; i < out_vec1.size() - 1; i++) {
+                ASSERT_FALSE(out_vec1[i + 1] < out_vec1[i]);
+            }
+            ASSERT_EQ(100000u, out_vec1.size());
+            ASSERT_EQ(out_vec1, out_vec2);
+        };
+
+    api::RunLocalTests(start_func);
+}
+
+TEST(Sort, SortRandomIntegersParallelSortAlgorithm) {
+
+    auto start_func =
+        [](Context& ctx) {
+
+            std::default_random_engine generator(std::random_device { } ());
+            std::uniform_int_distribution<size_t> distribution(0, 1000000);
+
+            auto integers = Generate(
+                ctx, 1000000,
+                [&distribution, &generator](const size_t&) -> size_t {
+                    return distribution(generator);
+                });
+
+            auto sorted = integers.Sort(
+                std::less<size_t>(), api::ParallelSortAlgorithm(4));
+
+            std::vector<size_t> out_vec = sorted.AllGather();
+
+            for (size_t i = 0; i < out_vec.size() - 1; i++) {
+                ASSERT_FALSE(out_vec[i + 1] < out_vec[i]);
+            }
+
+            ASSERT_EQ(1000000u, out_vec.size());
+        };
+
+    api::RunLocalTests(start_func);
+}
+
+TEST(Sort, SortByKeyRandomIntegers) {
+
+    auto start_func =
+        [](Context& ctx) {
+
+            std::default_random_engine generator(std::random_device { } ());
+            std::uniform_int_distribution<int> distribution(-100000, 100000);
+
+            auto integers = Generate(
+                ctx, 1000000,
+                [&distribution, &generator](const size_t&) -> int {
+                    return distribution(generator);
+                });
+
+            auto sorted = integers.SortByKey([](const int& i) { return i; });
+
+            std::vector<int> out_vec = sorted.AllGather();
+
+            for (size_t i = 0; i < out_vec.size() - 1; i++) {
+                ASSERT_FALSE(out_vec[i + 1] < out_vec[i]);
+            }
+
+            ASSERT_EQ(1000000u, out_vec.size());
+        };
+
+    api::RunLocalTests(start_func);
+}
+
+TEST(Sort, SortByKeyByteStrings) {
+
+    using Key = std::array<uint8_t, 10>;
+    using Record = std::pair<Key, size_t>;
+
+    auto start_func =
+        [](Context& ctx) {
+
+            std::default_random_engine generator(std::random_device { } ());
+
+            auto records = Generate(
+                ctx, 100000,
+                [&generator](const size_t& index) -> Record {
+                    Record r;
+                    for (size_t i = 0; i < r.first.size(); ++i)
+                        r.first[i] = static_cast<uint8_t>(generator() % 4);
+                    r.second = index;
+                    return r;
+                });
+
+            auto sorted = records.SortByKey(
+                [](const Record& r) { return r.first; });
+
+            std::vector<Record> out_vec = sorted.AllGather();
+
+            for (size_t i = 0; i < out_vec.size() - 1; i++) {
+                ASSERT_FALSE(out_vec[i + 1].first < out_vec[i].first);
+            }
+
+            ASSERT_EQ(100000u, out_vec.size());
+        };
+
+    api::RunLocalTests(start_func);
+}
+
+TEST(Sort, SortKnownIntegersBackgroundThreads) {
+
+    static constexpr size_t test_size = 6000000u;
+
+    auto start_func =
+        [](Context& ctx) {
+
+            auto integers = Generate(
+                ctx, test_size,
+                [](const size_t& index) -> size_t {
+                    return test_size - index - 1;
+                });
+
+            api::DefaultSortConfig config;
+            config.use_background_thread_ = true;
+            config.background_sort_runs_ = true;
+
+            auto sorted = integers.Sort(
+                std::less<size_t>(), api::DefaultSortAlgorithm(), config);
+
+            std::vector<size_t> out_vec = sorted.AllGather();
+
+            ASSERT_EQ(test_size, out_vec.size());
+            for (size_t i = 0; i < out_vec.size(); i++) {
+                ASSERT_EQ(i, out_vec[i]);
+            }
+        };
+
+    // set fixed amount of RAM for testing
+    api::MemoryConfig mem_config;
+    mem_config.setup(128 * 1024 * 1024llu);
+
+    api::RunLocalMock(mem_config, 2, 1, start_func);
+}
+
+
+TEST(Sort, SortRandomIntegersParallelMerge) {
+
+    static constexpr size_t test_size = 6000000u;
+
+    auto start_func =
+        [](Context& ctx) {
+
+            auto integers = Generate(
+                ctx, test_size,
+                [](const size_t& index) -> size_t {
+                    return (index * 2654435761u) % test_size;
+                });
+
+            api::DefaultSortConfig config;
+            config.parallel_merge_threads_ = 4;
+
+            auto sorted = integers.Sort(
+                std::less<size_t>(), api::DefaultSortAlgorithm(), config);
+
+            std::vector<size_t> out_vec = sorted.AllGather();
+
+            ASSERT_EQ(test_size, out_vec.size());
+            // multiplier is coprime to test_size, hence items are a permutation
+            for (size_t i = 0; i < out_vec.size(); i++) {
+                ASSERT_EQ(i, out_vec[i]);
+            }
+        };
+
+    // set fixed amount of RAM for testing, such that many runs are merged
+    api::MemoryConfig mem_config;
+    mem_config.setup(128 * 1024 * 1024llu);
+
+    api::RunLocalMock(mem_config, 2, 1, start_func);
+}
+
 /******************************************************************************/
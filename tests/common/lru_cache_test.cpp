@@ -57,4 +57,21 @@ TEST(LruCacheTest1, KeepAllValuesWithinCapacity) {
     EXPECT_EQ(kTest2CacheCapacity, size);
 }
 
+TEST(LruCacheSetTest, PutBackIsPoppedFirst) {
+    common::LruCacheSet<int> cache;
+
+    cache.put(1);
+    cache.put(2);
+    cache.put_back(3);
+    cache.put(4);
+    // replacing moves an existing item to the back
+    cache.put_back(2);
+
+    EXPECT_EQ(4u, cache.size());
+    EXPECT_EQ(2, cache.pop());
+    EXPECT_EQ(3, cache.pop());
+    EXPECT_EQ(1, cache.pop());
+    EXPECT_EQ(4, cache.pop());
+}
+
 /******************************************************************************/
@@ -0,0 +1,96 @@
+/*******************************************************************************
+ * tests/common/lz_codec_test.cpp
+ *
+ * Part of Project Thrill - http://project-thrill.org
+ *
+ * Copyright (C) 2016 Timo Bingmann <tb@panthema.net>
+ *
+ * All rights reserved. Published under the BSD-2 license in the LICENSE file.
+ ******************************************************************************/
+
+#include <thrill/common/lz_codec.hpp>
+
+#include <gtest/gtest.h>
+
+#include <random>
+#include <string>
+#include <vector>
+
+using namespace thrill;
+
+static void CheckRoundTrip(const std::string& input, bool compressible) {
+    std::vector<char> compressed(input.size() + input.size() / 255 + 16);
+
+    size_t csize = common::LzCompress(
+        input.data(), input.size(), compressed.data(), compressed.size());
+    ASSERT_GT(csize, 0u);
+
+    if (compressible)
+        ASSERT_LT(csize, input.size() / 2);
+
+    std::string output(input.size(), 0);
+    ASSERT_TRUE(common::LzDecompress(
+                    compressed.data(), csize, &output[0], output.size()));
+    ASSERT_EQ(input, output);
+
+    // wrong output sizes must be detected
+    std::string longer(input.size() + 1, 0);
+    ASSERT_FALSE(common::LzDecompress(
+                     compressed.data(), csize, &longer[0], longer.size()));
+}
+
+TEST(LzCodec, ShortAndEmpty) {
+    for (size_t n = 0; n < 40; ++n)
+        CheckRoundTrip(std::string(n, 'a' + n % 26), false);
+}
+
+TEST(LzCodec, RepetitiveText) {
+    std::string text;
+    for (size_t i = 0; i < 100000; ++i)
+        text += "word" + std::to_string(i % 1000) + " ";
+    CheckRoundTrip(text, true);
+
+    // long runs produce overlapping back-references and long lengths
+    CheckRoundTrip(std::string(100000, 'x') + "end" + std::string(300, 'y'),
+                   true);
+}
+
+TEST(LzCodec, RandomData) {
+    std::default_random_engine rng(123456);
+    std::string data(100000, 0);
+    for (char& c : data) c = static_cast<char>(rng());
+
+    CheckRoundTrip(data, false);
+
+    // does not fit into a buffer smaller than the input
+    std::vector<char> compressed(data.size() - data.size() / 8);
+    ASSERT_EQ(0u, common::LzCompress(
+                  data.data(), data.size(),
+                  compressed.data(), compressed.size()));
+}
+
+TEST(LzCodec, CorruptInput) {
+    std::string text;
+    for (size_t i = 0; i < 10000; ++i)
+        text += std::to_string(i % 100);
+
+    std::vector<char> compressed(text.size() * 2);
+    size_t csize = common::LzCompress(
+        text.data(), text.size(), compressed.data(), compressed.size());
+    ASSERT_GT(csize, 0u);
+
+    // truncated or damaged input must not decode successfully
+    std::string output(text.size(), 0);
+    ASSERT_FALSE(common::LzDecompress(
+                     compressed.data(), csize / 2, &output[0], output.size()));
+
+    std::default_random_engine rng(42);
+    for (size_t i = 0; i < 100; ++i) {
+        std::vector<char> damaged = compressed;
+        damaged[rng() % csize] ^= static_cast<char>(1 + rng() % 255);
+        // only checks that decoding stays within its buffers
+        common::LzDecompress(damaged.data(), csize, &output[0], output.size());
+    }
+}
+
+/******************************************************************************/
@@ -0,0 +1,87 @@
+/*******************************************************************************
+ * tests/common/parallel_sort_test.cpp
+ *
+ * Part of Project Thrill - http://project-thrill.org
+ *
+ * Copyright (C) 2016 Timo Bingmann <tb@panthema.net>
+ *
+ * All rights reserved. Published under the BSD-2 license in the LICENSE file.
+ ******************************************************************************/
+
+#include <thrill/common/parallel_sort.hpp>
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <random>
+#include <string>
+#include <vector>
+
+using namespace thrill;
+
+//! boxed struct being sorted: only possible to compare with explicit comparator
+struct MyBoxedInteger {
+    size_t i;
+    explicit MyBoxedInteger(size_t _i) : i(_i) { }
+};
+
+//! comparator for MyBoxedInteger
+struct MyBoxedIntegerCmp {
+    bool operator () (const MyBoxedInteger& a, const MyBoxedInteger& b) const {
+        return a.i < b.i;
+    }
+};
+
+TEST(ParallelSort, RandomBoxedIntegers) {
+
+    std::default_random_engine rng(std::random_device { } ());
+
+    size_t test_size = 1000000 + rng() % 20480;
+    std::vector<MyBoxedInteger> vec;
+    vec.reserve(test_size);
+
+    for (size_t i = 0; i < test_size; ++i) {
+        vec.emplace_back(rng() % 100000);
+    }
+
+    std::vector<MyBoxedInteger> vec_correct = vec;
+    std::sort(vec_correct.begin(), vec_correct.end(), MyBoxedIntegerCmp());
+
+    common::parallel_sample_sort(
+        vec.begin(), vec.end(), MyBoxedIntegerCmp(), /* num_threads */ 4);
+
+    ASSERT_EQ(vec_correct.size(), vec.size());
+    for (size_t i = 0; i < vec.size(); ++i) {
+        ASSERT_EQ(vec_correct[i].i, vec[i].i);
+    }
+    ASSERT_EQ(0u, common::parallel_sort_busy_threads().load());
+}
+
+TEST(ParallelSort, RandomStrings) {
+
+    std::default_random_engine rng(std::random_device { } ());
+
+    std::vector<std::string> vec;
+    for (size_t i = 0; i < 200000; ++i) {
+        vec.emplace_back(std::to_string(rng() % 50000));
+    }
+
+    std::vector<std::string> vec_correct = vec;
+    std::sort(vec_correct.begin(), vec_correct.end());
+
+    common::parallel_sample_sort(
+        vec.begin(), vec.end(), std::less<std::string>(), /* num_threads */ 8);
+
+    ASSERT_EQ(vec_correct, vec);
+}
+
+TEST(ParallelSort, AllEqualIntegers) {
+
+    std::vector<size_t> vec(100000, 42);
+
+    common::parallel_sample_sort(vec.begin(), vec.end());
+
+    ASSERT_EQ(std::vector<size_t>(100000, 42), vec);
+}
+
+/******************************************************************************/
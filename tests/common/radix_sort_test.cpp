@@ -51,4 +51,27 @@ TEST(RadixSort, RandomStrings) {
     ASSERT_TRUE(std::is_sorted(vec.begin(), vec.end()));
 }
 
+TEST(RadixSort, RandomIntegerKeys) {
+
+    std::default_random_engine rng(std::random_device { } ());
+
+    size_t test_size = 1024000 + rng() % 20480;
+    std::vector<int64_t> vec;
+    vec.reserve(test_size);
+
+    for (size_t i = 0; i < test_size; ++i) {
+        vec.emplace_back(static_cast<int64_t>(rng()) - rng());
+    }
+
+    using KeyTraits = common::RadixKeyTraits<int64_t>;
+
+    common::radix_sort_key_CI<KeyTraits::key_bytes>(
+        vec.begin(), vec.end(),
+        [](const int64_t& v, size_t depth) {
+            return KeyTraits::Char(v, depth);
+        });
+
+    ASSERT_TRUE(std::is_sorted(vec.begin(), vec.end()));
+}
+
 /******************************************************************************/
@@ -0,0 +1,47 @@
+/*******************************************************************************
+ * tests/core/count_min_sketch_test.cpp
+ *
+ * Part of Project Thrill - http://project-thrill.org
+ *
+ * Copyright (C) 2016 Timo Bingmann <tb@panthema.net>
+ *
+ * All rights reserved. Published under the BSD-2 license in the LICENSE file.
+ ******************************************************************************/
+
+#include <gtest/gtest.h>
+
+#include <thrill/common/zipf_distribution.hpp>
+#include <thrill/core/count_min_sketch.hpp>
+
+#include <random>
+#include <vector>
+
+using namespace thrill; // NOLINT
+
+TEST(CountMinSketch, ZipfKeys) {
+    static constexpr size_t num_keys = 10000;
+    static constexpr size_t num_items = 100000;
+    static constexpr size_t width = 1024;
+
+    std::default_random_engine rng(1234);
+    common::ZipfDistribution zipf(num_keys, 1.0);
+
+    core::CountMinSketch<size_t> sketch(width);
+    std::vector<size_t> count(num_keys + 1, 0);
+
+    for (size_t i = 0; i < num_items; ++i) {
+        size_t key = zipf(rng);
+        ++count[key];
+        // the estimate never underestimates
+        ASSERT_GE(sketch.Insert(key), count[key]);
+    }
+    ASSERT_EQ(num_items, sketch.total());
+
+    // the most frequent keys are estimated within the error bound
+    for (size_t key = 1; key <= 10; ++key) {
+        ASSERT_GE(sketch.Estimate(key), count[key]);
+        ASSERT_LE(sketch.Estimate(key), count[key] + 3 * num_items / width);
+    }
+}
+
+/******************************************************************************/
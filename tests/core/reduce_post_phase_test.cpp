@@ -109,6 +109,83 @@ TEST(ReduceHashPhase, ProbingAddMyStructByHash) {
         });
 }
 
+TEST(ReduceHashPhase, TaggedProbingAddMyStructByHash) {
+    api::RunLocalSameThread(
+        [](Context& ctx) {
+            TestAddMyStructByHash<core::ReduceTableImpl::TAGGED_PROBING>(ctx);
+        });
+}
+
+//! insert many distinct keys into a small table, such that spilled items are
+//! re-reduced by subtables (large limit) or by external sorting (small limit)
+template <core::ReduceTableImpl table_impl>
+static void TestSpilledReReduce(Context& ctx, size_t limit_memory_bytes) {
+    static constexpr size_t mod_size = 20000;
+    static constexpr size_t test_size = mod_size * 3;
+
+    auto key_ex = [](const MyStruct& in) {
+                      return in.key % mod_size;
+                  };
+
+    auto red_fn = [](const MyStruct& in1, const MyStruct& in2) {
+                      return MyStruct {
+                                 in1.key, in1.value + in2.value
+                      };
+                  };
+
+    std::vector<MyStruct> result;
+
+    auto emit_fn = [&result](const MyStruct& in) {
+                       result.emplace_back(in);
+                   };
+
+    using Phase = core::ReduceByHashPostPhase<
+              MyStruct, size_t, MyStruct,
+              decltype(key_ex), decltype(red_fn), decltype(emit_fn), false,
+              core::DefaultReduceConfigSelect<table_impl> >;
+
+    Phase phase(ctx, 0, key_ex, red_fn, emit_fn);
+    phase.Initialize(limit_memory_bytes);
+
+    for (size_t i = 0; i < test_size; ++i) {
+        phase.Insert(MyStruct { i, 1 });
+    }
+
+    phase.PushData(/* consume */ true);
+
+    std::sort(result.begin(), result.end(),
+              [](const MyStruct& a, const MyStruct& b) {
+                  return a.key % mod_size < b.key % mod_size;
+              });
+
+    ASSERT_EQ(mod_size, result.size());
+
+    for (size_t i = 0; i < result.size(); ++i) {
+        ASSERT_EQ(i, result[i].key % mod_size);
+        ASSERT_EQ(test_size / mod_size, result[i].value);
+    }
+}
+
+TEST(ReduceHashPhase, ProbingSpilledReReduce) {
+    api::RunLocalSameThread(
+        [](Context& ctx) {
+            TestSpilledReReduce<core::ReduceTableImpl::PROBING>(
+                ctx, 256 * 1024);
+            TestSpilledReReduce<core::ReduceTableImpl::PROBING>(
+                ctx, 48 * 1024);
+        });
+}
+
+TEST(ReduceHashPhase, BucketSpilledReReduce) {
+    api::RunLocalSameThread(
+        [](Context& ctx) {
+            TestSpilledReReduce<core::ReduceTableImpl::BUCKET>(
+                ctx, 256 * 1024);
+            TestSpilledReReduce<core::ReduceTableImpl::BUCKET>(
+                ctx, 48 * 1024);
+        });
+}
+
 /******************************************************************************/
 
 TEST(ReduceHashPhase, PostReduceByIndex) {
@@ -221,6 +298,13 @@ TEST(ReduceHashPhase, ProbingAddMyStructByIndex) {
         });
 }
 
+TEST(ReduceHashPhase, TaggedProbingAddMyStructByIndex) {
+    api::RunLocalSameThread(
+        [](Context& ctx) {
+            TestAddMyStructByIndex<core::ReduceTableImpl::TAGGED_PROBING>(ctx);
+        });
+}
+
 /******************************************************************************/
 
 template <core::ReduceTableImpl table_impl>
@@ -304,4 +388,11 @@ TEST(ReduceHashPhase, ProbingAddMyStructByIndexWithHoles) {
         });
 }
 
+TEST(ReduceHashPhase, TaggedProbingAddMyStructByIndexWithHoles) {
+    api::RunLocalSameThread(
+        [](Context& ctx) {
+            TestAddMyStructByIndexWithHoles<core::ReduceTableImpl::TAGGED_PROBING>(ctx);
+        });
+}
+
 /******************************************************************************/
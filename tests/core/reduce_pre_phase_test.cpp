@@ -126,6 +126,13 @@ TEST(ReducePrePhase, ProbingAddMyStructByHash) {
         });
 }
 
+TEST(ReducePrePhase, TaggedProbingAddMyStructByHash) {
+    api::RunLocalSameThread(
+        [](Context& ctx) {
+            TestAddMyStructByHash<core::ReduceTableImpl::TAGGED_PROBING>(ctx);
+        });
+}
+
 /******************************************************************************/
 
 template <core::ReduceTableImpl table_impl>
@@ -216,4 +223,11 @@ TEST(ReducePrePhase, ProbingAddMyStructByIndex) {
         });
 }
 
+TEST(ReducePrePhase, TaggedProbingAddMyStructByIndex) {
+    api::RunLocalSameThread(
+        [](Context& ctx) {
+            TestAddMyStructByIndex<core::ReduceTableImpl::TAGGED_PROBING>(ctx);
+        });
+}
+
 /******************************************************************************/
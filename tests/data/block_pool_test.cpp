@@ -12,7 +12,10 @@
 #include <thrill/data/block.hpp>
 #include <thrill/data/block_pool.hpp>
 
+#include <random>
 #include <string>
+#include <thread>
+#include <vector>
 
 using namespace thrill;
 
@@ -109,4 +112,152 @@ TEST_F(BlockPoolTest, EvictBlock) {
     ASSERT_EQ(0u, block_pool_.writing_blocks() + block_pool_.swapped_blocks());
 }
 
+TEST(BlockPool, EvictCompressedBlocks) {
+    data::default_swap_compress = true;
+    data::BlockPool block_pool;
+    data::default_swap_compress = false;
+
+    static constexpr size_t size = 16384;
+
+    // one compressible block of text, and one of random bytes
+    std::vector<data::Block> blocks;
+    std::default_random_engine rng(1234);
+    for (size_t b = 0; b < 2; ++b) {
+        data::PinnedByteBlockPtr bytes = block_pool.AllocateByteBlock(size, 0);
+        for (size_t i = 0; i < size; ++i) {
+            bytes->data()[i] = static_cast<data::Byte>(
+                b == 0 ? "compressible "[i % 13] : rng());
+        }
+        blocks.emplace_back(
+            data::PinnedBlock(std::move(bytes), 0, size, 0, 0, false)
+            .ToBlock());
+    }
+
+    for (data::Block& block : blocks)
+        block_pool.EvictBlock(block.byte_block().get());
+
+    // the text block is written in one aligned extent, the random one raw.
+    ASSERT_EQ(2 * size, block_pool.swap_raw_bytes());
+    ASSERT_EQ(size + 4096, block_pool.swap_disk_bytes());
+
+    // swap blocks back in and check their contents
+    std::default_random_engine rng2(1234);
+    for (size_t b = 0; b < 2; ++b) {
+        data::PinnedBlock pinned = blocks[b].PinWait(0);
+        for (size_t i = 0; i < size; ++i) {
+            ASSERT_EQ(static_cast<data::Byte>(
+                          b == 0 ? "compressible "[i % 13] : rng2()),
+                      pinned.data_begin()[i]);
+        }
+    }
+}
+
+TEST(BlockPool, EvictAdvisedBlocksFirst) {
+    data::BlockPool block_pool;
+
+    std::vector<data::Block> blocks;
+    for (size_t b = 0; b < 3; ++b) {
+        data::PinnedByteBlockPtr bytes = block_pool.AllocateByteBlock(4096, 0);
+        blocks.emplace_back(
+            data::PinnedBlock(std::move(bytes), 0, 4096, 0, 0, false)
+            .ToBlock());
+    }
+
+    // read the middle block sequentially, the least recently used is first.
+    {
+        data::PinnedBlock pinned = blocks[1].PinWait(0);
+        pinned.byte_block()->AdviseEvictFirst();
+    }
+    ASSERT_EQ(3u, block_pool.unpinned_blocks());
+
+    block_pool.EvictBlockLRU()->wait();
+    ASSERT_TRUE(blocks[0].byte_block()->in_memory());
+    ASSERT_FALSE(blocks[1].byte_block()->in_memory());
+    ASSERT_TRUE(blocks[2].byte_block()->in_memory());
+
+    // the advice applies only once, then LRU order holds again.
+    {
+        data::PinnedBlock pinned = blocks[1].PinWait(0);
+    }
+    block_pool.EvictBlockLRU()->wait();
+    ASSERT_FALSE(blocks[0].byte_block()->in_memory());
+    ASSERT_TRUE(blocks[1].byte_block()->in_memory());
+}
+
+TEST(BlockPool, PrefetchDepth) {
+    static constexpr size_t size = 4096;
+    static const auto consume_time = std::chrono::nanoseconds(1);
+
+    data::BlockPool block_pool;
+
+    // without read latency measurement, the read-ahead grows by one.
+    ASSERT_EQ(0, block_pool.read_latency().count());
+    ASSERT_EQ(3u, block_pool.PrefetchDepth(2, size, consume_time));
+
+    // swap a block out and in again to measure the read latency
+    data::Block block;
+    {
+        data::PinnedByteBlockPtr bytes = block_pool.AllocateByteBlock(size, 0);
+        block = data::PinnedBlock(std::move(bytes), 0, size, 0, 0, false)
+                .ToBlock();
+    }
+    block_pool.EvictBlockLRU()->wait();
+    block.PinWait(0);
+    ASSERT_LT(0, block_pool.read_latency().count());
+
+    // reading faster than the disk grows the read-ahead up to a maximum
+    size_t depth = block_pool.PrefetchDepth(2, size, consume_time);
+    ASSERT_GT(depth, 3u);
+    ASSERT_EQ(depth, block_pool.PrefetchDepth(depth, size, consume_time));
+
+    // limited by memory: 128 KiB / 16 allows two Blocks per reader
+    data::BlockPool limited(64 * 1024, 128 * 1024, nullptr, nullptr, 1);
+    ASSERT_EQ(2u, limited.PrefetchDepth(2, size, consume_time));
+    ASSERT_EQ(2u, limited.PrefetchDepth(1, size, consume_time));
+}
+
+TEST(BlockPool, ConcurrentPinsOfWorkers) {
+    static constexpr size_t workers = 4;
+    data::BlockPool block_pool(workers);
+
+    // blocks shared by all workers
+    std::vector<data::Block> blocks;
+    for (size_t b = 0; b < 64; ++b) {
+        data::PinnedByteBlockPtr bytes = block_pool.AllocateByteBlock(16, 0);
+        bytes->data()[0] = static_cast<data::Byte>(b);
+        blocks.emplace_back(
+            data::PinnedBlock(std::move(bytes), 0, 16, 0, 0, false).ToBlock());
+    }
+    ASSERT_EQ(0u, block_pool.pinned_blocks());
+    ASSERT_EQ(blocks.size(), block_pool.unpinned_blocks());
+
+    std::vector<std::thread> threads;
+    for (size_t w = 0; w < workers; ++w) {
+        threads.emplace_back(
+            [&, w]() {
+                std::default_random_engine rng(w);
+                for (size_t i = 0; i < 10000; ++i) {
+                    size_t b = rng() % blocks.size();
+                    data::PinnedBlock pinned = blocks[b].PinWait(w);
+                    // a copy takes a second pin of the same worker
+                    data::PinnedBlock copy = pinned;
+                    ASSERT_EQ(static_cast<data::Byte>(b), copy.data_begin()[0]);
+                    ASSERT_EQ(2u, pinned.pin_count(w));
+                }
+            });
+    }
+    for (std::thread& t : threads) t.join();
+
+    ASSERT_EQ(0u, block_pool.pinned_blocks());
+    ASSERT_EQ(blocks.size(), block_pool.unpinned_blocks());
+
+    // deferred unpins of destroyed blocks are applied
+    {
+        data::PinnedBlock pinned = blocks.back().PinWait(1);
+        blocks.pop_back();
+    }
+    blocks.clear();
+    ASSERT_EQ(0u, block_pool.total_blocks());
+}
+
 /******************************************************************************/
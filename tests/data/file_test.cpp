@@ -134,6 +134,26 @@ TEST_F(File, WriteZeroItems) {
     }
 }
 
+TEST_F(File, WriterGrowsBlockSize) {
+
+    data::File file(block_pool_, 0, /* dia_id */ 0);
+
+    const size_t max_block_size = 4 * data::start_block_size;
+    {
+        data::File::Writer fw = file.GetWriter(max_block_size);
+        for (size_t i = 0; i != 3 * max_block_size; ++i)
+            fw.PutRaw<uint8_t>(42);
+    }
+
+    // blocks start small, double, and stay at the maximum size.
+    ASSERT_EQ(5u, file.num_blocks());
+    ASSERT_EQ(1 * data::start_block_size, file.block(0).size());
+    ASSERT_EQ(2 * data::start_block_size, file.block(1).size());
+    ASSERT_EQ(4 * data::start_block_size, file.block(2).size());
+    ASSERT_EQ(4 * data::start_block_size, file.block(3).size());
+    ASSERT_EQ(1 * data::start_block_size, file.block(4).size());
+}
+
 TEST_F(File, SerializeSomeItems) {
 
     // construct File with very small blocks for testing
@@ -247,6 +267,56 @@ TEST_F(File, SerializeSomeItemsConsumeReader) {
     ASSERT_EQ(0u, file.num_items());
 }
 
+TEST_F(File, ReadBatchesOfItems) {
+    static constexpr size_t size = 5000;
+
+    // construct File with very small blocks, such that items straddle them.
+    data::File file(block_pool_, 0, /* dia_id */ 0);
+    {
+        data::File::Writer fw = file.GetWriter(53);
+        for (unsigned i = 0; i < size; ++i) {
+            fw.Put<unsigned>(i);
+        }
+    }
+
+    // read PODs in batches, which are copied directly from Blocks.
+    {
+        data::File::KeepReader fr = file.GetKeepReader();
+        std::vector<unsigned> batch;
+        size_t i = 0;
+        while (fr.NextBatch(batch, 100) != 0) {
+            ASSERT_LE(batch.size(), 100u);
+            for (const unsigned& x : batch) {
+                ASSERT_EQ(i, x);
+                ++i;
+            }
+        }
+        ASSERT_EQ(size, i);
+        ASSERT_FALSE(fr.HasNext());
+    }
+
+    // read non-PODs in batches, which are deserialized one by one.
+    data::File sfile(block_pool_, 0, /* dia_id */ 0);
+    {
+        data::File::Writer fw = sfile.GetWriter(53);
+        for (size_t i = 0; i < size; ++i) {
+            fw.Put(std::to_string(i));
+        }
+    }
+    {
+        data::File::Reader fr = sfile.GetReader(/* consume */ true);
+        std::vector<std::string> batch;
+        size_t i = 0;
+        while (fr.NextBatch(batch, 128) != 0) {
+            for (const std::string& x : batch) {
+                ASSERT_EQ(std::to_string(i), x);
+                ++i;
+            }
+        }
+        ASSERT_EQ(size, i);
+    }
+}
+
 TEST_F(File, RandomGetIndexOf) {
     static constexpr size_t size = 500;
 
@@ -163,7 +163,7 @@ struct Multiplexer : public ::testing::Test {
 
 // open a Stream via data::Multiplexer, and send a short message to all workers,
 // receive and check the message.
-void TalkAllToAllViaCatStream(net::Group* net) {
+void TalkAllToAllViaCatStream(net::Group* net, bool compress = false) {
     common::NameThisThread("chmp" + mem::to_string(net->my_host_rank()));
 
     unsigned char send_buffer[123];
@@ -174,7 +174,8 @@ void TalkAllToAllViaCatStream(net::Group* net) {
     size_t my_local_worker_id = 0;
     size_t num_workers_per_host = 1;
 
-    data::default_block_size = test_block_size;
+    // compression skips small Blocks
+    data::default_block_size = compress ? 16 * test_block_size : test_block_size;
 
     mem::Manager mem_manager(nullptr, "Benchmark");
     mem::Manager ext_mem_manager(nullptr, "BenchmarkExt");
@@ -187,8 +188,10 @@ void TalkAllToAllViaCatStream(net::Group* net) {
 
         // open Writers and send a message to all workers
 
-        auto writers = multiplexer.GetOrCreateCatStream(
-            id, my_local_worker_id, /* dia_id */ 0)->GetWriters();
+        auto stream = multiplexer.GetOrCreateCatStream(
+            id, my_local_worker_id, /* dia_id */ 0);
+        stream->set_compress(compress);
+        auto writers = stream->GetWriters();
 
         for (size_t tgt = 0; tgt != writers.size(); ++tgt) {
             writers[tgt].Put("hello I am " + std::to_string(net->my_host_rank())
@@ -229,15 +232,29 @@ void TalkAllToAllViaCatStream(net::Group* net) {
                                        recv_buffer));
             }
         }
+
+        // the repetitive data must have been sent compressed
+        size_t raw_bytes =
+            (net->num_hosts() - 1) * iterations * sizeof(send_buffer);
+        if (compress)
+            ASSERT_LT(stream->tx_net_bytes_.load(), raw_bytes / 4);
+        else
+            ASSERT_GE(stream->tx_net_bytes_.load(), raw_bytes);
     }
 }
 
 TEST_F(Multiplexer, TalkAllToAllViaCatStreamForManyNetSizes) {
     // test for all network mesh sizes 1, 2, 5, 9:
-    net::RunLoopbackGroupTest(1, TalkAllToAllViaCatStream);
-    net::RunLoopbackGroupTest(2, TalkAllToAllViaCatStream);
-    net::RunLoopbackGroupTest(5, TalkAllToAllViaCatStream);
-    net::RunLoopbackGroupTest(9, TalkAllToAllViaCatStream);
+    net::RunLoopbackGroupTest(1, [](net::Group* g) { TalkAllToAllViaCatStream(g); });
+    net::RunLoopbackGroupTest(2, [](net::Group* g) { TalkAllToAllViaCatStream(g); });
+    net::RunLoopbackGroupTest(5, [](net::Group* g) { TalkAllToAllViaCatStream(g); });
+    net::RunLoopbackGroupTest(9, [](net::Group* g) { TalkAllToAllViaCatStream(g); });
+}
+
+TEST_F(Multiplexer, TalkAllToAllViaCompressedCatStream) {
+    auto compressed = [](net::Group* g) { TalkAllToAllViaCatStream(g, true); };
+    net::RunLoopbackGroupTest(2, compressed);
+    net::RunLoopbackGroupTest(5, compressed);
 }
 
 TEST_F(Multiplexer, ReadCompleteCatStream) {
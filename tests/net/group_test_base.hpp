@@ -237,6 +237,57 @@ static void TestDispatcherSyncSendAsyncRead(net::Group* net) {
     }
 }
 
+//! sends many asynchronous writes to all workers, which are gathered into
+//! fewer sends by the Dispatcher, and checks their contents and order.
+static void TestDispatcherAsyncWriteGather(net::Group* net) {
+    static constexpr size_t num_pieces = 32;
+
+    auto piece_size = [](size_t k) { return k * 512 + 13; };
+    auto pattern = [](size_t k, size_t j, size_t host) {
+        return static_cast<uint8_t>(k * 7 + j * 3 + host);
+    };
+
+    mem::Manager mem_manager(nullptr, "Dispatcher");
+    std::unique_ptr<net::Dispatcher>
+    dispatcher = net->ConstructDispatcher(mem_manager);
+
+    std::vector<size_t> written(net->num_hosts());
+    size_t total_written = 0, received = 0;
+    for (size_t i = 0; i < net->num_hosts(); ++i)
+    {
+        if (i == net->my_host_rank()) continue;
+
+        for (size_t k = 0; k < num_pieces; ++k) {
+            net::Buffer buffer(piece_size(k));
+            for (size_t j = 0; j < buffer.size(); ++j)
+                buffer[j] = pattern(k, j, net->my_host_rank());
+            dispatcher->AsyncWrite(
+                net->connection(i), std::move(buffer),
+                [&written, &total_written, i, k](net::Connection&) {
+                    // callbacks are delivered in order of the pieces
+                    ASSERT_EQ(k, written[i]);
+                    written[i]++, total_written++;
+                });
+        }
+
+        for (size_t k = 0; k < num_pieces; ++k) {
+            dispatcher->AsyncRead(
+                net->connection(i), piece_size(k),
+                [&received, &pattern, i, k](
+                    net::Connection&, net::Buffer&& buffer) {
+                    for (size_t j = 0; j < buffer.size(); ++j)
+                        ASSERT_EQ(pattern(k, j, i), buffer[j]);
+                    received++;
+                });
+        }
+    }
+
+    while (received < num_pieces * (net->num_hosts() - 1) ||
+           total_written < num_pieces * (net->num_hosts() - 1)) {
+        dispatcher->Dispatch();
+    }
+}
+
 /******************************************************************************/
 // DispatcherThread tests
 
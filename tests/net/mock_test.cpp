@@ -94,6 +94,9 @@ TEST(MockGroup, AllReduceHypercubeString) {
 TEST(MockGroup, DispatcherSyncSendAsyncRead) {
     MockTest(TestDispatcherSyncSendAsyncRead);
 }
+TEST(MockGroup, DispatcherAsyncWriteGather) {
+    MockTest(TestDispatcherAsyncWriteGather);
+}
 TEST(MockGroup, DispatcherLaunchAndTerminate) {
     MockTest(TestDispatcherLaunchAndTerminate);
 }
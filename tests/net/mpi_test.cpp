@@ -96,6 +96,9 @@ TEST(MpiGroup, AllReduceHypercubeString) {
 TEST(MpiGroup, DispatcherSyncSendAsyncRead) {
     MpiTest(TestDispatcherSyncSendAsyncRead);
 }
+TEST(MpiGroup, DispatcherAsyncWriteGather) {
+    MpiTest(TestDispatcherAsyncWriteGather);
+}
 TEST(MpiGroup, DispatcherLaunchAndTerminate) {
     MpiTest(TestDispatcherLaunchAndTerminate);
 }
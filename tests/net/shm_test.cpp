@@ -0,0 +1,178 @@
+/*******************************************************************************
+ * tests/net/shm_test.cpp
+ *
+ * Part of Project Thrill - http://project-thrill.org
+ *
+ * Copyright (C) 2016 Timo Bingmann <tb@panthema.net>
+ *
+ * All rights reserved. Published under the BSD-2 license in the LICENSE file.
+ ******************************************************************************/
+
+#include <gtest/gtest.h>
+#include <thrill/common/logger.hpp>
+#include <thrill/net/dispatcher_thread.hpp>
+#include <thrill/net/shm/group.hpp>
+
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include <string>
+#include <thread>
+
+#include "flow_control_test_base.hpp"
+#include "group_test_base.hpp"
+
+using namespace thrill;      // NOLINT
+
+void ShmTestOne(size_t num_hosts,
+                const std::function<void(net::shm::Group*)>& thread_function) {
+    sLOG0 << "ShmTestOne num_hosts" << num_hosts;
+    // construct shared memory network mesh and run threads
+    net::ExecuteGroupThreads(
+        net::shm::Group::ConstructLoopbackMesh(num_hosts),
+        thread_function);
+}
+
+void ShmTest(const std::function<void(net::Group*)>& thread_function) {
+    ShmTestOne(1, thread_function);
+    ShmTestOne(2, thread_function);
+    ShmTestOne(3, thread_function);
+    ShmTestOne(4, thread_function);
+    ShmTestOne(5, thread_function);
+    ShmTestOne(6, thread_function);
+    ShmTestOne(7, thread_function);
+    ShmTestOne(8, thread_function);
+    ShmTestOne(16, thread_function);
+    ShmTestOne(20, thread_function);
+}
+
+void ShmTestLess(const std::function<void(net::Group*)>& thread_function) {
+    ShmTestOne(1, thread_function);
+    ShmTestOne(2, thread_function);
+    ShmTestOne(3, thread_function);
+    ShmTestOne(5, thread_function);
+    ShmTestOne(8, thread_function);
+}
+
+/*[[[perl
+  require("tests/net/test_gen.pm");
+  generate_group_tests("ShmGroup", "ShmTest");
+  generate_flow_control_tests("ShmGroup", "ShmTestLess");
+  ]]]*/
+TEST(ShmGroup, NoOperation) {
+    ShmTest(TestNoOperation);
+}
+TEST(ShmGroup, SendRecvCyclic) {
+    ShmTest(TestSendRecvCyclic);
+}
+TEST(ShmGroup, BroadcastIntegral) {
+    ShmTest(TestBroadcastIntegral);
+}
+TEST(ShmGroup, SendReceiveAll2All) {
+    ShmTest(TestSendReceiveAll2All);
+}
+TEST(ShmGroup, PrefixSumHypercube) {
+    ShmTest(TestPrefixSumHypercube);
+}
+TEST(ShmGroup, PrefixSumHypercubeString) {
+    ShmTest(TestPrefixSumHypercubeString);
+}
+TEST(ShmGroup, PrefixSum) {
+    ShmTest(TestPrefixSum);
+}
+TEST(ShmGroup, Broadcast) {
+    ShmTest(TestBroadcast);
+}
+TEST(ShmGroup, Reduce) {
+    ShmTest(TestReduce);
+}
+TEST(ShmGroup, ReduceString) {
+    ShmTest(TestReduceString);
+}
+TEST(ShmGroup, AllReduceString) {
+    ShmTest(TestAllReduceString);
+}
+TEST(ShmGroup, AllReduceHypercubeString) {
+    ShmTest(TestAllReduceHypercubeString);
+}
+TEST(ShmGroup, DispatcherSyncSendAsyncRead) {
+    ShmTest(TestDispatcherSyncSendAsyncRead);
+}
+TEST(ShmGroup, DispatcherAsyncWriteGather) {
+    ShmTest(TestDispatcherAsyncWriteGather);
+}
+TEST(ShmGroup, DispatcherLaunchAndTerminate) {
+    ShmTest(TestDispatcherLaunchAndTerminate);
+}
+TEST(ShmGroup, SingleThreadPrefixSum) {
+    ShmTestLess(TestSingleThreadPrefixSum);
+}
+TEST(ShmGroup, SingleThreadVectorPrefixSum) {
+    ShmTestLess(TestSingleThreadVectorPrefixSum);
+}
+TEST(ShmGroup, SingleThreadBroadcast) {
+    ShmTestLess(TestSingleThreadBroadcast);
+}
+TEST(ShmGroup, MultiThreadBroadcast) {
+    ShmTestLess(TestMultiThreadBroadcast);
+}
+TEST(ShmGroup, MultiThreadReduce) {
+    ShmTestLess(TestMultiThreadReduce);
+}
+TEST(ShmGroup, SingleThreadAllReduce) {
+    ShmTestLess(TestSingleThreadAllReduce);
+}
+TEST(ShmGroup, MultiThreadAllReduce) {
+    ShmTestLess(TestMultiThreadAllReduce);
+}
+TEST(ShmGroup, MultiThreadPrefixSum) {
+    ShmTestLess(TestMultiThreadPrefixSum);
+}
+TEST(ShmGroup, PredecessorManyItems) {
+    ShmTestLess(TestPredecessorManyItems);
+}
+TEST(ShmGroup, PredecessorFewItems) {
+    ShmTestLess(TestPredecessorFewItems);
+}
+TEST(ShmGroup, PredecessorOneItem) {
+    ShmTestLess(TestPredecessorOneItem);
+}
+TEST(ShmGroup, HardcoreRaceConditionTest) {
+    ShmTestLess(TestHardcoreRaceConditionTest);
+}
+// [[[end]]]
+
+TEST(ShmGroup, ConstructProcesses) {
+    std::string path = "/dev/shm/thrill-test-" + std::to_string(getpid());
+
+    // run host 1 in a forked child process
+    pid_t pid = fork();
+    ASSERT_GE(pid, 0);
+
+    if (pid == 0) {
+        std::unique_ptr<net::shm::Group> group =
+            net::shm::Group::Construct(1, 2, path);
+        size_t value = 5;
+        group->AllReduce(value);
+        group->Close();
+        _exit(value == 8 ? 0 : 1);
+    }
+
+    std::unique_ptr<net::shm::Group> group =
+        net::shm::Group::Construct(0, 2, path);
+    size_t value = 3;
+    group->AllReduce(value);
+    ASSERT_EQ(8u, value);
+
+    // host 0 removes the file once all hosts mapped it
+    ASSERT_NE(0, access(path.c_str(), F_OK));
+
+    int status;
+    ASSERT_EQ(pid, waitpid(pid, &status, 0));
+    ASSERT_TRUE(WIFEXITED(status));
+    ASSERT_EQ(0, WEXITSTATUS(status));
+
+    group->Close();
+}
+
+/******************************************************************************/
@@ -9,11 +9,14 @@
  ******************************************************************************/
 
 #include <gtest/gtest.h>
+#include <thrill/common/io_uring.hpp>
+#include <thrill/common/system_exception.hpp>
 #include <thrill/mem/manager.hpp>
 #include <thrill/net/dispatcher_thread.hpp>
 #include <thrill/net/tcp/group.hpp>
 #include <thrill/net/tcp/select_dispatcher.hpp>
 
+#include <cstdlib>
 #include <random>
 #include <string>
 #include <thread>
@@ -40,6 +43,37 @@ static void LocalGroupTest(
         thread_function);
 }
 
+#if THRILL_HAVE_NET_TCP_EPOLL
+static void EpollGroupTest(
+    const std::function<void(net::Group*)>& thread_function) {
+    // execute locally connected TCP stream socket tests with EpollDispatcher
+    setenv("THRILL_NET_DISPATCHER", "epoll", /* overwrite */ 1);
+    net::ExecuteGroupThreads(
+        net::tcp::Group::ConstructLocalRealTCPMesh(6),
+        thread_function);
+    unsetenv("THRILL_NET_DISPATCHER");
+}
+#endif
+
+#if THRILL_HAVE_IO_URING
+static void UringGroupTest(
+    const std::function<void(net::Group*)>& thread_function) {
+    // skip if io_uring is disabled or too old on this host.
+    try {
+        if (!common::IoUring(4).has_ext_arg()) return;
+    }
+    catch (common::ErrnoException&) {
+        return;
+    }
+    // execute locally connected TCP stream socket tests with UringDispatcher
+    setenv("THRILL_NET_DISPATCHER", "uring", /* overwrite */ 1);
+    net::ExecuteGroupThreads(
+        net::tcp::Group::ConstructLocalRealTCPMesh(6),
+        thread_function);
+    unsetenv("THRILL_NET_DISPATCHER");
+}
+#endif
+
 /*[[[perl
   require("tests/net/test_gen.pm");
   generate_group_tests("RealTcpGroup", "RealGroupTest");
@@ -86,6 +120,9 @@ TEST(RealTcpGroup, AllReduceHypercubeString) {
 TEST(RealTcpGroup, DispatcherSyncSendAsyncRead) {
     RealGroupTest(TestDispatcherSyncSendAsyncRead);
 }
+TEST(RealTcpGroup, DispatcherAsyncWriteGather) {
+    RealGroupTest(TestDispatcherAsyncWriteGather);
+}
 TEST(RealTcpGroup, DispatcherLaunchAndTerminate) {
     RealGroupTest(TestDispatcherLaunchAndTerminate);
 }
@@ -128,6 +165,9 @@ TEST(LocalTcpGroup, AllReduceHypercubeString) {
 TEST(LocalTcpGroup, DispatcherSyncSendAsyncRead) {
     LocalGroupTest(TestDispatcherSyncSendAsyncRead);
 }
+TEST(LocalTcpGroup, DispatcherAsyncWriteGather) {
+    LocalGroupTest(TestDispatcherAsyncWriteGather);
+}
 TEST(LocalTcpGroup, DispatcherLaunchAndTerminate) {
     LocalGroupTest(TestDispatcherLaunchAndTerminate);
 }
@@ -169,4 +209,184 @@ TEST(LocalTcpGroup, HardcoreRaceConditionTest) {
 }
 // [[[end]]]
 
+#if THRILL_HAVE_NET_TCP_EPOLL
+/*[[[perl
+  require("tests/net/test_gen.pm");
+  generate_group_tests("EpollTcpGroup", "EpollGroupTest");
+  generate_flow_control_tests("EpollTcpGroup", "EpollGroupTest");
+  ]]]*/
+TEST(EpollTcpGroup, NoOperation) {
+    EpollGroupTest(TestNoOperation);
+}
+TEST(EpollTcpGroup, SendRecvCyclic) {
+    EpollGroupTest(TestSendRecvCyclic);
+}
+TEST(EpollTcpGroup, BroadcastIntegral) {
+    EpollGroupTest(TestBroadcastIntegral);
+}
+TEST(EpollTcpGroup, SendReceiveAll2All) {
+    EpollGroupTest(TestSendReceiveAll2All);
+}
+TEST(EpollTcpGroup, PrefixSumHypercube) {
+    EpollGroupTest(TestPrefixSumHypercube);
+}
+TEST(EpollTcpGroup, PrefixSumHypercubeString) {
+    EpollGroupTest(TestPrefixSumHypercubeString);
+}
+TEST(EpollTcpGroup, PrefixSum) {
+    EpollGroupTest(TestPrefixSum);
+}
+TEST(EpollTcpGroup, Broadcast) {
+    EpollGroupTest(TestBroadcast);
+}
+TEST(EpollTcpGroup, Reduce) {
+    EpollGroupTest(TestReduce);
+}
+TEST(EpollTcpGroup, ReduceString) {
+    EpollGroupTest(TestReduceString);
+}
+TEST(EpollTcpGroup, AllReduceString) {
+    EpollGroupTest(TestAllReduceString);
+}
+TEST(EpollTcpGroup, AllReduceHypercubeString) {
+    EpollGroupTest(TestAllReduceHypercubeString);
+}
+TEST(EpollTcpGroup, DispatcherSyncSendAsyncRead) {
+    EpollGroupTest(TestDispatcherSyncSendAsyncRead);
+}
+TEST(EpollTcpGroup, DispatcherAsyncWriteGather) {
+    EpollGroupTest(TestDispatcherAsyncWriteGather);
+}
+TEST(EpollTcpGroup, DispatcherLaunchAndTerminate) {
+    EpollGroupTest(TestDispatcherLaunchAndTerminate);
+}
+TEST(EpollTcpGroup, SingleThreadPrefixSum) {
+    EpollGroupTest(TestSingleThreadPrefixSum);
+}
+TEST(EpollTcpGroup, SingleThreadVectorPrefixSum) {
+    EpollGroupTest(TestSingleThreadVectorPrefixSum);
+}
+TEST(EpollTcpGroup, SingleThreadBroadcast) {
+    EpollGroupTest(TestSingleThreadBroadcast);
+}
+TEST(EpollTcpGroup, MultiThreadBroadcast) {
+    EpollGroupTest(TestMultiThreadBroadcast);
+}
+TEST(EpollTcpGroup, MultiThreadReduce) {
+    EpollGroupTest(TestMultiThreadReduce);
+}
+TEST(EpollTcpGroup, SingleThreadAllReduce) {
+    EpollGroupTest(TestSingleThreadAllReduce);
+}
+TEST(EpollTcpGroup, MultiThreadAllReduce) {
+    EpollGroupTest(TestMultiThreadAllReduce);
+}
+TEST(EpollTcpGroup, MultiThreadPrefixSum) {
+    EpollGroupTest(TestMultiThreadPrefixSum);
+}
+TEST(EpollTcpGroup, PredecessorManyItems) {
+    EpollGroupTest(TestPredecessorManyItems);
+}
+TEST(EpollTcpGroup, PredecessorFewItems) {
+    EpollGroupTest(TestPredecessorFewItems);
+}
+TEST(EpollTcpGroup, PredecessorOneItem) {
+    EpollGroupTest(TestPredecessorOneItem);
+}
+TEST(EpollTcpGroup, HardcoreRaceConditionTest) {
+    EpollGroupTest(TestHardcoreRaceConditionTest);
+}
+// [[[end]]]
+#endif
+
+#if THRILL_HAVE_IO_URING
+/*[[[perl
+  require("tests/net/test_gen.pm");
+  generate_group_tests("UringTcpGroup", "UringGroupTest");
+  generate_flow_control_tests("UringTcpGroup", "UringGroupTest");
+  ]]]*/
+TEST(UringTcpGroup, NoOperation) {
+    UringGroupTest(TestNoOperation);
+}
+TEST(UringTcpGroup, SendRecvCyclic) {
+    UringGroupTest(TestSendRecvCyclic);
+}
+TEST(UringTcpGroup, BroadcastIntegral) {
+    UringGroupTest(TestBroadcastIntegral);
+}
+TEST(UringTcpGroup, SendReceiveAll2All) {
+    UringGroupTest(TestSendReceiveAll2All);
+}
+TEST(UringTcpGroup, PrefixSumHypercube) {
+    UringGroupTest(TestPrefixSumHypercube);
+}
+TEST(UringTcpGroup, PrefixSumHypercubeString) {
+    UringGroupTest(TestPrefixSumHypercubeString);
+}
+TEST(UringTcpGroup, PrefixSum) {
+    UringGroupTest(TestPrefixSum);
+}
+TEST(UringTcpGroup, Broadcast) {
+    UringGroupTest(TestBroadcast);
+}
+TEST(UringTcpGroup, Reduce) {
+    UringGroupTest(TestReduce);
+}
+TEST(UringTcpGroup, ReduceString) {
+    UringGroupTest(TestReduceString);
+}
+TEST(UringTcpGroup, AllReduceString) {
+    UringGroupTest(TestAllReduceString);
+}
+TEST(UringTcpGroup, AllReduceHypercubeString) {
+    UringGroupTest(TestAllReduceHypercubeString);
+}
+TEST(UringTcpGroup, DispatcherSyncSendAsyncRead) {
+    UringGroupTest(TestDispatcherSyncSendAsyncRead);
+}
+TEST(UringTcpGroup, DispatcherAsyncWriteGather) {
+    UringGroupTest(TestDispatcherAsyncWriteGather);
+}
+TEST(UringTcpGroup, DispatcherLaunchAndTerminate) {
+    UringGroupTest(TestDispatcherLaunchAndTerminate);
+}
+TEST(UringTcpGroup, SingleThreadPrefixSum) {
+    UringGroupTest(TestSingleThreadPrefixSum);
+}
+TEST(UringTcpGroup, SingleThreadVectorPrefixSum) {
+    UringGroupTest(TestSingleThreadVectorPrefixSum);
+}
+TEST(UringTcpGroup, SingleThreadBroadcast) {
+    UringGroupTest(TestSingleThreadBroadcast);
+}
+TEST(UringTcpGroup, MultiThreadBroadcast) {
+    UringGroupTest(TestMultiThreadBroadcast);
+}
+TEST(UringTcpGroup, MultiThreadReduce) {
+    UringGroupTest(TestMultiThreadReduce);
+}
+TEST(UringTcpGroup, SingleThreadAllReduce) {
+    UringGroupTest(TestSingleThreadAllReduce);
+}
+TEST(UringTcpGroup, MultiThreadAllReduce) {
+    UringGroupTest(TestMultiThreadAllReduce);
+}
+TEST(UringTcpGroup, MultiThreadPrefixSum) {
+    UringGroupTest(TestMultiThreadPrefixSum);
+}
+TEST(UringTcpGroup, PredecessorManyItems) {
+    UringGroupTest(TestPredecessorManyItems);
+}
+TEST(UringTcpGroup, PredecessorFewItems) {
+    UringGroupTest(TestPredecessorFewItems);
+}
+TEST(UringTcpGroup, PredecessorOneItem) {
+    UringGroupTest(TestPredecessorOneItem);
+}
+TEST(UringTcpGroup, HardcoreRaceConditionTest) {
+    UringGroupTest(TestHardcoreRaceConditionTest);
+}
+// [[[end]]]
+#endif
+
 /******************************************************************************/
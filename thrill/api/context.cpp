@@ -20,6 +20,7 @@
 #include <thrill/common/profile_thread.hpp>
 #include <thrill/common/string.hpp>
 #include <thrill/common/system_exception.hpp>
+#include <thrill/core/file_io.hpp>
 #include <thrill/io/iostats.hpp>
 
 // mock net backend is always available -tb :)
@@ -29,6 +30,10 @@
 #include <thrill/net/tcp/construct.hpp>
 #endif
 
+#if THRILL_HAVE_NET_SHM
+#include <thrill/net/shm/group.hpp>
+#endif
+
 #if THRILL_HAVE_NET_MPI
 #include <thrill/net/mpi/group.hpp>
 #endif
@@ -170,7 +175,8 @@ static inline bool SetupBlockSize() {
         return false;
     }
 
-    data::start_block_size = data::default_block_size;
+    data::start_block_size =
+        std::min(data::start_block_size, data::default_block_size);
 
     std::cerr << "Thrill: setting default_block_size = "
               << data::default_block_size
@@ -179,6 +185,36 @@ static inline bool SetupBlockSize() {
     return true;
 }
 
+//! parse an environment variable which is either 0 or 1 into flag, if it is
+//! set.
+static inline bool SetupFlag(const char* name, bool& flag) {
+
+    const char* env_flag = getenv(name);
+    if (!env_flag || !*env_flag) return true;
+
+    if (strcmp(env_flag, "0") == 0) {
+        flag = false;
+    }
+    else if (strcmp(env_flag, "1") == 0) {
+        flag = true;
+    }
+    else {
+        std::cerr << "Thrill: environment variable"
+                  << " " << name << "=" << env_flag
+                  << " is not either 0 or 1."
+                  << std::endl;
+        return false;
+    }
+
+    return true;
+}
+
+static inline bool SetupFlags() {
+    return SetupFlag("THRILL_NET_COMPRESS", data::default_stream_compress) &&
+           SetupFlag("THRILL_SWAP_COMPRESS", data::default_swap_compress) &&
+           SetupFlag("THRILL_READ_MMAP", core::default_read_mmap);
+}
+
 /******************************************************************************/
 // Constructions using TestGroup (either mock or tcp-loopback) for local testing
 
@@ -295,9 +331,11 @@ int RunBackendLoopback(
 
     char* endptr;
 
+    size_t num_cores = std::max(std::thread::hardware_concurrency(), 1u);
+
     // determine number of loopback hosts
 
-    size_t num_hosts = std::thread::hardware_concurrency();
+    size_t num_hosts = 1;
 
     const char* env_local = getenv("THRILL_LOCAL");
     if (env_local && *env_local) {
@@ -327,14 +365,17 @@ int RunBackendLoopback(
                       << std::endl;
             return -1;
         }
-    }
-    else {
-        if (!env_local && !env_workers_per_host) {
-            // distribute two threads per worker.
-            workers_per_host = 2;
-            num_hosts /= 2;
+        if (!env_local || !*env_local) {
+            // fill the cores with hosts of the given size.
+            num_hosts = std::max(num_cores / workers_per_host, size_t(1));
         }
     }
+    else if (!env_local || !*env_local) {
+        // run one host with a worker per core: Streams between workers of a
+        // host pass Blocks by reference through loopback queues, which avoids
+        // serializing them over the local network.
+        workers_per_host = num_cores;
+    }
 
     // detect memory config
 
@@ -348,6 +389,8 @@ int RunBackendLoopback(
               << " test hosts and " << workers_per_host << " workers per host"
               << " in a local " << backend << " network." << std::endl;
 
+    if (!SetupFlags()) return -1;
+
     RunLoopbackThreads<NetGroup>(
         mem_config, num_hosts, workers_per_host, job_startpoint);
 
@@ -458,6 +501,7 @@ int RunBackendTcp(const std::function<void(Context&)>& job_startpoint) {
     std::cerr << std::endl;
 
     if (!SetupBlockSize()) return -1;
+    if (!SetupFlags()) return -1;
 
     static constexpr size_t kGroupCount = net::Manager::kGroupCount;
 
@@ -498,6 +542,122 @@ int RunBackendTcp(const std::function<void(Context&)>& job_startpoint) {
 }
 #endif
 
+#if THRILL_HAVE_NET_SHM
+static inline
+int RunBackendShm(const std::function<void(Context&)>& job_startpoint) {
+
+    char* endptr;
+
+    // parse environment
+    const char* env_rank = getenv("THRILL_RANK");
+    const char* env_shm_hosts = getenv("THRILL_SHM_HOSTS");
+    const char* env_shm_name = getenv("THRILL_SHM_NAME");
+    const char* env_workers_per_host = getenv("THRILL_WORKERS_PER_HOST");
+
+    if (!env_rank || !*env_rank) {
+        // no processes to connect: run hosts as threads in this process.
+        return RunBackendLoopback<net::shm::Group>("shm", job_startpoint);
+    }
+
+    size_t my_host_rank = std::strtoul(env_rank, &endptr, 10);
+    if (!endptr || *endptr != 0) {
+        std::cerr << "Thrill: environment variable THRILL_RANK=" << env_rank
+                  << " is not a valid number."
+                  << std::endl;
+        return -1;
+    }
+
+    size_t num_hosts = 0;
+    if (env_shm_hosts && *env_shm_hosts)
+        num_hosts = std::strtoul(env_shm_hosts, &endptr, 10);
+
+    if (num_hosts == 0 || !endptr || *endptr != 0 ||
+        my_host_rank >= num_hosts) {
+        std::cerr << "Thrill: environment variable THRILL_SHM_HOSTS"
+                  << " is required for the shm network backend and must be"
+                  << " larger than THRILL_RANK."
+                  << std::endl;
+        return -1;
+    }
+
+    // processes started by the same launcher meet in the same files.
+    std::string shm_name =
+        env_shm_name && *env_shm_name
+        ? std::string(env_shm_name) : std::to_string(getppid());
+
+    size_t workers_per_host = 1;
+
+    if (env_workers_per_host && *env_workers_per_host) {
+        workers_per_host = std::strtoul(env_workers_per_host, &endptr, 10);
+        if (!endptr || *endptr != 0 || workers_per_host == 0) {
+            std::cerr << "Thrill: environment variable"
+                      << " THRILL_WORKERS_PER_HOST=" << env_workers_per_host
+                      << " is not a valid number of workers per host."
+                      << std::endl;
+            return -1;
+        }
+    }
+    else {
+        // the processes share the cores of this machine.
+        workers_per_host = std::max(
+            std::thread::hardware_concurrency() / num_hosts, size_t(1));
+    }
+
+    // detect memory config
+
+    MemoryConfig mem_config;
+    if (mem_config.setup_detect() < 0) return -1;
+    // the processes share the RAM of this machine.
+    mem_config = mem_config.divide(num_hosts);
+    mem_config.print(workers_per_host);
+
+    // okay, configuration is good.
+
+    std::cerr << "Thrill: running in shm network with " << num_hosts
+              << " processes and " << workers_per_host << " workers per host"
+              << " as rank " << my_host_rank
+              << " in /dev/shm/thrill-" << shm_name << std::endl;
+
+    if (!SetupBlockSize()) return -1;
+    if (!SetupFlags()) return -1;
+
+    static constexpr size_t kGroupCount = net::Manager::kGroupCount;
+
+    // construct network groups, each in its own shared memory file
+    std::array<net::GroupPtr, kGroupCount> host_groups;
+    for (size_t g = 0; g < kGroupCount; ++g) {
+        host_groups[g] = net::shm::Group::Construct(
+            my_host_rank, num_hosts,
+            "/dev/shm/thrill-" + shm_name + "-" + std::to_string(g));
+    }
+
+    // construct HostContext
+    HostContext host_context(
+        0, mem_config, std::move(host_groups), workers_per_host);
+
+    std::vector<std::thread> threads(workers_per_host);
+
+    for (size_t worker = 0; worker < workers_per_host; worker++) {
+        threads[worker] = common::CreateThread(
+            [&host_context, &job_startpoint, worker] {
+                Context ctx(host_context, worker);
+                common::NameThisThread("worker " + mem::to_string(worker));
+
+                ctx.Launch(job_startpoint);
+            });
+        common::SetCpuAffinity(
+            threads[worker], my_host_rank * workers_per_host + worker);
+    }
+
+    // join worker threads
+    for (size_t i = 0; i < workers_per_host; i++) {
+        threads[i].join();
+    }
+
+    return 0;
+}
+#endif
+
 #if THRILL_HAVE_NET_MPI
 static inline
 int RunBackendMpi(const std::function<void(Context&)>& job_startpoint) {
@@ -542,6 +702,7 @@ int RunBackendMpi(const std::function<void(Context&)>& job_startpoint) {
               << std::endl;
 
     if (!SetupBlockSize()) return -1;
+    if (!SetupFlags()) return -1;
 
     static constexpr size_t kGroupCount = net::Manager::kGroupCount;
 
@@ -627,6 +788,7 @@ int RunBackendIb(const std::function<void(Context&)>& job_startpoint) {
               << std::endl;
 
     if (!SetupBlockSize()) return -1;
+    if (!SetupFlags()) return -1;
 
     static constexpr size_t kGroupCount = net::Manager::kGroupCount;
 
@@ -787,6 +949,15 @@ int Run(const std::function<void(Context&)>& job_startpoint) {
 #endif
     }
 
+    if (strcmp(env_net, "shm") == 0) {
+#if THRILL_HAVE_NET_SHM
+        // shared memory network backend between processes on this machine
+        return RunBackendShm(job_startpoint);
+#else
+        return RunNotSupported(env_net);
+#endif
+    }
+
     if (strcmp(env_net, "mpi") == 0) {
 #if THRILL_HAVE_NET_MPI
         // mpi network backend
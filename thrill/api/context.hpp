@@ -507,6 +507,13 @@ int RunCheckUnlinkBinary();
  *
  * THRILL_NET is the network backend to use, e.g.: mock, local, tcp, or mpi.
  *
+ * THRILL_NET_DISPATCHER selects the socket dispatcher of the local and tcp
+ * backends: select (default), epoll, or uring.
+ *
+ * THRILL_NET_COMPRESS=1 compresses Blocks sent between hosts by Streams.
+ *
+ * THRILL_SWAP_COMPRESS=1 compresses Blocks evicted to disk by the BlockPool.
+ *
  * THRILL_RANK contains the rank of this worker
  *
  * THRILL_HOSTLIST contains a space- or comma-separated list of host:ports to
@@ -923,13 +923,19 @@ public:
      * buckets are grouped and processed.
      *      input param: api::GroupByReader with functions HasNext() and Next()
      *
+     * \param groupby_config Group configuration, e.g. HashGroupByConfig to
+     * group items by hashing instead of sorting, which does not require an
+     * ordering on the keys and delivers groups in arbitrary order.
+     *
      * \ingroup dia_dops
      */
     template <typename ValueOut, typename KeyExtractor,
               typename GroupByFunction, typename HashFunction =
-                  std::hash<typename FunctionTraits<KeyExtractor>::result_type> >
+                  std::hash<typename FunctionTraits<KeyExtractor>::result_type>,
+              typename GroupByConfig = class DefaultGroupByConfig>
     auto GroupByKey(const KeyExtractor &key_extractor,
-                    const GroupByFunction &groupby_function) const;
+                    const GroupByFunction &groupby_function,
+                    const GroupByConfig &groupby_config = GroupByConfig()) const;
 
     /*!
      * GroupBy is a DOp, which groups elements of the DIA by its key.
@@ -1113,11 +1119,33 @@ public:
      * \param sort_algorithm Algorithm class used to sort items. Merging is
      * always done using a tournament tree with compare_function.
      *
+     * \param sort_config Sort configuration.
+     *
      * \ingroup dia_dops
      */
-    template <typename CompareFunction, typename SortFunction>
+    template <typename CompareFunction, typename SortFunction,
+              typename SortConfig = class DefaultSortConfig>
     auto Sort(const CompareFunction &compare_function,
-              const SortFunction &sort_algorithm) const;
+              const SortFunction &sort_algorithm,
+              const SortConfig& sort_config = SortConfig()) const;
+
+    /*!
+     * SortByKey is a DOp, which sorts a given DIA by the keys extracted from
+     * its elements. Keys must be integers or fixed-length byte strings
+     * std::array<uint8_t, N>, which allows local runs to be sorted using radix
+     * sort and elements to be sent to their target worker directly by the top
+     * bits of their keys. The order of elements with equal keys is arbitrary.
+     *
+     * \tparam KeyExtractor Type of the key_extractor function.
+     *  Should be ValueType->Key
+     *
+     * \param key_extractor Key extractor function, which maps each element to
+     * an integer or byte string key.
+     *
+     * \ingroup dia_dops
+     */
+    template <typename KeyExtractor>
+    auto SortByKey(const KeyExtractor &key_extractor) const;
 
     /*!
      * Merge is a DOp, which merges two sorted DIAs to a single sorted DIA.
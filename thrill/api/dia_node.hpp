@@ -17,6 +17,7 @@
 #include <thrill/data/file.hpp>
 
 #include <algorithm>
+#include <memory>
 #include <string>
 #include <vector>
 
@@ -39,15 +40,23 @@ class DIANode : public DIABase
 public:
     using Callback = common::Delegate<void(const ValueType&)>;
 
+    //! callback applying a child's function chain to a span of items
+    using BatchCallback = common::Delegate<void(const ValueType*, size_t)>;
+
+    //! number of items deserialized and pushed at once by PushFile()
+    static constexpr size_t kPushBatchSize = 256;
+
     struct Child {
         //! reference to child node
-        DIABase  * node;
+        DIABase       * node;
         //! callback to invoke (currently for each item)
-        Callback callback;
+        Callback      callback;
         //! index this node has among the parents of the child (passed to
         //! callbacks), e.g. for ZipNode which has multiple parents and their order
         //! is important.
-        size_t   parent_index;
+        size_t        parent_index;
+        //! optional callback to invoke for a span of items
+        BatchCallback batch_callback;
     };
 
     /*!
@@ -74,8 +83,35 @@ public:
      * children. This procedure enables the minimization of IO-accesses.
      */
     virtual void AddChild(DIABase* node, const Callback& callback,
-                          size_t parent_index = 0) {
-        children_.emplace_back(Child { node, callback, parent_index });
+                          size_t parent_index = 0,
+                          const BatchCallback& batch_callback = BatchCallback()) {
+        children_.emplace_back(
+            Child { node, callback, parent_index, batch_callback });
+    }
+
+    /*!
+     * Register a child's folded function chain. Next to the per-item Callback,
+     * a BatchCallback is constructed which runs the inlined chain over a span
+     * of items in a tight loop, such that PushItems() and PushFile() make only
+     * one indirect call per batch. Both callbacks share one copy of the chain,
+     * hence stateful functors see all items.
+     */
+    template <typename Chain>
+    void AddChild(DIABase* node, const Chain& chain, size_t parent_index = 0) {
+        std::shared_ptr<Chain> shared_chain = std::make_shared<Chain>(chain);
+        AddChild(
+            node,
+            Callback(
+                [shared_chain](const ValueType& item) {
+                    (*shared_chain)(item);
+                }),
+            parent_index,
+            BatchCallback(
+                [shared_chain](const ValueType* items, size_t size) {
+                    Chain& chain = *shared_chain;
+                    for (size_t i = 0; i < size; ++i)
+                        chain(items[i]);
+                }));
     }
 
     //! Remove a child from the vector of children. This method is called by the
@@ -142,6 +178,11 @@ public:
         }
     }
 
+    //! Method for derived classes to Push a span of items to all children.
+    void PushItems(const ValueType* items, size_t size) const {
+        PushItems(children_, items, size);
+    }
+
     //! Method for derived classes to Push a whole File of ValueType items to
     //! all children.
     void PushFile(data::File& file, bool consume) const {
@@ -156,19 +197,35 @@ public:
 
         if (nonfile_children.size() == 0) return;
 
-        // push into remaining which have a function stack or no direct File*
+        // push into remaining which have a function stack or no direct File*,
+        // deserializing batches of items.
         data::File::Reader reader = file.GetReader(consume);
-        while (reader.HasNext()) {
-            ValueType item = reader.Next<ValueType>();
-            for (const Child& child : nonfile_children) {
-                child.callback(item);
-            }
+        std::vector<ValueType> batch;
+        batch.reserve(kPushBatchSize);
+        while (reader.NextBatch(batch, kPushBatchSize) != 0) {
+            PushItems(nonfile_children, batch.data(), batch.size());
         }
     }
 
 protected:
     //! Callback functions from the child nodes.
     std::vector<Child> children_;
+
+private:
+    //! Push a span of items to the given children, via their batch callback
+    //! if available.
+    static void PushItems(const std::vector<Child>& children,
+                          const ValueType* items, size_t size) {
+        for (const Child& child : children) {
+            if (child.batch_callback) {
+                child.batch_callback(items, size);
+            }
+            else {
+                for (size_t i = 0; i < size; ++i)
+                    child.callback(items[i]);
+            }
+        }
+    }
 };
 
 //! \}
@@ -34,7 +34,8 @@ namespace api {
 
 // forward declarations for friend classes
 template <typename ValueType,
-          typename KeyExtractor, typename GroupFunction, typename HashFunction>
+          typename KeyExtractor, typename GroupFunction, typename HashFunction,
+          typename GroupByConfig>
 class GroupByNode;
 
 template <typename ValueType,
@@ -49,7 +50,8 @@ class GroupByIterator
     template <typename T1,
               typename T2,
               typename T3,
-              typename T4>
+              typename T4,
+              typename T5>
     friend class GroupByNode;
 
     template <typename T1,
@@ -131,7 +133,8 @@ class GroupByMultiwayMergeIterator
     template <typename T1,
               typename T2,
               typename T3,
-              typename T4>
+              typename T4,
+              typename T5>
     friend class GroupByNode;
 
     template <typename T1,
@@ -206,6 +209,37 @@ private:
     }
 };
 
+////////////////////////////////////////////////////////////////////////////////
+
+/*!
+ * Iterator over a range of items with equal keys, which were brought together
+ * in a vector by the hash-based grouping of GroupByNode.
+ */
+template <typename ValueType>
+class GroupByVectorIterator
+{
+public:
+    using ValueIn = ValueType;
+    using Iterator = typename std::vector<ValueIn>::iterator;
+
+    GroupByVectorIterator(Iterator begin, Iterator end)
+        : current_(begin), end_(end) { }
+
+    bool HasNext() const {
+        return current_ != end_;
+    }
+
+    //! items are moved out of the vector, which is discarded after grouping
+    ValueIn Next() {
+        assert(current_ != end_);
+        return std::move(*current_++);
+    }
+
+private:
+    Iterator current_;
+    Iterator end_;
+};
+
 //! \}
 
 } // namespace api
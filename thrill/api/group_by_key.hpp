@@ -22,19 +22,49 @@
 
 #include <algorithm>
 #include <functional>
+#include <iterator>
 #include <type_traits>
 #include <typeinfo>
+#include <unordered_map>
 #include <utility>
 #include <vector>
 
 namespace thrill {
 namespace api {
 
+/*!
+ * Configuration class to define operational parameters of GroupByKey. Members
+ * can be static constexpr or mutable variables.
+ */
+class DefaultGroupByConfig
+{
+public:
+    //! group items by hashing instead of sorting: received items are
+    //! partitioned into hash buckets, which are spilled to Files if memory is
+    //! exceeded. Each bucket is then grouped using a hash map, hence no
+    //! ordering on keys is required and groups are delivered in arbitrary
+    //! order. Each bucket must fit into memory.
+    static constexpr bool use_hash_grouping_ = false;
+
+    //! number of local hash buckets for hash grouping
+    size_t num_hash_buckets_ = 256;
+};
+
+/*!
+ * DefaultGroupByConfig with hash grouping enabled
+ */
+class HashGroupByConfig : public DefaultGroupByConfig
+{
+public:
+    static constexpr bool use_hash_grouping_ = true;
+};
+
 /*!
  * \ingroup api_layer
  */
 template <typename ValueType,
-          typename KeyExtractor, typename GroupFunction, typename HashFunction>
+          typename KeyExtractor, typename GroupFunction, typename HashFunction,
+          typename GroupByConfig>
 class GroupByNode final : public DOpNode<ValueType>
 {
     static constexpr bool debug = false;
@@ -47,6 +77,9 @@ class GroupByNode final : public DOpNode<ValueType>
     using ValueIn =
               typename common::FunctionTraits<KeyExtractor>::template arg_plain<0>;
 
+    using UseHashGrouping =
+              std::integral_constant<bool, GroupByConfig::use_hash_grouping_>;
+
     struct ValueComparator {
     public:
         explicit ValueComparator(const GroupByNode& node) : node_(node) { }
@@ -68,11 +101,13 @@ public:
     GroupByNode(const ParentDIA& parent,
                 const KeyExtractor& key_extractor,
                 const GroupFunction& groupby_function,
+                const GroupByConfig& config = GroupByConfig(),
                 const HashFunction& hash_function = HashFunction())
         : Super(parent.ctx(), "GroupByKey", { parent.id() }, { parent.node() }),
           key_extractor_(key_extractor),
           groupby_function_(groupby_function),
-          hash_function_(hash_function)
+          hash_function_(hash_function),
+          config_(config)
     {
         // Hook PreOp
         auto pre_op_fn = [=](const ValueIn& input) {
@@ -102,10 +137,15 @@ public:
     }
 
     void Execute() override {
-        MainOp();
+        MainOp(UseHashGrouping());
     }
 
     void PushData(bool consume) final {
+        PushData(consume, UseHashGrouping());
+    }
+
+    //! push groups of sorted runs using a multiway merge
+    void PushData(bool consume, std::false_type /* use_hash_grouping */) {
         LOG << "sort data";
         common::StatsTimerStart timer;
         const size_t num_runs = files_.size();
@@ -152,12 +192,46 @@ public:
             << " multiwaymerge=" << (num_runs > 1);
     }
 
-    void Dispose() override { }
+    //! push groups of each hash bucket
+    void PushData(bool consume, std::true_type /* use_hash_grouping */) {
+        common::StatsTimerStart timer;
+        for (size_t b = 0; b < hash_buckets_.size(); ++b) {
+            std::vector<ValueIn> items;
+            items.reserve(hash_files_[b].num_items() + hash_buckets_[b].size());
+
+            // collect spilled and in-memory items of the bucket
+            auto reader = hash_files_[b].GetReader(consume);
+            while (reader.HasNext())
+                items.emplace_back(reader.template Next<ValueIn>());
+
+            if (consume) {
+                std::move(hash_buckets_[b].begin(), hash_buckets_[b].end(),
+                          std::back_inserter(items));
+                std::vector<ValueIn>().swap(hash_buckets_[b]);
+            }
+            else {
+                items.insert(items.end(),
+                             hash_buckets_[b].begin(), hash_buckets_[b].end());
+            }
+
+            GroupAndPush(items);
+        }
+        timer.Stop();
+        LOG << "RESULT"
+            << " name=hashgrouping"
+            << " time=" << timer.Milliseconds();
+    }
+
+    void Dispose() override {
+        hash_files_.clear();
+        hash_buckets_.clear();
+    }
 
 private:
     KeyExtractor key_extractor_;
     GroupFunction groupby_function_;
     HashFunction hash_function_;
+    GroupByConfig config_;
 
     data::CatStreamPtr stream_ { context_.GetNewCatStream(this) };
     std::vector<data::Stream::Writer> emitter_;
@@ -165,6 +239,11 @@ private:
     data::File sorted_elems_ { context_.GetFile(this) };
     size_t totalsize_ = 0;
 
+    //! in-memory items of each hash bucket
+    std::vector<std::vector<ValueIn> > hash_buckets_;
+    //! spilled items of each hash bucket
+    std::vector<data::File> hash_files_;
+
     void RunUserFunc(data::File& f, bool consume) {
         auto r = f.GetReader(consume);
         if (r.HasNext()) {
@@ -201,7 +280,7 @@ private:
     }
 
     //! Receive elements from other workers.
-    void MainOp() {
+    void MainOp(std::false_type /* use_hash_grouping */) {
         LOG << "running group by main op";
 
         std::vector<ValueIn> incoming;
@@ -230,16 +309,111 @@ private:
             << " time=" << timer
             << " number_files=" << files_.size();
     }
+
+    //! Write all in-memory hash buckets to their Files.
+    void SpillHashBuckets() {
+        for (size_t b = 0; b < hash_buckets_.size(); ++b) {
+            if (hash_buckets_[b].empty()) continue;
+            data::File::Writer w = hash_files_[b].GetWriter();
+            for (const ValueIn& e : hash_buckets_[b])
+                w.Put(e);
+            w.Close();
+            std::vector<ValueIn>().swap(hash_buckets_[b]);
+        }
+    }
+
+    //! Receive elements from other workers into hash buckets.
+    void MainOp(std::true_type /* use_hash_grouping */) {
+        LOG << "running hash group by main op";
+
+        const size_t num_buckets = std::max<size_t>(1, config_.num_hash_buckets_);
+        const size_t num_workers = context_.num_workers();
+
+        hash_buckets_.resize(num_buckets);
+        for (size_t b = 0; b < num_buckets; ++b)
+            hash_files_.emplace_back(context_.GetFile(this));
+
+        common::StatsTimerStart timer;
+        auto reader = stream_->GetCatReader(/* consume */ true);
+        while (reader.HasNext()) {
+            if (mem::memory_exceeded)
+                SpillHashBuckets();
+
+            ValueIn v = reader.template Next<ValueIn>();
+            // the lower hash digits determined the worker, use the next ones
+            const size_t b =
+                (hash_function_(key_extractor_(v)) / num_workers) % num_buckets;
+            hash_buckets_[b].emplace_back(std::move(v));
+            ++totalsize_;
+        }
+        stream_->Close();
+
+        timer.Stop();
+
+        LOG << "RESULT"
+            << " name=mainop"
+            << " time=" << timer
+            << " items=" << totalsize_;
+    }
+
+    //! Bring items with equal keys together using a hash map and a counting
+    //! sort, then run the user function on each group.
+    void GroupAndPush(std::vector<ValueIn>& items) {
+        using KeyPlain = typename std::decay<Key>::type;
+
+        std::unordered_map<KeyPlain, size_t, HashFunction> group_index(
+            items.size(), hash_function_);
+        std::vector<size_t> group_of(items.size());
+        std::vector<size_t> group_begin;
+
+        for (size_t i = 0; i < items.size(); ++i) {
+            auto it = group_index.emplace(
+                key_extractor_(items[i]), group_begin.size());
+            if (it.second) group_begin.push_back(0);
+            group_of[i] = it.first->second;
+            ++group_begin[group_of[i]];
+        }
+        std::unordered_map<KeyPlain, size_t, HashFunction>().swap(group_index);
+
+        // exclusive prefix sum of group sizes
+        size_t sum = 0;
+        for (size_t& g : group_begin) {
+            size_t size = g;
+            g = sum;
+            sum += size;
+        }
+        group_begin.push_back(sum);
+
+        std::vector<ValueIn> grouped(items.size());
+        {
+            std::vector<size_t> offset(group_begin.begin(), group_begin.end());
+            for (size_t i = 0; i < items.size(); ++i)
+                grouped[offset[group_of[i]]++] = std::move(items[i]);
+        }
+        std::vector<ValueIn>().swap(items);
+        std::vector<size_t>().swap(group_of);
+
+        for (size_t g = 0; g + 1 < group_begin.size(); ++g) {
+            const Key key = key_extractor_(grouped[group_begin[g]]);
+            GroupByVectorIterator<ValueIn> user_iterator(
+                grouped.begin() + group_begin[g],
+                grouped.begin() + group_begin[g + 1]);
+            // call user function and push result to callback functions
+            this->PushItem(groupby_function_(user_iterator, key));
+        }
+    }
 };
 
 /******************************************************************************/
 
 template <typename ValueType, typename Stack>
 template <typename ValueOut, typename KeyExtractor,
-          typename GroupFunction, typename HashFunction>
+          typename GroupFunction, typename HashFunction,
+          typename GroupByConfig>
 auto DIA<ValueType, Stack>::GroupByKey(
     const KeyExtractor &key_extractor,
-    const GroupFunction &groupby_function) const {
+    const GroupFunction &groupby_function,
+    const GroupByConfig &groupby_config) const {
 
     using DOpResult = ValueOut;
 
@@ -251,10 +425,11 @@ auto DIA<ValueType, Stack>::GroupByKey(
         "KeyExtractor has the wrong input type");
 
     using GroupByNode = api::GroupByNode<
-              DOpResult, KeyExtractor, GroupFunction, HashFunction>;
+              DOpResult, KeyExtractor, GroupFunction, HashFunction,
+              GroupByConfig>;
 
     auto node = common::MakeCounting<GroupByNode>(
-        *this, key_extractor, groupby_function);
+        *this, key_extractor, groupby_function, groupby_config);
 
     return DIA<DOpResult>(node);
 }
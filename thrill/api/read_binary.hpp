@@ -254,37 +254,62 @@ private:
                            size_t& stats_total_bytes,
                            size_t& stats_total_reads)
             : context_(ctx),
-              sysfile_(core::SysFile::OpenForRead(fileinfo.path)),
               remain_size_(fileinfo.size()),
               is_compressed_(fileinfo.is_compressed),
               stats_total_bytes_(stats_total_bytes),
               stats_total_reads_(stats_total_reads) {
-            if (fileinfo.begin != 0 && !is_compressed_) {
-                // seek to beginning
-                size_t p = sysfile_.lseek(static_cast<off_t>(fileinfo.begin));
-                die_unequal(fileinfo.begin, p);
+            if (is_compressed_) {
+                sysfile_ = core::SysFile::OpenForRead(fileinfo.path);
+                return;
             }
+
+            // read uncompressed files asynchronously, one Block ahead.
+            file_ = io::FileBasePtr(
+                new io::SyscallFile(
+                    fileinfo.path,
+                    io::FileBase::RDONLY | io::FileBase::NO_LOCK));
+            offset_ = fileinfo.begin;
+            remain_size_ = std::min<size_t>(
+                remain_size_, file_->size() - fileinfo.begin);
+            IssueRead();
+        }
+
+        //! move-constructor: default
+        SysFileBlockSource(SysFileBlockSource&&) = default;
+
+        ~SysFileBlockSource() {
+            if (request_) request_->wait();
         }
 
         data::PinnedBlock NextBlock() {
             if (done_) return data::PinnedBlock();
 
+            if (!is_compressed_) {
+                if (!request_) {
+                    done_ = true;
+                    file_.reset();
+                    return data::PinnedBlock();
+                }
+                request_->wait();
+                request_.reset();
+
+                data::PinnedByteBlockPtr bytes = std::move(next_bytes_);
+                size_t size = next_size_;
+                IssueRead();
+
+                return data::PinnedBlock(std::move(bytes), 0, size, 0, 0,
+                                         /* typecode_verify */ false);
+            }
+
             data::PinnedByteBlockPtr bytes
                 = context_.block_pool().AllocateByteBlock(
                 block_size, context_.local_worker_id());
 
-            size_t rb = is_compressed_
-                        ? block_size : std::min(block_size, remain_size_);
-
-            ssize_t size = sysfile_.read(bytes->data(), rb);
+            ssize_t size = sysfile_.read(bytes->data(), block_size);
             stats_total_bytes_ += size;
             stats_total_reads_++;
 
             if (size > 0) {
-                if (!is_compressed_) {
-                    assert(remain_size_ >= rb);
-                    remain_size_ -= rb;
-                }
                 return data::PinnedBlock(std::move(bytes), 0, size, 0, 0,
                                          /* typecode_verify */ false);
             }
@@ -301,12 +326,37 @@ private:
 
     private:
         Context& context_;
+        //! pipe from the decompressor of compressed files
         core::SysFile sysfile_;
+        //! uncompressed file, which is read asynchronously
+        io::FileBasePtr file_;
+        //! outstanding read of the next Block
+        io::RequestPtr request_;
+        //! next Block and its size being read by request_
+        data::PinnedByteBlockPtr next_bytes_;
+        size_t next_size_ = 0;
+        //! position of the next read in file_
+        size_t offset_ = 0;
         size_t remain_size_;
         bool is_compressed_;
         size_t& stats_total_bytes_;
         size_t& stats_total_reads_;
         bool done_ = false;
+
+        //! issue an asynchronous read of the next Block of file_
+        void IssueRead() {
+            if (remain_size_ == 0) return;
+
+            next_size_ = std::min(block_size, remain_size_);
+            next_bytes_ = context_.block_pool().AllocateByteBlock(
+                block_size, context_.local_worker_id());
+            request_ = file_->aread(next_bytes_->data(), offset_, next_size_);
+
+            offset_ += next_size_;
+            remain_size_ -= next_size_;
+            stats_total_bytes_ += next_size_;
+            stats_total_reads_++;
+        }
     };
 };
 
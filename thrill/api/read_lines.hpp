@@ -17,13 +17,18 @@
 #include <thrill/api/dia.hpp>
 #include <thrill/api/source_node.hpp>
 #include <thrill/common/defines.hpp>
+#include <thrill/common/fast_string.hpp>
 #include <thrill/common/logger.hpp>
 #include <thrill/common/string.hpp>
+#include <thrill/common/string_view.hpp>
 #include <thrill/common/system_exception.hpp>
 #include <thrill/core/file_io.hpp>
+#include <thrill/core/gzip.hpp>
 #include <thrill/net/buffer_builder.hpp>
 
+#include <cstring>
 #include <string>
+#include <type_traits>
 #include <utility>
 #include <vector>
 
@@ -34,14 +39,23 @@ namespace api {
  * A DIANode which performs a line-based Read operation. Reads a file from the
  * file system and delivers it as a DIA.
  *
+ * The lines are delivered either as std::string or as common::FastString. The
+ * latter are references into the read buffer, which are valid only while the
+ * item is pushed to the children, copies of them own their data.
+ *
  * \ingroup api_layer
  */
-class ReadLinesNode final : public SourceNode<std::string>
+template <typename ValueType>
+class ReadLinesNode final : public SourceNode<ValueType>
 {
     static constexpr bool debug = false;
 
+    static_assert(std::is_same<ValueType, std::string>::value ||
+                  std::is_same<ValueType, common::FastString>::value,
+                  "ReadLines() delivers std::string or common::FastString");
+
 public:
-    using Super = SourceNode<std::string>;
+    using Super = SourceNode<ValueType>;
     using Super::context_;
 
     using FileSizePair = std::pair<std::string, size_t>;
@@ -72,22 +86,20 @@ public:
     }
 
     void PushData(bool /* consume */) final {
-        if (filelist_.contains_compressed) {
-            InputLineIteratorCompressed it = InputLineIteratorCompressed(
-                filelist_, *this);
+        if (filelist_.contains_unsplittable) {
+            InputLineIteratorCompressed it(filelist_, *this);
 
             // Hook Read
             while (it.HasNext()) {
-                this->PushItem(it.Next());
+                PushLine(it.Next(), IsFastString());
             }
         }
         else {
-            InputLineIteratorUncompressed it = InputLineIteratorUncompressed(
-                filelist_, *this);
+            InputLineIteratorSplittable it(filelist_, *this);
 
             // Hook Read
             while (it.HasNext()) {
-                this->PushItem(it.Next());
+                PushLine(it.Next(), IsFastString());
             }
         }
     }
@@ -95,6 +107,22 @@ public:
 private:
     core::SysFileList filelist_;
 
+    //! reused std::string to push lines
+    std::string line_;
+
+    using IsFastString = std::is_same<ValueType, common::FastString>;
+
+    //! push a line as a std::string, copied into a reused buffer.
+    void PushLine(const common::StringView& line, std::false_type) {
+        line_.assign(line.data(), line.size());
+        this->PushItem(line_);
+    }
+
+    //! push a line as a FastString referencing the read buffer.
+    void PushLine(const common::StringView& line, std::true_type) {
+        this->PushItem(common::FastString::Ref(line.data(), line.size()));
+    }
+
     class InputLineIterator
     {
     public:
@@ -115,16 +143,18 @@ private:
     protected:
         //! Block read size
         const size_t read_size = data::default_block_size;
-        //! String, which Next() references to
+        //! String collecting lines spanning blocks, which Next() may reference
         std::string data_;
         //! Input files with size prefixsum.
         const core::SysFileList& files_;
         //! Index of current file in files_
         size_t current_file_ = 0;
-        //! Byte buffer to create line std::string values.
+        //! Byte buffer for blocks read from compressed files.
         net::BufferBuilder buffer_;
-        //! Start of next element in current buffer.
-        unsigned char* current_;
+        //! [begin,end) of current block
+        const unsigned char* begin_ = nullptr, * end_ = nullptr;
+        //! Start of next element in current block.
+        const unsigned char* current_ = nullptr;
         //! (exclusive) [begin,end) of local block
         common::Range my_range_;
         //! Reference to node
@@ -144,13 +174,46 @@ private:
                 throw common::ErrnoException("Read error");
             }
             buffer.set_size(bytes);
-            current_ = buffer.begin();
+            begin_ = current_ = buffer.begin();
+            end_ = buffer.end();
             total_bytes_ += bytes;
             total_reads_++;
             LOG << "Opening block with " << bytes << " bytes.";
             return bytes > 0;
         }
 
+        /*!
+         * Scan for the next newline in the current buffer. If found, returns
+         * true and sets line to the characters up to it, which reference the
+         * buffer unless the line continues data_ from previous blocks.
+         * Otherwise appends the remaining buffer to data_.
+         */
+        bool ScanLine(common::StringView& line) {
+            const unsigned char* end = end_;
+            if (current_ >= end) return false;
+
+            const unsigned char* nl = static_cast<const unsigned char*>(
+                std::memchr(current_, '\n', end - current_));
+            const char* begin = reinterpret_cast<const char*>(current_);
+
+            if (THRILL_UNLIKELY(nl == nullptr)) {
+                data_.append(begin, end - current_);
+                current_ = end;
+                return false;
+            }
+
+            size_t size = nl - current_;
+            current_ += size + 1;
+            if (data_.size() == 0) {
+                line = common::StringView(begin, size);
+            }
+            else {
+                data_.append(begin, size);
+                line = common::StringView(data_.data(), data_.size());
+            }
+            return true;
+        }
+
         ~InputLineIterator() {
             node_.logger_
                 << "class" << "ReadLinesNode"
@@ -162,13 +225,32 @@ private:
         }
     };
 
-    //! InputLineIterator gives you access to lines of a file
-    class InputLineIteratorUncompressed : public InputLineIterator
+    /*!
+     * InputLineIterator gives you access to lines of uncompressed and BGZF
+     * compressed files, which are split into ranges of bytes among the
+     * workers. Each line belongs to the worker whose range contains the
+     * position of the preceding newline, or the start of the file. Bytes of
+     * BGZF files are positioned at the offset of their compressed block.
+     */
+    class InputLineIteratorSplittable : public InputLineIterator
     {
+    protected:
+        using Super = InputLineIterator;
+        using Super::read_size;
+        using Super::data_;
+        using Super::files_;
+        using Super::current_file_;
+        using Super::begin_;
+        using Super::end_;
+        using Super::current_;
+        using Super::my_range_;
+        using Super::node_;
+        using Super::ScanLine;
+
     public:
         //! Creates an instance of iterator that reads file line based
-        InputLineIteratorUncompressed(const core::SysFileList& files,
-                                      ReadLinesNode& node)
+        InputLineIteratorSplittable(const core::SysFileList& files,
+                                    ReadLinesNode& node)
             : InputLineIterator(files, node) {
 
             // Go to start of 'local part'.
@@ -177,108 +259,160 @@ private:
             while (files_.list[current_file_].size_inc_psum() <= my_range_.begin) {
                 current_file_++;
             }
-            if (my_range_.begin < my_range_.end) {
-                LOG << "Opening file " << current_file_;
-                file_ = core::SysFile::OpenForRead(files_.list[current_file_].path);
-            }
-            else {
+            if (my_range_.begin >= my_range_.end) {
                 LOG << "my_range : " << my_range_;
+                line_pos_ = my_range_.end;
                 return;
             }
 
             // find offset in current file:
             // offset = start - sum of previous file sizes
-            offset_ = file_.lseek(
-                static_cast<off_t>(my_range_.begin - files_.list[current_file_].size_ex_psum));
-            buffer_.Reserve(read_size);
-            ReadBlock(file_, buffer_);
+            size_t offset =
+                my_range_.begin - files_.list[current_file_].size_ex_psum;
 
-            if (offset_ != 0) {
-                bool found_n = false;
+            LOG << "Opening file " << current_file_;
+            OpenFile(offset);
+            line_pos_ = my_range_.begin;
 
+            if (offset != 0) {
                 // find next newline, discard all previous data as previous
-                // worker already covers it
-                while (!found_n) {
-                    while (current_ < buffer_.end()) {
-                        if (THRILL_UNLIKELY(*current_++ == '\n')) {
-                            found_n = true;
-                            break;
-                        }
-                    }
-                    // no newline found: read new data into buffer_builder
-                    if (!found_n) {
-                        offset_ += buffer_.size();
-                        if (!ReadBlock(file_, buffer_)) {
-                            // EOF = newline per definition
-                            found_n = true;
-                        }
+                // worker already covers it. If there is none in the rest of
+                // the file, HasNext() continues with the next file.
+                while (ReadBlock()) {
+                    const unsigned char* nl =
+                        static_cast<const unsigned char*>(
+                            std::memchr(current_, '\n', end_ - current_));
+                    if (nl != nullptr) {
+                        current_ = nl + 1;
+                        line_pos_ = Position(nl);
+                        break;
                     }
                 }
             }
             data_.reserve(4 * 1024);
         }
 
-        //! returns the next element if one exists
+        //! returns the next element if one exists, the line is valid until
+        //! the next call.
         //!
         //! does no checks whether a next element exists!
-        const std::string& Next() {
-            total_elements_++;
+        common::StringView Next() {
+            this->total_elements_++;
             data_.clear();
-            while (true) {
-                while (current_ < buffer_.end()) {
-                    if (THRILL_UNLIKELY(*current_ == '\n')) {
-                        current_++;
-                        return data_;
-                    }
-                    else {
-                        data_.push_back(*current_++);
-                    }
-                }
-                offset_ += buffer_.size();
-                if (!ReadBlock(file_, buffer_)) {
-                    LOG << "opening next file";
-
-                    file_.close();
-                    current_file_++;
-                    offset_ = 0;
-
-                    if (current_file_ < files_.count()) {
-                        file_ = core::SysFile::OpenForRead(files_.list[current_file_].path);
-                        offset_ += buffer_.size();
-                        ReadBlock(file_, buffer_);
-                    }
-                    else {
-                        current_ = buffer_.begin() +
-                                   files_.list[current_file_ - 1].size;
-                    }
-
-                    if (data_.length()) {
-                        return data_;
-                    }
+            common::StringView line;
+            while (!ScanLine(line)) {
+                if (!ReadBlock()) {
+                    // EOF = newline per definition
+                    return common::StringView(data_);
                 }
             }
+            line_pos_ = Position(current_ - 1);
+            return line;
         }
 
         //! returns true, if an element is available in local part
         bool HasNext() {
-            size_t position_in_buf = current_ - buffer_.begin();
-            assert(current_ >= buffer_.begin());
-            size_t global_index = offset_ + position_in_buf + files_.list[current_file_].size_ex_psum;
-            return global_index < my_range_.end ||
-                   (global_index == my_range_.end &&
-                    files_.list[current_file_].size > offset_ + position_in_buf);
+            // read next block or file, needs to be done here to know whether
+            // the next line starts at the beginning of a file.
+            while (current_ >= end_) {
+                if (line_pos_ >= my_range_.end || !NextBlock())
+                    return false;
+            }
+            return line_pos_ < my_range_.end;
         }
 
     private:
-        //! Offset of current block in file_.
+        //! Offset of current block in file, in BGZF files of the compressed
+        //! block.
         size_t offset_ = 0;
-        //! File handle to files_[current_file_]
-        core::SysFile file_;
+        //! Offset of next block in uncompressed files.
+        size_t next_offset_ = 0;
+        //! Position of the newline preceding the line at current_, or of the
+        //! start of the file.
+        size_t line_pos_ = 0;
+        //! whether files_[current_file_] is read via bgzf_file_
+        bool bgzf_ = false;
+        //! File handle to uncompressed files_[current_file_], which reads
+        //! ahead
+        core::ReadAheadFile file_;
+        //! File handle to BGZF files_[current_file_], which decompresses it
+        core::BgzfReader bgzf_file_;
+
+        //! open files_[current_file_] for reading from offset
+        void OpenFile(size_t offset) {
+            const core::SysFileInfo& fi = files_.list[current_file_];
+            bgzf_ = fi.is_bgzf;
+            next_offset_ = offset;
+            if (bgzf_)
+                bgzf_file_.open(fi.path, fi.size, offset, read_size);
+            else
+                file_.open(fi.path, fi.size, offset, read_size);
+        }
+
+        //! read the next block of the current file
+        bool ReadBlock() {
+            this->read_timer.Start();
+            size_t bytes;
+            if (bgzf_) {
+                bytes = bgzf_file_.read(&begin_, &offset_);
+            }
+            else {
+                offset_ = next_offset_;
+                bytes = file_.read(&begin_);
+                next_offset_ += bytes;
+            }
+            this->read_timer.Stop();
+            current_ = begin_;
+            end_ = begin_ + bytes;
+            this->total_bytes_ += bytes;
+            this->total_reads_++;
+            LOG << "Opening block with " << bytes << " bytes.";
+            return bytes > 0;
+        }
+
+        //! read the next block, continuing with the next file at the end of
+        //! the current one. Returns false after the last file.
+        bool NextBlock() {
+            while (!ReadBlock()) {
+                LOG << "opening next file";
+                file_.close();
+                bgzf_file_.close();
+
+                if (++current_file_ >= files_.count())
+                    return false;
+
+                OpenFile(0);
+                line_pos_ = files_.list[current_file_].size_ex_psum;
+            }
+            return true;
+        }
+
+        //! global position of a byte in the current block, by which lines are
+        //! assigned to workers.
+        size_t Position(const unsigned char* p) const {
+            return files_.list[current_file_].size_ex_psum + offset_ +
+                   (bgzf_ ? 0 : static_cast<size_t>(p - begin_));
+        }
     };
 
     //! InputLineIterator gives you access to lines of a file
     class InputLineIteratorCompressed : public InputLineIterator
     {
+    protected:
+        using Super = InputLineIterator;
+        using Super::read_size;
+        using Super::data_;
+        using Super::files_;
+        using Super::current_file_;
+        using Super::buffer_;
+        using Super::begin_;
+        using Super::end_;
+        using Super::current_;
+        using Super::my_range_;
+        using Super::node_;
+        using Super::ReadBlock;
+        using Super::ScanLine;
+
     public:
         //! Creates an instance of iterator that reads file line based
         InputLineIteratorCompressed(const core::SysFileList& files,
@@ -312,7 +446,8 @@ private:
                 LOG << "my_range : " << my_range_;
                 buffer_.Reserve(2);
                 buffer_.set_size(2);
-                current_ = buffer_.begin();
+                begin_ = current_ = buffer_.begin();
+                end_ = buffer_.end();
                 return;
             }
             buffer_.Reserve(read_size);
@@ -320,22 +455,17 @@ private:
             data_.reserve(4 * 1024);
         }
 
-        //! returns the next element if one exists
+        //! returns the next element if one exists, the line is valid until
+        //! the next call.
         //!
         //! does no checks whether a next element exists!
-        const std::string& Next() {
-            total_elements_++;
+        common::StringView Next() {
+            this->total_elements_++;
             data_.clear();
+            common::StringView line;
             while (true) {
-                while (current_ < buffer_.end()) {
-                    if (THRILL_UNLIKELY(*current_ == '\n')) {
-                        current_++;
-                        return data_;
-                    }
-                    else {
-                        data_.push_back(*current_++);
-                    }
-                }
+                if (ScanLine(line))
+                    return line;
 
                 if (!ReadBlock(file_, buffer_)) {
                     LOG << "Opening new file!";
@@ -353,7 +483,7 @@ private:
 
                     if (data_.length()) {
                         LOG << "end - returning string of length" << data_.length();
-                        return data_;
+                        return common::StringView(data_);
                     }
                 }
             }
@@ -408,13 +538,21 @@ private:
  * ReadLines is a DOp, which reads a file from the file system and
  * creates an ordered DIA according to a given read function.
  *
+ * Uncompressed and BGZF compressed files (as written by bgzip) are split among
+ * the workers, other compressed files are each read by a single worker.
+ *
+ * With ValueType = common::FastString, the lines reference the read buffer
+ * instead of being copied into std::strings, see ReadLinesNode.
+ *
  * \param ctx Reference to the context object
  * \param filepath Path of the file in the file system
  *
  * \ingroup dia_sources
  */
-DIA<std::string> ReadLines(Context& ctx, const std::string& filepath) {
-    return DIA<std::string>(common::MakeCounting<ReadLinesNode>(ctx, filepath));
+template <typename ValueType = std::string>
+DIA<ValueType> ReadLines(Context& ctx, const std::string& filepath) {
+    return DIA<ValueType>(
+        common::MakeCounting<ReadLinesNode<ValueType> >(ctx, filepath));
 }
 
 /*!
@@ -426,10 +564,11 @@ DIA<std::string> ReadLines(Context& ctx, const std::string& filepath) {
  *
  * \ingroup dia_sources
  */
-DIA<std::string> ReadLines(
+template <typename ValueType = std::string>
+DIA<ValueType> ReadLines(
     Context& ctx, const std::vector<std::string>& filepaths) {
-    return DIA<std::string>(
-        common::MakeCounting<ReadLinesNode>(ctx, filepaths));
+    return DIA<ValueType>(
+        common::MakeCounting<ReadLinesNode<ValueType> >(ctx, filepaths));
 }
 
 } // namespace api
@@ -108,12 +108,18 @@ public:
                       nullptr : parent.ctx().GetNewCatStream(this)),
           emitters_(use_mix_stream_ ?
                     mix_stream_->GetWriters() : cat_stream_->GetWriters()),
+          spread_stream_(config.spread_heavy_hitters_ ?
+                         parent.ctx().GetNewMixStream(this) : nullptr),
           pre_phase_(
               context_, Super::id(), parent.ctx().num_workers(),
               key_extractor, reduce_function, emitters_, config),
+          spread_phase_(
+              context_, Super::id(), parent.ctx().num_workers(),
+              key_extractor, reduce_function, emitters_, config),
           post_phase_(
               context_, Super::id(), key_extractor, reduce_function,
-              Emitter(this), config)
+              Emitter(this), config),
+          heavy_hitter_ratio_(config.heavy_hitter_ratio_)
     {
         // Hook PreOp: Locally hash elements of the current DIA onto buckets and
         // reduce each bucket to a single value, afterwards send data to another
@@ -137,21 +143,28 @@ public:
         LOG << *this << " running StartPreOp";
         if (!use_post_thread_) {
             // use pre_phase without extra thread
-            pre_phase_.Initialize(DIABase::mem_limit_);
+            pre_phase_limit_ = DIABase::mem_limit_;
+            pre_phase_.Initialize(pre_phase_limit_);
         }
         else {
-            pre_phase_.Initialize(DIABase::mem_limit_ / 2);
+            pre_phase_limit_ = DIABase::mem_limit_ / 2;
+            pre_phase_.Initialize(pre_phase_limit_);
             post_phase_.Initialize(DIABase::mem_limit_ / 2);
 
             // start additional thread to receive from the channel
             thread_ = common::CreateThread([this] { ProcessChannel(); });
         }
+        if (spread_stream_) {
+            spread_emitters_ = spread_stream_->GetWriters();
+            pre_phase_.EnableSpreading(spread_emitters_, heavy_hitter_ratio_);
+        }
     }
 
     void StopPreOp(size_t /* id */) final {
         LOG << *this << " running StopPreOp";
         // Flush hash table before the postOp
         pre_phase_.FlushAll();
+        if (spread_stream_) ReduceSpreadItems();
         pre_phase_.CloseAll();
         // waiting for the additional thread to finish the reduce
         if (use_post_thread_) thread_.join();
@@ -198,6 +211,23 @@ public:
         }
     }
 
+    //! reduce the heavy hitter items spread to this worker, and forward them
+    //! to the key's worker via the regular emitters.
+    void ReduceSpreadItems() {
+        pre_phase_.CloseSpreading();
+
+        spread_phase_.Initialize(pre_phase_limit_);
+        {
+            auto reader = spread_stream_->GetMixReader(/* consume */ true);
+            while (reader.HasNext()) {
+                spread_phase_.Insert(reader.template Next<PrePhaseOutput>());
+            }
+        }
+        spread_phase_.FlushAll();
+        spread_phase_.CloseAll();
+        spread_stream_->Close();
+    }
+
     void Dispose() final {
         post_phase_.Dispose();
     }
@@ -210,6 +240,11 @@ private:
 
     std::vector<data::Stream::Writer> emitters_;
 
+    //! stream for spreading heavy hitter items, only if enabled.
+    data::MixStreamPtr spread_stream_;
+
+    std::vector<data::Stream::Writer> spread_emitters_;
+
     //! handle to additional thread for post phase
     std::thread thread_;
 
@@ -217,11 +252,22 @@ private:
         ValueType, Key, Value, KeyExtractor, ReduceFunction, VolatileKey,
         ReduceConfig> pre_phase_;
 
+    //! second pre phase reducing spread heavy hitter items
+    core::ReducePrePhase<
+        ValueType, Key, Value, KeyExtractor, ReduceFunction, VolatileKey,
+        ReduceConfig> spread_phase_;
+
     core::ReduceByHashPostPhase<
         ValueType, Key, Value, KeyExtractor, ReduceFunction, Emitter, SendPair,
         ReduceConfig> post_phase_;
 
     bool reduced_ = false;
+
+    //! memory limit of the pre phase, reused by the spread phase
+    size_t pre_phase_limit_ = 0;
+
+    //! ratio of heavy hitter keys for spreading
+    double heavy_hitter_ratio_;
 };
 
 template <typename ValueType, typename Stack>
@@ -17,15 +17,19 @@
 #include <thrill/api/context.hpp>
 #include <thrill/api/dia.hpp>
 #include <thrill/api/dop_node.hpp>
+#include <thrill/common/functional.hpp>
 #include <thrill/common/logger.hpp>
 #include <thrill/common/math.hpp>
+#include <thrill/common/parallel_sort.hpp>
 #include <thrill/common/porting.hpp>
 #include <thrill/common/qsort.hpp>
+#include <thrill/common/radix_sort.hpp>
 #include <thrill/core/multiway_merge.hpp>
 #include <thrill/data/file.hpp>
 #include <thrill/net/group.hpp>
 
 #include <algorithm>
+#include <cmath>
 #include <cstdlib>
 #include <deque>
 #include <functional>
@@ -37,6 +41,180 @@
 namespace thrill {
 namespace api {
 
+/*!
+ * Configuration class to define operational parameters of the SortNode. Most
+ * members can be defined static constexpr or be mutable variables.
+ */
+class DefaultSortConfig
+{
+public:
+    //! use a two-level sample sort if the number of workers is at least this
+    //! threshold: the workers are split into about sqrt(p) groups, items are
+    //! first partitioned among the groups and then sorted within each group.
+    //! This reduces the number of peers each worker sends to from p to about
+    //! 2 sqrt(p). Set to zero to always use the single-level sample sort.
+    size_t multi_level_threshold_ = 512;
+
+    //! select splitters by a distributed multi-select on the samples instead
+    //! of gathering all samples on the first worker: each worker only sorts
+    //! its local samples, and the splitters are found using O(log n) rounds of
+    //! collective operations on vectors of all search ranges.
+    bool distributed_splitter_selection_ = false;
+
+    //! receive items in a background thread, while the worker thread classifies
+    //! and transmits its local items.
+    bool use_background_thread_ = false;
+
+    //! sort and write received runs in a background thread while receiving the
+    //! next run continues. The receive buffer is split into two halves for
+    //! this.
+    bool background_sort_runs_ = false;
+
+    //! number of threads used to merge sorted runs in PushData(). If larger
+    //! than one, the runs are split into key ranges which are merged in
+    //! parallel, each thread prefetching Blocks of its ranges from the
+    //! BlockPool. Zero or one merges sequentially.
+    size_t parallel_merge_threads_ = 1;
+};
+
+/*!
+ * Compare function class used by SortByKey(): items are ordered by the keys
+ * extracted from them, which must be integers or fixed-length byte strings
+ * supported by common::RadixKeyTraits.
+ */
+template <typename ValueType, typename KeyExtractor>
+class SortByKeyCompare
+{
+public:
+    using Key = typename std::decay<
+              typename common::FunctionTraits<KeyExtractor>::result_type>::type;
+
+    using KeyTraits = common::RadixKeyTraits<Key>;
+
+    explicit SortByKeyCompare(const KeyExtractor& key_extractor)
+        : key_extractor_(key_extractor) { }
+
+    bool operator () (const ValueType& a, const ValueType& b) const {
+        return key_extractor_(a) < key_extractor_(b);
+    }
+
+    //! extract key from item
+    Key key(const ValueType& v) const { return key_extractor_(v); }
+
+private:
+    KeyExtractor key_extractor_;
+};
+
+/*!
+ * Sort algorithm class used by SortByKey(): runs an 8-bit MSD radix sort on
+ * the keys extracted by the SortByKeyCompare.
+ */
+class RadixSortByKeyAlgorithm
+{
+public:
+    template <typename Iterator, typename ValueType, typename KeyExtractor>
+    void operator () (
+        Iterator begin, Iterator end,
+        const SortByKeyCompare<ValueType, KeyExtractor>& cmp) const {
+
+        using KeyTraits =
+                  typename SortByKeyCompare<ValueType, KeyExtractor>::KeyTraits;
+
+        common::radix_sort_key_CI<KeyTraits::key_bytes>(
+            begin, end,
+            [&cmp](const ValueType& v, size_t depth) {
+                return KeyTraits::Char(cmp.key(v), depth);
+            },
+            cmp);
+    }
+};
+
+/*!
+ * Classifier for SortNode::TransmitItems() which finds the bucket of an item
+ * directly from the top bits of its key. The generic version is disabled, only
+ * the specialization for SortByKeyCompare classifies.
+ */
+template <typename ValueType, typename CompareFunction>
+class SortKeyPrefixClassifier
+{
+public:
+    static constexpr bool enabled = false;
+    static constexpr size_t npos = size_t(-1);
+
+    template <typename SampleIndexPair>
+    SortKeyPrefixClassifier(const CompareFunction&, const SampleIndexPair*,
+                            size_t, size_t, size_t) { }
+
+    size_t Find(const ValueType&) const { return npos; }
+};
+
+template <typename ValueType, typename KeyExtractor>
+class SortKeyPrefixClassifier<
+        ValueType, SortByKeyCompare<ValueType, KeyExtractor> >
+{
+public:
+    using Compare = SortByKeyCompare<ValueType, KeyExtractor>;
+    using KeyTraits = typename Compare::KeyTraits;
+
+    static constexpr bool enabled = true;
+    static constexpr size_t npos = size_t(-1);
+
+    //! number of prefix bits relative to the splitter tree depth, such that
+    //! most table entries contain no splitter.
+    static constexpr size_t extra_bits = 6;
+
+    //! maximum number of prefix bits
+    static constexpr size_t max_bits = 20;
+
+    /*!
+     * Build lookup table from num_splitters sorted splitters. Entry v contains
+     * the bucket of all keys whose prefix is v, or npos if a splitter has
+     * prefix v, in which case the item must be classified by the tree. The
+     * last actual bucket is mapped to k - 1 like in the tree.
+     */
+    template <typename SampleIndexPair>
+    SortKeyPrefixClassifier(
+        const Compare& cmp, const SampleIndexPair* splitters,
+        size_t num_splitters, size_t log_k, size_t k)
+        : cmp_(cmp),
+          bits_(std::min(log_k + extra_bits, max_bits)),
+          table_(size_t(1) << bits_) {
+
+        size_t j = 0;
+        for (size_t v = 0; v < table_.size(); ++v) {
+            while (j < num_splitters && Top(cmp.key(splitters[j].first)) < v)
+                ++j;
+
+            if (j < num_splitters && Top(cmp.key(splitters[j].first)) == v)
+                table_[v] = static_cast<uint32_t>(-1);
+            else
+                table_[v] = static_cast<uint32_t>(
+                    j == num_splitters ? k - 1 : j);
+        }
+    }
+
+    //! return bucket of item or npos if ambiguous
+    size_t Find(const ValueType& v) const {
+        uint32_t b = table_[Top(cmp_.key(v))];
+        return b == static_cast<uint32_t>(-1) ? npos : b;
+    }
+
+private:
+    //! compare function to extract keys
+    const Compare& cmp_;
+
+    //! number of prefix bits used
+    size_t bits_;
+
+    //! lookup table from key prefix to bucket
+    std::vector<uint32_t> table_;
+
+    //! the top bits_ bits of the key's prefix.
+    size_t Top(const typename Compare::Key& key) const {
+        return static_cast<size_t>(KeyTraits::Prefix(key) >> (64 - bits_));
+    }
+};
+
 /*!
  * A DIANode which performs a Sort operation. Sort sorts a DIA according to a
  * given compare function
@@ -48,9 +226,12 @@ namespace api {
  *
  * \tparam CompareFunction Type of the compare function
  *
+ * \tparam SortConfig Configuration class of operational parameters
+ *
  * \ingroup api_layer
  */
-template <typename ValueType, typename CompareFunction, typename SortAlgorithm>
+template <typename ValueType, typename CompareFunction, typename SortAlgorithm,
+          typename SortConfig = DefaultSortConfig>
 class SortNode final : public DOpNode<ValueType>
 {
     static constexpr bool debug = false;
@@ -68,7 +249,9 @@ class SortNode final : public DOpNode<ValueType>
 
     using SampleIndexPair = std::pair<ValueType, size_t>;
 
-    static const bool use_background_thread_ = false;
+    //! Classifier for SortByKey() using the top bits of keys
+    using KeyPrefixClassifier =
+              SortKeyPrefixClassifier<ValueType, CompareFunction>;
 
 public:
     /*!
@@ -77,10 +260,12 @@ public:
     template <typename ParentDIA>
     SortNode(const ParentDIA& parent,
              const CompareFunction& compare_function,
-             const SortAlgorithm& sort_algorithm = SortAlgorithm())
+             const SortAlgorithm& sort_algorithm = SortAlgorithm(),
+             const SortConfig& sort_config = SortConfig())
         : Super(parent.ctx(), "Sort", { parent.id() }, { parent.node() }),
           compare_function_(compare_function),
           sort_algorithm_(sort_algorithm),
+          config_(sort_config),
           parent_stack_empty_(ParentDIA::stack_empty)
     {
         // Hook PreOp(s)
@@ -126,16 +311,7 @@ public:
         unsorted_file_ = file.Copy();
         local_items_ = unsorted_file_.num_items();
 
-        size_t pick_items = std::min(local_items_, wanted_sample_size());
-
-        sLOG << "Pick" << pick_items << "samples by random access"
-             << " from File containing " << local_items_ << " items.";
-        for (size_t i = 0; i < pick_items; ++i) {
-            size_t index = rng_() % local_items_;
-            sLOG << "got index[" << i << "] = " << index;
-            samples_.emplace_back(
-                unsorted_file_.GetItemAt<ValueType>(index), index);
-        }
+        SampleUnsortedFile();
 
         return true;
     }
@@ -182,7 +358,10 @@ public:
     //! calculate maximum merging degree from available memory and the number of
     //! files. additionally calculate the prefetch size of each File.
     std::pair<size_t, size_t> MaxMergeDegreePrefetch() {
-        size_t avail_blocks = DIABase::mem_limit_ / data::default_block_size;
+        // each merge thread holds one reader per File
+        size_t avail_blocks = std::max<size_t>(
+            2, DIABase::mem_limit_ / data::default_block_size
+            / std::max<size_t>(1, config_.parallel_merge_threads_));
         if (files_.size() >= avail_blocks) {
             // more files than blocks available -> partial merge of avail_blocks
             // Files with prefetch = 0, which is one read Block per File.
@@ -220,6 +399,14 @@ public:
                 sLOG1 << "Partial multi-way-merge of"
                       << merge_degree << "files with prefetch" << prefetch;
 
+                size_t num_threads = MergeThreads(merge_degree);
+                if (num_threads > 1) {
+                    files_.emplace_back(
+                        ParallelMergeFiles(merge_degree, prefetch, num_threads));
+                    files_.erase(files_.begin(), files_.begin() + merge_degree);
+                    continue;
+                }
+
                 // create merger for first merge_degree_ Files
                 std::vector<data::File::ConsumeReader> seq;
                 seq.reserve(merge_degree);
@@ -253,21 +440,27 @@ public:
             sLOG1 << "Start multi-way-merge of" << files_.size() << "files"
                   << "with prefetch" << prefetch;
 
-            // construct output merger of remaining Files
-            std::vector<data::File::Reader> seq;
-            seq.reserve(files_.size());
+            size_t num_threads = MergeThreads(files_.size());
+            if (num_threads > 1) {
+                local_size = ParallelMergePush(prefetch, num_threads, consume);
+            }
+            else {
+                // construct output merger of remaining Files
+                std::vector<data::File::Reader> seq;
+                seq.reserve(files_.size());
 
-            for (size_t t = 0; t < files_.size(); ++t)
-                seq.emplace_back(files_[t].GetReader(consume, 0));
+                for (size_t t = 0; t < files_.size(); ++t)
+                    seq.emplace_back(files_[t].GetReader(consume, 0));
 
-            StartPrefetch(seq, prefetch);
+                StartPrefetch(seq, prefetch);
 
-            auto puller = core::make_multiway_merge_tree<ValueType>(
-                seq.begin(), seq.end(), compare_function_);
+                auto puller = core::make_multiway_merge_tree<ValueType>(
+                    seq.begin(), seq.end(), compare_function_);
 
-            while (puller.HasNext()) {
-                this->PushItem(puller.Next());
-                local_size++;
+                while (puller.HasNext()) {
+                    this->PushItem(puller.Next());
+                    local_size++;
+                }
             }
         }
 
@@ -292,6 +485,9 @@ private:
     //! Sort function class
     SortAlgorithm sort_algorithm_;
 
+    //! Sort configuration
+    SortConfig config_;
+
     //! Whether the parent stack is empty
     const bool parent_stack_empty_;
 
@@ -323,6 +519,20 @@ private:
         return std::max(s, size_t(1));
     }
 
+    //! draw samples_ from unsorted_file_ by random access
+    void SampleUnsortedFile() {
+        size_t pick_items = std::min(local_items_, wanted_sample_size());
+
+        sLOG << "Pick" << pick_items << "samples by random access"
+             << " from File containing " << local_items_ << " items.";
+        for (size_t i = 0; i < pick_items; ++i) {
+            size_t index = rng_() % local_items_;
+            sLOG << "got index[" << i << "] = " << index;
+            samples_.emplace_back(
+                unsorted_file_.GetItemAt<ValueType>(index), index);
+        }
+    }
+
     //! \}
 
     //! \name MainOp and PushData
@@ -350,15 +560,13 @@ private:
     //! \}
 
     void FindAndSendSplitters(
-        std::vector<SampleIndexPair>& splitters, size_t sample_size,
+        std::vector<SampleIndexPair>& splitters,
+        size_t range_begin, size_t range_end, size_t num_buckets,
         data::MixStreamPtr& sample_stream,
         std::vector<data::MixStream::Writer>& sample_writers) {
 
-        // Get samples from other workers
-        size_t num_total_workers = context_.num_workers();
-
+        // Get samples from other workers of the range
         std::vector<SampleIndexPair> samples;
-        samples.reserve(sample_size * num_total_workers);
 
         auto reader = sample_stream->GetMixReader(/* consume */ true);
 
@@ -374,20 +582,229 @@ private:
                       return LessSampleIndex(a, b);
                   });
 
-        size_t splitting_size = samples.size() / num_total_workers;
+        size_t splitting_size = samples.size() / num_buckets;
 
-        // Send splitters to other workers
-        for (size_t i = 1; i < num_total_workers; ++i) {
+        // Send splitters to other workers of the range
+        for (size_t i = 1; i < num_buckets; ++i) {
             splitters.push_back(samples[i * splitting_size]);
-            for (size_t j = 1; j < num_total_workers; j++) {
+            for (size_t j = range_begin + 1; j < range_end; j++) {
                 sample_writers[j].Put(splitters.back());
             }
         }
 
-        for (size_t j = 1; j < num_total_workers; ++j)
+        for (size_t j = 0; j < sample_writers.size(); ++j)
             sample_writers[j].Close();
     }
 
+    /*!
+     * Select num_buckets - 1 splitters from the samples of all workers in the
+     * range [range_begin,range_end). All samples are sent to the first worker
+     * of the range, which sorts them and sends the splitters back.
+     */
+    std::vector<SampleIndexPair> SelectSplitters(
+        size_t range_begin, size_t range_end, size_t num_buckets,
+        size_t prefix_items) {
+
+        // stream to send samples to the range's root and receive them back
+        data::MixStreamPtr sample_stream = context_.GetNewMixStream(this);
+
+        // Send all samples to the first worker in the range.
+        std::vector<data::MixStream::Writer> sample_writers =
+            sample_stream->GetWriters();
+
+        for (const SampleIndexPair& sample : samples_) {
+            // send samples but add the local prefix to index ranks
+            sample_writers[range_begin].Put(
+                SampleIndexPair(sample.first, prefix_items + sample.second));
+        }
+        sample_writers[range_begin].Close();
+        std::vector<SampleIndexPair>().swap(samples_);
+
+        // close emitters to workers outside the range, otherwise the roots of
+        // different ranges wait on each other.
+        for (size_t j = 0; j < sample_writers.size(); j++) {
+            if (j < range_begin || j >= range_end)
+                sample_writers[j].Close();
+        }
+
+        std::vector<SampleIndexPair> splitters;
+        splitters.reserve(common::RoundUpToPowerOfTwo(num_buckets));
+
+        if (context_.my_rank() == range_begin) {
+            FindAndSendSplitters(splitters, range_begin, range_end, num_buckets,
+                                 sample_stream, sample_writers);
+        }
+        else {
+            // Close unused emitters
+            for (size_t j = 0; j < sample_writers.size(); j++) {
+                sample_writers[j].Close();
+            }
+            data::MixStream::MixReader reader =
+                sample_stream->GetMixReader(/* consume */ true);
+            while (reader.HasNext()) {
+                splitters.push_back(reader.template Next<SampleIndexPair>());
+            }
+        }
+        sample_writers.clear();
+        sample_stream->Close();
+
+        return splitters;
+    }
+
+    //! Pair of sample and length of the search range it was drawn from.
+    using SplitterPivot = std::pair<SampleIndexPair, size_t>;
+
+    //! Reduce functor that returns the pivot originating from the biggest
+    //! search range.
+    class ReduceSplitterPivots
+    {
+    public:
+        SplitterPivot operator () (
+            const SplitterPivot& a, const SplitterPivot& b) const {
+            return a.second > b.second ? a : b;
+        }
+    };
+
+    /*!
+     * Select the splitters of all num_ranges worker ranges of a level by a
+     * distributed multi-select on the samples. Each worker sorts only its
+     * local samples, and the splitter search ranges of all ranges are narrowed
+     * simultaneously by random pivots and global rank calculations using
+     * AllReduce, like in MergeNode. No worker gathers more than its own
+     * samples, and all workers of a range receive the same splitters as
+     * SelectSplitters() would pick.
+     */
+    std::vector<SampleIndexPair> SelectSplittersDistributed(
+        size_t num_ranges, size_t num_groups, bool final_level,
+        size_t prefix_items) {
+
+        size_t num_workers = context_.num_workers();
+        size_t my_range =
+            SubgroupOf(0, num_workers, num_ranges, context_.my_rank());
+
+        auto less_sample =
+            [this](const SampleIndexPair& a, const SampleIndexPair& b) {
+                return LessSampleIndex(a, b);
+            };
+
+        // add the local prefix to index ranks and sort local samples
+        for (SampleIndexPair& sample : samples_)
+            sample.second += prefix_items;
+
+        std::sort(samples_.begin(), samples_.end(), less_sample);
+
+        // calculate offsets of each range's splitters in the vector of all
+        // splitters of this level
+        std::vector<size_t> slot_begin(num_ranges + 1);
+        for (size_t r = 0; r < num_ranges; ++r) {
+            size_t buckets =
+                final_level
+                ? SubgroupBegin(0, num_workers, num_ranges, r + 1)
+                - SubgroupBegin(0, num_workers, num_ranges, r)
+                : num_groups;
+            slot_begin[r + 1] = slot_begin[r] + buckets - 1;
+        }
+        size_t num_slots = slot_begin[num_ranges];
+
+        // count the total number of samples in each range
+        std::vector<size_t> range_samples(num_ranges);
+        range_samples[my_range] = samples_.size();
+        range_samples = context_.net.AllReduce(
+            range_samples, common::ComponentSum<std::vector<size_t> >());
+
+        // calculate target ranks of all splitters and our local search ranges
+        std::vector<size_t> target_ranks(num_slots);
+        std::vector<size_t> left(num_slots), width(num_slots);
+        std::vector<bool> found(num_slots);
+
+        for (size_t r = 0; r < num_ranges; ++r) {
+            size_t buckets = slot_begin[r + 1] - slot_begin[r] + 1;
+            size_t splitting_size = range_samples[r] / buckets;
+            for (size_t s = slot_begin[r]; s < slot_begin[r + 1]; ++s) {
+                target_ranks[s] = (s - slot_begin[r] + 1) * splitting_size;
+                // ranges without any samples have no splitters
+                found[s] = (range_samples[r] == 0);
+                if (r == my_range)
+                    width[s] = samples_.size();
+            }
+        }
+
+        std::vector<SampleIndexPair> splitters(num_slots);
+        std::vector<SplitterPivot> pivots(num_slots);
+        std::vector<size_t> local_ranks(2 * num_slots), global_ranks;
+        size_t iterations = 0;
+
+        while (std::find(found.begin(), found.end(), false) != found.end())
+        {
+            // select a random pivot from the largest search range of each
+            // splitter
+            for (size_t s = 0; s < num_slots; ++s) {
+                if (!found[s] && width[s] > 0) {
+                    pivots[s] = SplitterPivot(
+                        samples_[left[s] + rng_() % width[s]], width[s]);
+                }
+                else {
+                    pivots[s] = SplitterPivot(SampleIndexPair(), 0);
+                }
+            }
+
+            pivots = context_.net.AllReduce(
+                pivots, common::ComponentSum<std::vector<SplitterPivot>,
+                                             ReduceSplitterPivots>());
+
+            // calculate the local rank of items less than and less or equal
+            // to the pivot, and sum them up globally.
+            std::fill(local_ranks.begin(), local_ranks.end(), 0);
+            for (size_t s = slot_begin[my_range];
+                 s < slot_begin[my_range + 1]; ++s) {
+                if (found[s]) continue;
+                local_ranks[2 * s + 0] = std::lower_bound(
+                    samples_.begin(), samples_.end(),
+                    pivots[s].first, less_sample) - samples_.begin();
+                local_ranks[2 * s + 1] = std::upper_bound(
+                    samples_.begin(), samples_.end(),
+                    pivots[s].first, less_sample) - samples_.begin();
+            }
+
+            global_ranks = context_.net.AllReduce(
+                local_ranks, common::ComponentSum<std::vector<size_t> >());
+
+            // shrink search ranges
+            for (size_t s = 0; s < num_slots; ++s) {
+                if (found[s]) continue;
+                assert(pivots[s].second > 0);
+
+                if (global_ranks[2 * s + 0] <= target_ranks[s] &&
+                    target_ranks[s] < global_ranks[2 * s + 1]) {
+                    splitters[s] = pivots[s].first;
+                    found[s] = true;
+                }
+                else if (global_ranks[2 * s + 1] <= target_ranks[s]) {
+                    width[s] -= local_ranks[2 * s + 1] - left[s];
+                    left[s] = local_ranks[2 * s + 1];
+                }
+                else {
+                    width[s] = local_ranks[2 * s + 0] - left[s];
+                }
+            }
+
+            ++iterations;
+        }
+
+        LOG << "SelectSplittersDistributed() finished after "
+            << iterations << " iterations";
+
+        std::vector<SampleIndexPair>().swap(samples_);
+
+        if (range_samples[my_range] == 0)
+            return std::vector<SampleIndexPair>();
+
+        // return only splitters of our range
+        return std::vector<SampleIndexPair>(
+            splitters.begin() + slot_begin[my_range],
+            splitters.begin() + slot_begin[my_range + 1]);
+    }
+
     class TreeBuilder
     {
     public:
@@ -442,6 +859,29 @@ private:
         return (n & ~(k - 1));
     }
 
+    //! Run a single item with global index i down the splitter tree and
+    //! return its bucket.
+    size_t FindBucket(const ValueType& el0, size_t i,
+                      const ValueType* const tree, size_t k, size_t log_k,
+                      const SampleIndexPair* const sorted_splitters) {
+        size_t j0 = 1;
+
+        // run item down the tree
+        for (size_t l = 0; l < log_k; l++)
+        {
+            j0 = 2 * j0 + (compare_function_(el0, tree[j0]) ? 0 : 1);
+        }
+
+        size_t b0 = j0 - k;
+
+        while (b0 && EqualSampleGreaterIndex(
+                   sorted_splitters[b0 - 1], SampleIndexPair(el0, i))) {
+            b0--;
+        }
+
+        return b0;
+    }
+
     void TransmitItems(
         // Tree of splitters, sizeof |splitter|
         const ValueType* const tree,
@@ -452,14 +892,12 @@ private:
         size_t actual_k,
         const SampleIndexPair* const sorted_splitters,
         size_t prefix_items,
-        data::MixStreamPtr& data_stream) {
+        // Writers of the target workers, one for each actual bucket
+        std::vector<data::MixStream::Writer>& data_writers) {
 
         data::File::ConsumeReader unsorted_reader =
             unsorted_file_.GetConsumeReader();
 
-        std::vector<data::MixStream::Writer> data_writers =
-            data_stream->GetWriters();
-
         // enlarge emitters array to next power of two to have direct access,
         // because we fill the splitter set up with sentinels == last splitter,
         // hence all items land in the last bucket.
@@ -471,6 +909,30 @@ private:
 
         std::swap(data_writers[actual_k - 1], data_writers[k - 1]);
 
+        if (KeyPrefixClassifier::enabled) {
+            // classify items directly by the top bits of their keys if the
+            // splitters allow it, otherwise run them down the tree.
+            KeyPrefixClassifier classifier(
+                compare_function_, sorted_splitters, actual_k - 1, log_k, k);
+
+            for (size_t i = prefix_items; i < prefix_items + local_items_; i++)
+            {
+                ValueType el0 = unsorted_reader.Next<ValueType>();
+
+                size_t b0 = classifier.Find(el0);
+                if (b0 == KeyPrefixClassifier::npos)
+                    b0 = FindBucket(el0, i, tree, k, log_k, sorted_splitters);
+
+                assert(data_writers[b0].IsValid());
+                data_writers[b0].Put(el0);
+            }
+
+            // close writers and flush data
+            for (size_t j = 0; j < data_writers.size(); j++)
+                data_writers[j].Close();
+            return;
+        }
+
         // classify all items (take two at once) and immediately transmit them.
 
         const size_t stepsize = 2;
@@ -522,21 +984,9 @@ private:
         // last iteration of loop if we have an odd number of items.
         for ( ; i < prefix_items + local_items_; i++)
         {
-            size_t j0 = 1;
             ValueType el0 = unsorted_reader.Next<ValueType>();
 
-            // run item down the tree
-            for (size_t l = 0; l < log_k; l++)
-            {
-                j0 = 2 * j0 + (compare_function_(el0, tree[j0]) ? 0 : 1);
-            }
-
-            size_t b0 = j0 - k;
-
-            while (b0 && EqualSampleGreaterIndex(
-                       sorted_splitters[b0 - 1], SampleIndexPair(el0, i))) {
-                b0--;
-            }
+            size_t b0 = FindBucket(el0, i, tree, k, log_k, sorted_splitters);
 
             assert(data_writers[b0].IsValid());
             data_writers[b0].Put(el0);
@@ -594,93 +1044,109 @@ private:
             << "write_time" << write_time;
     }
 
-    void MainOp() {
-        RunTimer timer(timer_execute_);
-
-        size_t prefix_items = local_items_;
-        size_t total_items = context_.net.ExPrefixSumTotal(prefix_items);
+    //! Begin of subgroup g when splitting the worker range [begin,end) into
+    //! num_groups contiguous subgroups of nearly equal size.
+    static size_t SubgroupBegin(
+        size_t begin, size_t end, size_t num_groups, size_t g) {
+        return begin + (end - begin) * g / num_groups;
+    }
 
-        size_t num_total_workers = context_.num_workers();
+    //! Index of the subgroup containing rank when splitting the worker range
+    //! [begin,end) into num_groups contiguous subgroups.
+    static size_t SubgroupOf(
+        size_t begin, size_t end, size_t num_groups, size_t rank) {
+        size_t g = 0;
+        while (SubgroupBegin(begin, end, num_groups, g + 1) <= rank)
+            ++g;
+        return g;
+    }
 
-        sLOG << "worker " << context_.my_rank()
-             << "local_items_" << local_items_
-             << "prefix_items" << prefix_items
-             << "total_items" << total_items
-             << "local sample_.size()" << samples_.size();
+    /*!
+     * Run one level of the sample sort. The workers are partitioned into
+     * num_ranges contiguous ranges, each of which is processed independently:
+     * select splitters from the range's samples, classify all local items into
+     * buckets, and transmit bucket g to one worker of the g-th subgroup of the
+     * range. In the final level each subgroup is a single worker and the
+     * received items are sorted into files_. Otherwise, the range is split
+     * into num_groups subgroups and the received items are collected in
+     * received_file to be sorted by the next level.
+     */
+    void SortLevel(size_t num_ranges, size_t num_groups, bool final_level,
+                   size_t prefix_items, data::File& received_file) {
 
-        if (total_items == 0) {
-            Super::logger_
-                << "class" << "SortNode"
-                << "event" << "done"
-                << "workers" << num_total_workers
-                << "local_out_size" << local_out_size_
-                << "balance" << 0
-                << "sample_size" << samples_.size();
-            return;
-        }
+        size_t my_rank = context_.my_rank();
+        size_t num_workers = context_.num_workers();
 
-        // stream to send samples to process 0 and receive them back
-        data::MixStreamPtr sample_stream = context_.GetNewMixStream(this);
+        size_t my_range = SubgroupOf(0, num_workers, num_ranges, my_rank);
+        size_t range_begin =
+            SubgroupBegin(0, num_workers, num_ranges, my_range);
+        size_t range_end =
+            SubgroupBegin(0, num_workers, num_ranges, my_range + 1);
 
-        // Send all samples to worker 0.
-        std::vector<data::MixStream::Writer> sample_writers =
-            sample_stream->GetWriters();
+        if (final_level)
+            num_groups = range_end - range_begin;
 
-        for (const SampleIndexPair& sample : samples_) {
-            // send samples but add the local prefix to index ranks
-            sample_writers[0].Put(
-                SampleIndexPair(sample.first, prefix_items + sample.second));
-        }
-        sample_writers[0].Close();
-        std::vector<SampleIndexPair>().swap(samples_);
+        std::vector<SampleIndexPair> splitters =
+            config_.distributed_splitter_selection_
+            ? SelectSplittersDistributed(
+                num_ranges, num_groups, final_level, prefix_items)
+            : SelectSplitters(range_begin, range_end, num_groups, prefix_items);
 
-        // Get the ceiling of log(num_total_workers), as SSSS needs 2^n buckets.
-        size_t ceil_log = common::IntegerLog2Ceil(num_total_workers);
+        // Get the ceiling of log(num_groups), as SSSS needs 2^n buckets.
+        size_t ceil_log = common::IntegerLog2Ceil(num_groups);
         size_t workers_algo = size_t(1) << ceil_log;
         size_t splitter_count_algo = workers_algo - 1;
 
-        std::vector<SampleIndexPair> splitters;
-        splitters.reserve(workers_algo);
-
-        if (context_.my_rank() == 0) {
-            FindAndSendSplitters(splitters, samples_.size(),
-                                 sample_stream, sample_writers);
-        }
-        else {
-            // Close unused emitters
-            for (size_t j = 1; j < num_total_workers; j++) {
-                sample_writers[j].Close();
-            }
-            data::MixStream::MixReader reader =
-                sample_stream->GetMixReader(/* consume */ true);
-            while (reader.HasNext()) {
-                splitters.push_back(reader.template Next<SampleIndexPair>());
-            }
-        }
-        sample_writers.clear();
-        sample_stream->Close();
-
         // code from SS2NPartition, slightly altered
 
         std::vector<ValueType> splitter_tree(workers_algo + 1);
 
-        // add sentinel splitters if fewer nodes than splitters.
-        for (size_t i = num_total_workers; i < workers_algo; i++) {
-            splitters.push_back(splitters.back());
-        }
+        // if no worker in the range has items, no splitters were selected and
+        // nothing needs to be classified.
+        if (splitters.size()) {
+            // add sentinel splitters if fewer nodes than splitters.
+            for (size_t i = num_groups; i < workers_algo; i++) {
+                splitters.push_back(splitters.back());
+            }
 
-        TreeBuilder(splitter_tree.data(),
-                    splitters.data(),
-                    splitter_count_algo);
+            TreeBuilder(splitter_tree.data(),
+                        splitters.data(),
+                        splitter_count_algo);
+        }
 
         data::MixStreamPtr data_stream = context_.GetNewMixStream(this);
 
+        // pick the writer of one worker in each subgroup: spread the workers
+        // of this range evenly over the subgroup's members.
+        std::vector<data::MixStream::Writer> stream_writers =
+            data_stream->GetWriters();
+        std::vector<data::MixStream::Writer> data_writers;
+        data_writers.reserve(workers_algo);
+
+        for (size_t g = 0; g < num_groups; ++g) {
+            size_t sub_begin =
+                SubgroupBegin(range_begin, range_end, num_groups, g);
+            size_t sub_end =
+                SubgroupBegin(range_begin, range_end, num_groups, g + 1);
+            size_t target =
+                sub_begin + (my_rank - range_begin) % (sub_end - sub_begin);
+            data_writers.emplace_back(std::move(stream_writers[target]));
+        }
+
+        // close writers to all other workers
+        for (size_t j = 0; j < stream_writers.size(); ++j)
+            stream_writers[j].Close();
+        stream_writers.clear();
+
         std::thread thread;
-        if (use_background_thread_) {
+        if (config_.use_background_thread_) {
             // launch receiver thread.
             thread = common::CreateThread(
-                [this, &data_stream]() {
-                    return ReceiveItems(data_stream);
+                [this, &data_stream, final_level, &received_file]() {
+                    if (final_level)
+                        return ReceiveItems(data_stream);
+                    else
+                        return ReceiveItemsToFile(data_stream, received_file);
                 });
             common::SetCpuAffinity(thread, context_.local_worker_id());
         }
@@ -689,19 +1155,83 @@ private:
             splitter_tree.data(), // Tree. sizeof |splitter|
             workers_algo,         // Number of buckets
             ceil_log,
-            num_total_workers,
+            num_groups,
             splitters.data(),
             prefix_items,
-            data_stream);
+            data_writers);
 
         std::vector<ValueType>().swap(splitter_tree);
 
-        if (use_background_thread_)
+        if (config_.use_background_thread_)
             thread.join();
-        else
+        else if (final_level)
             ReceiveItems(data_stream);
+        else
+            ReceiveItemsToFile(data_stream, received_file);
 
         data_stream->Close();
+    }
+
+    void MainOp() {
+        RunTimer timer(timer_execute_);
+
+        size_t prefix_items = local_items_;
+        size_t total_items = context_.net.ExPrefixSumTotal(prefix_items);
+
+        size_t num_total_workers = context_.num_workers();
+
+        sLOG << "worker " << context_.my_rank()
+             << "local_items_" << local_items_
+             << "prefix_items" << prefix_items
+             << "total_items" << total_items
+             << "local sample_.size()" << samples_.size();
+
+        if (total_items == 0) {
+            Super::logger_
+                << "class" << "SortNode"
+                << "event" << "done"
+                << "workers" << num_total_workers
+                << "local_out_size" << local_out_size_
+                << "balance" << 0
+                << "sample_size" << samples_.size();
+            return;
+        }
+
+        // number of independent worker ranges in the final level
+        size_t num_ranges = 1;
+
+        if (config_.multi_level_threshold_ != 0 &&
+            num_total_workers >= config_.multi_level_threshold_)
+        {
+            // first level: partition items among about sqrt(p) groups
+            size_t num_groups = static_cast<size_t>(
+                std::ceil(std::sqrt(static_cast<double>(num_total_workers))));
+
+            data::File received_file = context_.GetFile(this);
+            SortLevel(/* num_ranges */ 1, num_groups, /* final_level */ false,
+                      prefix_items, received_file);
+
+            // replace unsorted items and draw new samples
+            unsorted_file_ = std::move(received_file);
+            local_items_ = unsorted_file_.num_items();
+            SampleUnsortedFile();
+
+            prefix_items = context_.net.ExPrefixSum(local_items_);
+
+            sLOG << "worker" << context_.my_rank()
+                 << "second level local_items_" << local_items_
+                 << "prefix_items" << prefix_items;
+
+            // the groups are sorted independently in the final level
+            num_ranges = num_groups;
+        }
+
+        // final level: each worker of a range receives one bucket
+        {
+            data::File unused_file = context_.GetFile(this);
+            SortLevel(num_ranges, /* num_groups */ 0, /* final_level */ true,
+                      prefix_items, unused_file);
+        }
 
         double balance = 0;
         if (local_out_size_ > 0) {
@@ -723,34 +1253,293 @@ private:
             << "sample_size" << samples_.size();
     }
 
+    //! Receive all items of an intermediate level into an unsorted File.
+    void ReceiveItemsToFile(
+        data::MixStreamPtr& data_stream, data::File& file) {
+
+        auto reader = data_stream->GetMixReader(/* consume */ true);
+        auto writer = file.GetWriter();
+
+        while (reader.HasNext()) {
+            writer.Put(reader.template Next<ValueType>());
+        }
+        writer.Close();
+    }
+
     void ReceiveItems(data::MixStreamPtr& data_stream) {
 
         auto reader = data_stream->GetMixReader(/* consume */ true);
 
         LOG << "Writing files";
 
-        // M/2 such that the other half is used to prepare the next bulk
-        size_t capacity = DIABase::mem_limit_ / sizeof(ValueType) / 2;
-        std::vector<ValueType> vec;
+        if (config_.background_sort_runs_) {
+            ReceiveItemsBackgroundSort(reader);
+        }
+        else {
+            // M/2 such that the other half is used to prepare the next bulk
+            size_t capacity = DIABase::mem_limit_ / sizeof(ValueType) / 2;
+            std::vector<ValueType> vec;
+            vec.reserve(capacity);
+
+            while (reader.HasNext()) {
+                if (!mem::memory_exceeded && vec.size() < capacity) {
+                    vec.push_back(reader.template Next<ValueType>());
+                }
+                else {
+                    SortAndWriteToFile(vec, files_);
+                }
+            }
+
+            if (vec.size())
+                SortAndWriteToFile(vec, files_);
+        }
+
+        if (stats_enabled) {
+            context_.PrintCollectiveMeanStdev(
+                "Sort() timer_sort_", timer_sort_.SecondsDouble());
+        }
+    }
+
+    /*!
+     * Receive items into one of two buffers of M/4 each. When a buffer is
+     * full, it is sorted and written to a File by a background thread, while
+     * receiving continues into the other buffer.
+     */
+    void ReceiveItemsBackgroundSort(data::MixStream::MixReader& reader) {
+
+        size_t capacity = DIABase::mem_limit_ / sizeof(ValueType) / 4;
+        std::vector<ValueType> vec, sort_vec;
         vec.reserve(capacity);
 
+        std::thread sort_thread;
+
         while (reader.HasNext()) {
-            if (!mem::memory_exceeded && vec.size() < capacity) {
+            if (vec.size() == 0 ||
+                (!mem::memory_exceeded && vec.size() < capacity)) {
                 vec.push_back(reader.template Next<ValueType>());
             }
             else {
-                SortAndWriteToFile(vec, files_);
+                // wait for the previous run, then sort this one in background
+                if (sort_thread.joinable())
+                    sort_thread.join();
+
+                std::swap(vec, sort_vec);
+                vec.reserve(capacity);
+
+                sort_thread = common::CreateThread(
+                    [this, &sort_vec]() {
+                        SortAndWriteToFile(sort_vec, files_);
+                    });
             }
         }
 
+        if (sort_thread.joinable())
+            sort_thread.join();
+
         if (vec.size())
             SortAndWriteToFile(vec, files_);
+    }
 
-        if (stats_enabled) {
-            context_.PrintCollectiveMeanStdev(
-                "Sort() timer_sort_", timer_sort_.SecondsDouble());
+    //! \name Parallel Merging
+    //! \{
+
+    //! Reader adapter delivering only the next num_items items of a File, used
+    //! to merge one key range of each File.
+    class RangeReader
+    {
+    public:
+        RangeReader(data::File::KeepReader&& reader, size_t num_items)
+            : reader_(std::move(reader)), remaining_(num_items) { }
+
+        bool HasNext() const { return remaining_ != 0; }
+
+        template <typename Type>
+        Type Next() {
+            assert(remaining_ != 0);
+            --remaining_;
+            return reader_.template Next<Type>();
+        }
+
+    private:
+        data::File::KeepReader reader_;
+        size_t remaining_;
+    };
+
+    //! minimum number of items per thread to warrant parallel merging
+    static constexpr size_t min_merge_items_per_thread_ = 16384;
+
+    //! number of threads to use for merging the first num_files Files
+    size_t MergeThreads(size_t num_files) const {
+        size_t total_items = 0;
+        for (size_t f = 0; f < num_files; ++f)
+            total_items += files_[f].num_items();
+        return std::max<size_t>(
+            1, std::min(config_.parallel_merge_threads_,
+                        total_items / min_merge_items_per_thread_));
+    }
+
+    /*!
+     * Split the first num_files Files into num_threads key ranges of about
+     * equal size. Splitters are picked from an evenly spaced sample of all
+     * Files, and their positions are located in each File by binary search
+     * using random access, which costs O(log n) Block reads per splitter.
+     * Returns a (num_threads + 1) x num_files matrix of range begin indexes.
+     */
+    std::vector<std::vector<size_t> >
+    SplitMergeRanges(size_t num_files, size_t num_threads) const {
+
+        //! oversampling factor for the range splitters
+        static constexpr size_t oversampling = 16;
+
+        size_t total_items = 0;
+        for (size_t f = 0; f < num_files; ++f)
+            total_items += files_[f].num_items();
+
+        // draw samples from each File proportional to its size
+        std::vector<ValueType> samples;
+        for (size_t f = 0; f < num_files; ++f) {
+            size_t n = files_[f].num_items();
+            size_t s = common::IntegerDivRoundUp(
+                n * oversampling * num_threads, total_items);
+            for (size_t i = 0; i < s; ++i) {
+                samples.emplace_back(
+                    files_[f].GetItemAt<ValueType>((2 * i + 1) * n / (2 * s)));
+            }
+        }
+        std::sort(samples.begin(), samples.end(), compare_function_);
+
+        std::vector<std::vector<size_t> > offsets(
+            num_threads + 1, std::vector<size_t>(num_files, 0));
+
+        for (size_t f = 0; f < num_files; ++f)
+            offsets[num_threads][f] = files_[f].num_items();
+
+        for (size_t t = 1; t < num_threads; ++t) {
+            const ValueType& splitter =
+                samples[t * samples.size() / num_threads];
+            for (size_t f = 0; f < num_files; ++f) {
+                // binary search for the first item not less than splitter
+                size_t left = offsets[t - 1][f], right = files_[f].num_items();
+                while (left < right) {
+                    size_t mid = (left + right) / 2;
+                    if (compare_function_(
+                            files_[f].GetItemAt<ValueType>(mid), splitter))
+                        left = mid + 1;
+                    else
+                        right = mid;
+                }
+                offsets[t][f] = left;
+            }
+        }
+
+        return offsets;
+    }
+
+    //! Merge key range t of the first num_files Files and deliver the items to
+    //! the emit function. Returns the number of merged items.
+    template <typename Emit>
+    size_t MergeRange(
+        const std::vector<std::vector<size_t> >& offsets, size_t t,
+        size_t num_files, size_t prefetch, const Emit& emit) const {
+
+        std::vector<RangeReader> seq;
+        seq.reserve(num_files);
+
+        for (size_t f = 0; f < num_files; ++f) {
+            size_t begin = offsets[t][f], end = offsets[t + 1][f];
+            if (begin == end) continue;
+            seq.emplace_back(
+                files_[f].GetReaderAt<ValueType>(begin, prefetch),
+                end - begin);
+        }
+        if (seq.size() == 0) return 0;
+
+        auto puller = core::make_multiway_merge_tree<ValueType>(
+            seq.begin(), seq.end(), compare_function_);
+
+        size_t count = 0;
+        while (puller.HasNext()) {
+            emit(puller.Next());
+            ++count;
+        }
+        return count;
+    }
+
+    //! Merge the first num_files Files in parallel into a single new File,
+    //! which is the concatenation of the merged key ranges.
+    data::File ParallelMergeFiles(
+        size_t num_files, size_t prefetch, size_t num_threads) {
+
+        std::vector<std::vector<size_t> > offsets =
+            SplitMergeRanges(num_files, num_threads);
+
+        std::vector<data::File> range_files;
+        for (size_t t = 0; t < num_threads; ++t)
+            range_files.emplace_back(context_.GetFile(this));
+
+        common::parallel_sort_run(
+            num_threads, [&](size_t t) {
+                auto writer = range_files[t].GetWriter();
+                MergeRange(offsets, t, num_files, prefetch,
+                           [&writer](const ValueType& v) { writer.Put(v); });
+                writer.Close();
+            });
+
+        data::File file = context_.GetFile(this);
+        for (data::File& range_file : range_files) {
+            for (const data::Block& b : range_file.blocks())
+                file.AppendBlock(b);
         }
+        return file;
     }
+
+    /*!
+     * Merge all Files in parallel and push the items: the calling thread
+     * merges and pushes the first key range, while the other threads merge
+     * their key ranges into Files, which are pushed thereafter.
+     */
+    size_t ParallelMergePush(size_t prefetch, size_t num_threads, bool consume) {
+
+        const size_t num_files = files_.size();
+        std::vector<std::vector<size_t> > offsets =
+            SplitMergeRanges(num_files, num_threads);
+
+        std::vector<data::File> range_files;
+        for (size_t t = 0; t < num_threads; ++t)
+            range_files.emplace_back(context_.GetFile(this));
+
+        size_t local_size = 0;
+
+        common::parallel_sort_run(
+            num_threads, [&](size_t t) {
+                if (t == 0) {
+                    local_size += MergeRange(
+                        offsets, t, num_files, prefetch,
+                        [this](const ValueType& v) { this->PushItem(v); });
+                    return;
+                }
+                auto writer = range_files[t].GetWriter();
+                MergeRange(offsets, t, num_files, prefetch,
+                           [&writer](const ValueType& v) { writer.Put(v); });
+                writer.Close();
+            });
+
+        if (consume) files_.clear();
+
+        // push items of the merged ranges. PushFile() cannot be used, since
+        // children accepting Files directly may not mix these with items.
+        for (size_t t = 1; t < num_threads; ++t) {
+            data::File::ConsumeReader reader =
+                range_files[t].GetConsumeReader();
+            while (reader.HasNext()) {
+                this->PushItem(reader.template Next<ValueType>());
+                ++local_size;
+            }
+        }
+        return local_size;
+    }
+
+    //! \}
 };
 
 class DefaultSortAlgorithm
@@ -762,6 +1551,28 @@ public:
     }
 };
 
+/*!
+ * Sort algorithm class running a parallel super-scalar sample sort on each
+ * local run. With num_threads = 0, the sort borrows all hardware threads not
+ * currently used by parallel sorts of other local workers, which lets straggler
+ * workers with larger buckets finish sooner.
+ */
+class ParallelSortAlgorithm
+{
+public:
+    explicit ParallelSortAlgorithm(size_t num_threads = 0)
+        : num_threads_(num_threads) { }
+
+    template <typename Iterator, typename CompareFunction>
+    void operator () (Iterator begin, Iterator end, CompareFunction cmp) const {
+        return common::parallel_sample_sort(begin, end, cmp, num_threads_);
+    }
+
+private:
+    //! number of threads to use, or zero to borrow all idle threads.
+    size_t num_threads_;
+};
+
 template <typename ValueType, typename Stack>
 template <typename CompareFunction>
 auto DIA<ValueType, Stack>::Sort(const CompareFunction &compare_function) const {
@@ -794,13 +1605,15 @@ auto DIA<ValueType, Stack>::Sort(const CompareFunction &compare_function) const
 }
 
 template <typename ValueType, typename Stack>
-template <typename CompareFunction, typename SortAlgorithm>
+template <typename CompareFunction, typename SortAlgorithm,
+          typename SortConfig>
 auto DIA<ValueType, Stack>::Sort(const CompareFunction &compare_function,
-                                 const SortAlgorithm &sort_algorithm) const {
+                                 const SortAlgorithm &sort_algorithm,
+                                 const SortConfig &sort_config) const {
     assert(IsValid());
 
     using SortNode = api::SortNode<
-              ValueType, CompareFunction, SortAlgorithm>;
+              ValueType, CompareFunction, SortAlgorithm, SortConfig>;
 
     static_assert(
         std::is_convertible<
@@ -821,7 +1634,30 @@ auto DIA<ValueType, Stack>::Sort(const CompareFunction &compare_function,
         "CompareFunction has the wrong output type (should be bool)");
 
     auto node = common::MakeCounting<SortNode>(
-        *this, compare_function, sort_algorithm);
+        *this, compare_function, sort_algorithm, sort_config);
+
+    return DIA<ValueType>(node);
+}
+
+template <typename ValueType, typename Stack>
+template <typename KeyExtractor>
+auto DIA<ValueType, Stack>::SortByKey(
+    const KeyExtractor &key_extractor) const {
+    assert(IsValid());
+
+    using Compare = SortByKeyCompare<ValueType, KeyExtractor>;
+
+    using SortNode = api::SortNode<
+              ValueType, Compare, RadixSortByKeyAlgorithm>;
+
+    static_assert(
+        std::is_convertible<
+            ValueType,
+            typename FunctionTraits<KeyExtractor>::template arg<0> >::value,
+        "KeyExtractor has the wrong input type");
+
+    auto node = common::MakeCounting<SortNode>(
+        *this, Compare(key_extractor), RadixSortByKeyAlgorithm());
 
     return DIA<ValueType>(node);
 }
@@ -56,6 +56,8 @@ public:
     using Super = DIANode<ValueType>;
     using Super::context_;
     using Callback = typename Super::Callback;
+    using BatchCallback = typename Super::BatchCallback;
+    using Super::AddChild;
 
     enum class ChildStatus { NEW, PUSHING, DONE };
 
@@ -156,10 +158,13 @@ public:
     /*!
      * Enables children to push their "folded" function chains to their parent.
      * This way the parent can push all its result elements to each of the
-     * children. This procedure enables the minimization of IO-accesses.
+     * children. This procedure enables the minimization of IO-accesses. Items
+     * are pushed individually per input, hence the batch callback is unused.
      */
     void AddChild(DIABase* node, const Callback& callback,
-                  size_t parent_index = 0) final {
+                  size_t parent_index = 0,
+                  const BatchCallback& /* batch_callback */ = BatchCallback())
+    final {
         children_.emplace_back(UnionChild {
                                    node, callback, parent_index,
                                    ChildStatus::NEW, std::vector<size_t>(num_inputs_)
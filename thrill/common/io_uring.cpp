@@ -0,0 +1,182 @@
+/*******************************************************************************
+ * thrill/common/io_uring.cpp
+ *
+ * Minimal wrapper around a Linux io_uring submission and completion queue pair,
+ * using the raw system calls.
+ *
+ * Part of Project Thrill - http://project-thrill.org
+ *
+ * Copyright (C) 2016 Timo Bingmann <tb@panthema.net>
+ *
+ * All rights reserved. Published under the BSD-2 license in the LICENSE file.
+ ******************************************************************************/
+
+#include <thrill/common/io_uring.hpp>
+
+#if THRILL_HAVE_IO_URING
+
+#include <thrill/common/system_exception.hpp>
+
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <csignal>
+#include <cstring>
+
+namespace thrill {
+namespace common {
+
+IoUring::IoUring(unsigned entries) {
+    struct io_uring_params p;
+    memset(&p, 0, sizeof(p));
+
+    fd_ = static_cast<int>(syscall(__NR_io_uring_setup, entries, &p));
+    if (fd_ < 0)
+        throw ErrnoException("IoUring() io_uring_setup() failed", errno);
+
+    features_ = p.features;
+
+    sq_ring_size_ = p.sq_off.array + p.sq_entries * sizeof(unsigned);
+    cq_ring_size_ = p.cq_off.cqes + p.cq_entries * sizeof(struct io_uring_cqe);
+
+    if (features_ & IORING_FEAT_SINGLE_MMAP)
+        sq_ring_size_ = cq_ring_size_ = std::max(sq_ring_size_, cq_ring_size_);
+
+    sq_ring_ = mmap(nullptr, sq_ring_size_, PROT_READ | PROT_WRITE,
+                    MAP_SHARED | MAP_POPULATE, fd_, IORING_OFF_SQ_RING);
+    if (sq_ring_ == MAP_FAILED) {
+        int err = errno;
+        ::close(fd_);
+        throw ErrnoException("IoUring() could not map submission ring", err);
+    }
+
+    if (features_ & IORING_FEAT_SINGLE_MMAP) {
+        cq_ring_ = sq_ring_;
+    }
+    else {
+        cq_ring_ = mmap(nullptr, cq_ring_size_, PROT_READ | PROT_WRITE,
+                        MAP_SHARED | MAP_POPULATE, fd_, IORING_OFF_CQ_RING);
+        if (cq_ring_ == MAP_FAILED) {
+            int err = errno;
+            munmap(sq_ring_, sq_ring_size_);
+            ::close(fd_);
+            throw ErrnoException("IoUring() could not map completion ring", err);
+        }
+    }
+
+    sqes_size_ = p.sq_entries * sizeof(struct io_uring_sqe);
+    void* sqes = mmap(nullptr, sqes_size_, PROT_READ | PROT_WRITE,
+                      MAP_SHARED | MAP_POPULATE, fd_, IORING_OFF_SQES);
+    if (sqes == MAP_FAILED) {
+        int err = errno;
+        if (cq_ring_ != sq_ring_) munmap(cq_ring_, cq_ring_size_);
+        munmap(sq_ring_, sq_ring_size_);
+        ::close(fd_);
+        throw ErrnoException("IoUring() could not map submission entries", err);
+    }
+    sqes_ = static_cast<struct io_uring_sqe*>(sqes);
+
+    char* sq = static_cast<char*>(sq_ring_);
+    sq_head_ = reinterpret_cast<unsigned*>(sq + p.sq_off.head);
+    sq_tail_ = reinterpret_cast<unsigned*>(sq + p.sq_off.tail);
+    sq_mask_ = reinterpret_cast<unsigned*>(sq + p.sq_off.ring_mask);
+    sq_array_ = reinterpret_cast<unsigned*>(sq + p.sq_off.array);
+    sq_entries_ = p.sq_entries;
+
+    char* cq = static_cast<char*>(cq_ring_);
+    cq_head_ = reinterpret_cast<unsigned*>(cq + p.cq_off.head);
+    cq_tail_ = reinterpret_cast<unsigned*>(cq + p.cq_off.tail);
+    cq_mask_ = reinterpret_cast<unsigned*>(cq + p.cq_off.ring_mask);
+    cqes_ = reinterpret_cast<struct io_uring_cqe*>(cq + p.cq_off.cqes);
+
+    sqe_head_ = sqe_tail_ = *sq_tail_;
+}
+
+IoUring::~IoUring() {
+    munmap(sqes_, sqes_size_);
+    if (cq_ring_ != sq_ring_) munmap(cq_ring_, cq_ring_size_);
+    munmap(sq_ring_, sq_ring_size_);
+    ::close(fd_);
+}
+
+struct io_uring_sqe* IoUring::GetSqe() {
+    unsigned head = __atomic_load_n(sq_head_, __ATOMIC_ACQUIRE);
+    if (sqe_tail_ - head >= sq_entries_)
+        return nullptr;
+
+    struct io_uring_sqe* sqe = &sqes_[sqe_tail_ & *sq_mask_];
+    ++sqe_tail_;
+    memset(sqe, 0, sizeof(*sqe));
+    return sqe;
+}
+
+unsigned IoUring::FlushSq() {
+    unsigned tail = *sq_tail_;
+    unsigned count = sqe_tail_ - sqe_head_;
+    while (sqe_head_ != sqe_tail_) {
+        sq_array_[tail & *sq_mask_] = sqe_head_ & *sq_mask_;
+        ++tail, ++sqe_head_;
+    }
+    __atomic_store_n(sq_tail_, tail, __ATOMIC_RELEASE);
+    return count;
+}
+
+int IoUring::Enter(unsigned to_submit, unsigned min_complete, unsigned flags,
+                   const void* arg, size_t arg_size) {
+    return static_cast<int>(
+        syscall(__NR_io_uring_enter, fd_, to_submit, min_complete, flags,
+                arg, arg_size));
+}
+
+int IoUring::Submit(unsigned wait_nr) {
+    unsigned to_submit = FlushSq();
+    if (to_submit == 0 && wait_nr == 0) return 0;
+    return Enter(to_submit, wait_nr, wait_nr ? IORING_ENTER_GETEVENTS : 0,
+                 nullptr, 0);
+}
+
+int IoUring::SubmitAndWait(unsigned wait_nr, int64_t timeout_ns) {
+    unsigned to_submit = FlushSq();
+
+    struct __kernel_timespec ts;
+    ts.tv_sec = timeout_ns / 1000000000;
+    ts.tv_nsec = timeout_ns % 1000000000;
+
+    struct io_uring_getevents_arg arg;
+    memset(&arg, 0, sizeof(arg));
+    arg.sigmask_sz = _NSIG / 8;
+    arg.ts = reinterpret_cast<uint64_t>(&ts);
+
+    return Enter(to_submit, wait_nr,
+                 IORING_ENTER_GETEVENTS | IORING_ENTER_EXT_ARG,
+                 &arg, sizeof(arg));
+}
+
+struct io_uring_cqe* IoUring::PeekCqe() {
+    unsigned head = *cq_head_;
+    if (head == __atomic_load_n(cq_tail_, __ATOMIC_ACQUIRE))
+        return nullptr;
+    return &cqes_[head & *cq_mask_];
+}
+
+void IoUring::SeenCqe() {
+    __atomic_store_n(cq_head_, *cq_head_ + 1, __ATOMIC_RELEASE);
+}
+
+struct io_uring_cqe* IoUring::WaitCqe() {
+    for ( ; ; ) {
+        struct io_uring_cqe* cqe = PeekCqe();
+        if (cqe) return cqe;
+        if (Enter(0, 1, IORING_ENTER_GETEVENTS, nullptr, 0) < 0)
+            return nullptr;
+    }
+}
+
+} // namespace common
+} // namespace thrill
+
+#endif // THRILL_HAVE_IO_URING
+
+/******************************************************************************/
@@ -0,0 +1,123 @@
+/*******************************************************************************
+ * thrill/common/io_uring.hpp
+ *
+ * Minimal wrapper around a Linux io_uring submission and completion queue pair,
+ * using the raw system calls.
+ *
+ * Part of Project Thrill - http://project-thrill.org
+ *
+ * Copyright (C) 2016 Timo Bingmann <tb@panthema.net>
+ *
+ * All rights reserved. Published under the BSD-2 license in the LICENSE file.
+ ******************************************************************************/
+
+#pragma once
+#ifndef THRILL_COMMON_IO_URING_HEADER
+#define THRILL_COMMON_IO_URING_HEADER
+
+#include <thrill/common/config.hpp>
+
+#if THRILL_HAVE_IO_URING
+
+#include <linux/io_uring.h>
+
+#include <cstddef>
+#include <cstdint>
+
+namespace thrill {
+namespace common {
+
+/*!
+ * IoUring is a minimal wrapper around a Linux io_uring instance, which maps the
+ * submission and completion rings and calls io_uring_enter() directly, without
+ * liburing.
+ *
+ * The submission side (GetSqe(), Submit()) and the completion side (PeekCqe(),
+ * SeenCqe(), WaitCqe()) may each be used by one thread, hence a producer and a
+ * consumer thread may share one IoUring without locking.
+ */
+class IoUring
+{
+public:
+    //! Set up an io_uring with at least entries submission queue entries.
+    //! Throws a common::ErrnoException if the kernel does not support it.
+    explicit IoUring(unsigned entries);
+
+    //! non-copyable: delete copy-constructor
+    IoUring(const IoUring&) = delete;
+    //! non-copyable: delete assignment operator
+    IoUring& operator = (const IoUring&) = delete;
+
+    ~IoUring();
+
+    //! Returns a cleared submission queue entry, or nullptr if the submission
+    //! queue is full. The entry is passed to the kernel by the next Submit().
+    struct io_uring_sqe * GetSqe();
+
+    //! Pass all prepared entries to the kernel, and wait for wait_nr
+    //! completions. Returns number of entries submitted or -1 and errno.
+    int Submit(unsigned wait_nr = 0);
+
+    //! Like Submit(), but wait at most timeout_ns nanoseconds for wait_nr
+    //! completions. Returns -1 and errno = ETIME on timeout.
+    int SubmitAndWait(unsigned wait_nr, int64_t timeout_ns);
+
+    //! Returns the next completion queue entry, or nullptr if there is none.
+    struct io_uring_cqe * PeekCqe();
+
+    //! Mark the completion queue entry returned by PeekCqe() as consumed.
+    void SeenCqe();
+
+    //! Waits until a completion queue entry is available and returns it.
+    //! Returns nullptr and errno if interrupted.
+    struct io_uring_cqe * WaitCqe();
+
+    //! number of submission queue entries
+    unsigned sq_entries() const { return sq_entries_; }
+
+    //! number of prepared but not yet submitted entries
+    unsigned sq_pending() const { return sqe_tail_ - sqe_head_; }
+
+    //! whether the kernel supports a timeout argument to io_uring_enter()
+    bool has_ext_arg() const { return (features_ & IORING_FEAT_EXT_ARG) != 0; }
+
+private:
+    //! io_uring file descriptor
+    int fd_ = -1;
+
+    //! features reported by the kernel
+    uint32_t features_ = 0;
+
+    //! mapped submission ring, completion ring, and submission entries
+    void* sq_ring_ = nullptr, * cq_ring_ = nullptr;
+    size_t sq_ring_size_ = 0, cq_ring_size_ = 0;
+    struct io_uring_sqe* sqes_ = nullptr;
+    size_t sqes_size_ = 0;
+
+    //! pointers into the submission ring
+    unsigned* sq_head_, * sq_tail_, * sq_mask_, * sq_array_;
+    unsigned sq_entries_;
+
+    //! pointers into the completion ring
+    unsigned* cq_head_, * cq_tail_, * cq_mask_;
+    struct io_uring_cqe* cqes_;
+
+    //! local range of prepared submission entries
+    unsigned sqe_head_ = 0, sqe_tail_ = 0;
+
+    //! publish prepared submission entries to the kernel, returns their number
+    unsigned FlushSq();
+
+    //! call io_uring_enter()
+    int Enter(unsigned to_submit, unsigned min_complete, unsigned flags,
+              const void* arg, size_t arg_size);
+};
+
+} // namespace common
+} // namespace thrill
+
+#endif // THRILL_HAVE_IO_URING
+
+#endif // !THRILL_COMMON_IO_URING_HEADER
+
+/******************************************************************************/
@@ -19,6 +19,7 @@
 #include <cassert>
 #include <cstddef>
 #include <functional>
+#include <iterator>
 #include <list>
 #include <memory>
 #include <stdexcept>
@@ -142,6 +143,19 @@ public:
         map_[key] = list_.begin();
     }
 
+    //! put or replace item at the back of the LRU cache, such that it is the
+    //! next item returned by pop().
+    void put_back(const Key& key) {
+        typename Map::iterator it = map_.find(key);
+        if (it != map_.end()) {
+            list_.erase(it->second);
+            map_.erase(it);
+        }
+
+        list_.push_back(key);
+        map_[key] = std::prev(list_.end());
+    }
+
     //! touch value from LRU cache for key.
     void touch(const Key& key) {
         typename Map::iterator it = map_.find(key);
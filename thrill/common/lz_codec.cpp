@@ -0,0 +1,226 @@
+/*******************************************************************************
+ * thrill/common/lz_codec.cpp
+ *
+ * Fast LZ77 byte compression using the sequence format of LZ4 blocks.
+ *
+ * Part of Project Thrill - http://project-thrill.org
+ *
+ * Copyright (C) 2016 Timo Bingmann <tb@panthema.net>
+ *
+ * All rights reserved. Published under the BSD-2 license in the LICENSE file.
+ ******************************************************************************/
+
+#include <thrill/common/lz_codec.hpp>
+
+#include <cstdint>
+#include <cstring>
+
+namespace thrill {
+namespace common {
+
+//! minimum length of a back-reference
+static constexpr size_t kMinMatch = 4;
+
+//! maximum distance of a back-reference
+static constexpr size_t kMaxOffset = 65535;
+
+//! the last match must start at least 12 bytes before the end, and the last 5
+//! bytes are always literals, which lets decoders copy in words.
+static constexpr size_t kMatchStartLimit = 12;
+static constexpr size_t kLastLiterals = 5;
+
+//! number of bits of the hash table, which maps four byte prefixes to their
+//! last position.
+static constexpr unsigned kHashBits = 12;
+
+static inline uint32_t Read32(const uint8_t* p) {
+    uint32_t v;
+    memcpy(&v, p, sizeof(v));
+    return v;
+}
+
+static inline uint64_t Read64(const uint8_t* p) {
+    uint64_t v;
+    memcpy(&v, p, sizeof(v));
+    return v;
+}
+
+static inline uint32_t Hash32(uint32_t v) {
+    return (v * 2654435761u) >> (32 - kHashBits);
+}
+
+//! append extension bytes of a literal or match length
+static inline void PutLength(uint8_t*& op, size_t len) {
+    while (len >= 255) {
+        *op++ = 255;
+        len -= 255;
+    }
+    *op++ = static_cast<uint8_t>(len);
+}
+
+//! append a literal run and a back-reference, or only the literal run if
+//! match_len is zero.
+static inline bool PutSequence(
+    uint8_t*& op, const uint8_t* oend,
+    const uint8_t* literals, size_t lit_len, size_t offset, size_t match_len) {
+
+    // worst case space of the whole sequence
+    size_t need = 1 + lit_len / 255 + 1 + lit_len;
+    if (match_len) need += 2 + (match_len - kMinMatch) / 255 + 1;
+    if (static_cast<size_t>(oend - op) < need)
+        return false;
+
+    uint8_t* token = op++;
+    *token = static_cast<uint8_t>((lit_len < 15 ? lit_len : 15) << 4);
+    if (lit_len >= 15) PutLength(op, lit_len - 15);
+
+    memcpy(op, literals, lit_len);
+    op += lit_len;
+
+    if (match_len == 0) return true;
+
+    *op++ = static_cast<uint8_t>(offset);
+    *op++ = static_cast<uint8_t>(offset >> 8);
+
+    size_t code = match_len - kMinMatch;
+    *token |= static_cast<uint8_t>(code < 15 ? code : 15);
+    if (code >= 15) PutLength(op, code - 15);
+
+    return true;
+}
+
+size_t LzCompress(const void* src, size_t size,
+                  void* dst, size_t dst_capacity) {
+
+    const uint8_t* in = static_cast<const uint8_t*>(src);
+    uint8_t* const obegin = static_cast<uint8_t*>(dst);
+    uint8_t* op = obegin;
+    const uint8_t* const oend = obegin + dst_capacity;
+
+    size_t anchor = 0;
+
+    if (size > kMatchStartLimit)
+    {
+        uint32_t table[size_t(1) << kHashBits];
+        memset(table, 0, sizeof(table));
+
+        const size_t limit = size - kMatchStartLimit;
+        const size_t match_end = size - kLastLiterals;
+
+        size_t ip = 0;
+        while (ip < limit)
+        {
+            uint32_t v = Read32(in + ip);
+            uint32_t& slot = table[Hash32(v)];
+            size_t ref = slot;
+            slot = static_cast<uint32_t>(ip);
+
+            if (ref >= ip || ip - ref > kMaxOffset || Read32(in + ref) != v) {
+                // skip faster through incompressible data
+                ip += 1 + ((ip - anchor) >> 6);
+                continue;
+            }
+
+            // extend match backwards into the pending literals
+            while (ip > anchor && ref > 0 && in[ip - 1] == in[ref - 1])
+                --ip, --ref;
+
+            // extend match forwards, first word-wise then byte-wise
+            size_t len = kMinMatch;
+            while (ip + len + 8 <= match_end &&
+                   Read64(in + ip + len) == Read64(in + ref + len))
+                len += 8;
+            while (ip + len < match_end && in[ip + len] == in[ref + len])
+                ++len;
+
+            if (!PutSequence(op, oend, in + anchor, ip - anchor,
+                             ip - ref, len))
+                return 0;
+
+            ip += len;
+            anchor = ip;
+
+            if (ip < limit)
+                table[Hash32(Read32(in + ip - 2))] =
+                    static_cast<uint32_t>(ip - 2);
+        }
+    }
+
+    // last literals
+    if (!PutSequence(op, oend, in + anchor, size - anchor, 0, 0))
+        return 0;
+
+    return static_cast<size_t>(op - obegin);
+}
+
+//! read extension bytes of a literal or match length
+static inline bool GetLength(
+    const uint8_t*& ip, const uint8_t* iend, size_t& len) {
+    uint8_t b;
+    do {
+        if (ip >= iend) return false;
+        b = *ip++;
+        len += b;
+    } while (b == 255);
+    return true;
+}
+
+bool LzDecompress(const void* src, size_t size, void* dst, size_t dst_size) {
+
+    const uint8_t* ip = static_cast<const uint8_t*>(src);
+    const uint8_t* const iend = ip + size;
+    uint8_t* const obegin = static_cast<uint8_t*>(dst);
+    uint8_t* op = obegin;
+    uint8_t* const oend = obegin + dst_size;
+
+    while (ip < iend)
+    {
+        unsigned token = *ip++;
+
+        size_t lit_len = token >> 4;
+        if (lit_len == 15 && !GetLength(ip, iend, lit_len))
+            return false;
+
+        if (lit_len > static_cast<size_t>(iend - ip) ||
+            lit_len > static_cast<size_t>(oend - op))
+            return false;
+
+        memcpy(op, ip, lit_len);
+        op += lit_len, ip += lit_len;
+
+        // the last sequence has no back-reference
+        if (ip == iend) break;
+
+        if (iend - ip < 2) return false;
+        size_t offset = ip[0] | (static_cast<size_t>(ip[1]) << 8);
+        ip += 2;
+
+        if (offset == 0 || offset > static_cast<size_t>(op - obegin))
+            return false;
+
+        size_t match_len = token & 15;
+        if (match_len == 15 && !GetLength(ip, iend, match_len))
+            return false;
+        match_len += kMinMatch;
+
+        if (match_len > static_cast<size_t>(oend - op))
+            return false;
+
+        const uint8_t* ref = op - offset;
+        if (offset >= match_len) {
+            memcpy(op, ref, match_len);
+            op += match_len;
+        }
+        else {
+            // overlapping copy repeats the last offset bytes
+            for (uint8_t* end = op + match_len; op != end; ) *op++ = *ref++;
+        }
+    }
+
+    return op == oend;
+}
+
+} // namespace common
+} // namespace thrill
+
+/******************************************************************************/
@@ -0,0 +1,48 @@
+/*******************************************************************************
+ * thrill/common/lz_codec.hpp
+ *
+ * Fast LZ77 byte compression using the sequence format of LZ4 blocks.
+ *
+ * Part of Project Thrill - http://project-thrill.org
+ *
+ * Copyright (C) 2016 Timo Bingmann <tb@panthema.net>
+ *
+ * All rights reserved. Published under the BSD-2 license in the LICENSE file.
+ ******************************************************************************/
+
+#pragma once
+#ifndef THRILL_COMMON_LZ_CODEC_HEADER
+#define THRILL_COMMON_LZ_CODEC_HEADER
+
+#include <cstddef>
+
+namespace thrill {
+namespace common {
+
+/*!
+ * Compress size bytes from src into at most dst_capacity bytes at dst using a
+ * greedy single-probe LZ77 matcher, which favors speed over compression ratio.
+ * The output is a sequence of LZ4 block sequences: literal runs followed by
+ * back-references of at least four bytes into the last 64 KiB.
+ *
+ * \return size of compressed data, or zero if it does not fit into
+ * dst_capacity bytes, in which case dst contains garbage.
+ */
+size_t LzCompress(const void* src, size_t size,
+                  void* dst, size_t dst_capacity);
+
+/*!
+ * Decompress size bytes from src created by LzCompress() into exactly
+ * dst_size bytes at dst. All references are checked, hence corrupted input
+ * cannot write outside of dst.
+ *
+ * \return true if src decoded to exactly dst_size bytes.
+ */
+bool LzDecompress(const void* src, size_t size, void* dst, size_t dst_size);
+
+} // namespace common
+} // namespace thrill
+
+#endif // !THRILL_COMMON_LZ_CODEC_HEADER
+
+/******************************************************************************/
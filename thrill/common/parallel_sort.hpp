@@ -0,0 +1,203 @@
+/*******************************************************************************
+ * thrill/common/parallel_sort.hpp
+ *
+ * A simple parallel super-scalar sample sort for in-memory runs: the input is
+ * classified into one bucket per thread using a sorted splitter array, and the
+ * buckets are then sorted independently. Requires n items of extra memory.
+ *
+ * Part of Project Thrill - http://project-thrill.org
+ *
+ * Copyright (C) 2016 Timo Bingmann <tb@panthema.net>
+ *
+ * All rights reserved. Published under the BSD-2 license in the LICENSE file.
+ ******************************************************************************/
+
+#pragma once
+#ifndef THRILL_COMMON_PARALLEL_SORT_HEADER
+#define THRILL_COMMON_PARALLEL_SORT_HEADER
+
+#include <thrill/common/logger.hpp>
+#include <thrill/common/porting.hpp>
+
+#include <algorithm>
+#include <atomic>
+#include <cassert>
+#include <functional>
+#include <iterator>
+#include <memory>
+#include <new>
+#include <random>
+#include <thread>
+#include <vector>
+
+namespace thrill {
+namespace common {
+
+/*!
+ * Process-wide number of threads currently running inside parallel sorts. A
+ * parallel sort which is not given a fixed number of threads borrows all
+ * hardware threads not currently used by other parallel sorts, hence a
+ * straggler worker sorting its last run gets the cores of already idle local
+ * workers.
+ */
+static inline std::atomic<size_t>& parallel_sort_busy_threads() {
+    static std::atomic<size_t> busy_threads { 0 };
+    return busy_threads;
+}
+
+/*!
+ * Run function(thread_id) in num_threads threads, the calling thread executes
+ * thread_id 0.
+ */
+template <typename Function>
+static inline
+void parallel_sort_run(size_t num_threads, const Function& function) {
+    std::vector<std::thread> threads;
+    threads.reserve(num_threads - 1);
+    for (size_t t = 1; t < num_threads; ++t)
+        threads.emplace_back(CreateThread([&function, t]() { function(t); }));
+    function(0);
+    for (std::thread& thread : threads)
+        thread.join();
+}
+
+/*!
+ * Sort [begin,end) using a parallel super-scalar sample sort with num_threads
+ * threads. If num_threads is zero, all hardware threads not currently used by
+ * other parallel sorts in this process are used. Small inputs are sorted
+ * sequentially with std::sort.
+ */
+template <typename Iterator,
+          typename Comparator =
+              std::less<typename std::iterator_traits<Iterator>::value_type> >
+static inline
+void parallel_sample_sort(Iterator begin, Iterator end,
+                          const Comparator& cmp = Comparator(),
+                          size_t num_threads = 0) {
+
+    static constexpr bool debug = false;
+
+    using value_type = typename std::iterator_traits<Iterator>::value_type;
+
+    //! minimum number of items per thread to warrant parallel sorting
+    static constexpr size_t min_items_per_thread = 16384;
+
+    //! oversampling factor for splitter selection
+    static constexpr size_t oversampling = 16;
+
+    const size_t size = end - begin;
+
+    // borrow threads
+    std::atomic<size_t>& busy_threads = parallel_sort_busy_threads();
+    size_t busy = busy_threads.fetch_add(1);
+
+    if (num_threads == 0) {
+        size_t hw_threads = std::thread::hardware_concurrency();
+        num_threads = hw_threads > busy ? hw_threads - busy : 1;
+    }
+    num_threads = std::max<size_t>(
+        1, std::min(num_threads, size / min_items_per_thread));
+
+    if (num_threads <= 1) {
+        busy_threads.fetch_sub(1);
+        return std::sort(begin, end, cmp);
+    }
+
+    busy_threads.fetch_add(num_threads - 1);
+
+    sLOG << "parallel_sample_sort() size" << size
+         << "num_threads" << num_threads;
+
+    // number of buckets is equal to the number of threads
+    const size_t num_buckets = num_threads;
+
+    // draw random sample and select splitters
+    std::vector<value_type> splitters;
+    {
+        std::default_random_engine rng(std::random_device { } ());
+        std::vector<value_type> samples;
+        samples.reserve(oversampling * num_buckets);
+        for (size_t i = 0; i < oversampling * num_buckets; ++i)
+            samples.push_back(begin[rng() % size]);
+        std::sort(samples.begin(), samples.end(), cmp);
+
+        splitters.reserve(num_buckets - 1);
+        for (size_t i = 1; i < num_buckets; ++i)
+            splitters.push_back(samples[i * oversampling]);
+    }
+
+    // bucket of each item, and counts of bucket items for each input chunk
+    std::vector<uint32_t> bucket_of(size);
+    std::vector<size_t> bkt_count(num_threads * num_buckets, 0);
+
+    auto chunk_begin = [size, num_threads](size_t t) {
+                           return size * t / num_threads;
+                       };
+
+    parallel_sort_run(
+        num_threads, [&](size_t t) {
+            size_t* count = bkt_count.data() + t * num_buckets;
+            for (size_t i = chunk_begin(t); i < chunk_begin(t + 1); ++i) {
+                size_t b = std::upper_bound(
+                    splitters.begin(), splitters.end(), begin[i], cmp)
+                           - splitters.begin();
+                bucket_of[i] = static_cast<uint32_t>(b);
+                ++count[b];
+            }
+        });
+
+    // calculate exclusive prefix sum over buckets in chunk order, then
+    // bkt_count[t * num_buckets + b] is the output offset of chunk t in bucket
+    // b, and bkt_begin[b] is the start of bucket b.
+    std::vector<size_t> bkt_begin(num_buckets + 1);
+    {
+        size_t sum = 0;
+        for (size_t b = 0; b < num_buckets; ++b) {
+            bkt_begin[b] = sum;
+            for (size_t t = 0; t < num_threads; ++t) {
+                size_t c = bkt_count[t * num_buckets + b];
+                bkt_count[t * num_buckets + b] = sum;
+                sum += c;
+            }
+        }
+        bkt_begin[num_buckets] = sum;
+        assert(sum == size);
+    }
+
+    // distribute items into uninitialized buffer by move construction.
+    value_type* buffer = static_cast<value_type*>(
+        ::operator new (size * sizeof(value_type)));
+
+    parallel_sort_run(
+        num_threads, [&](size_t t) {
+            size_t* offset = bkt_count.data() + t * num_buckets;
+            for (size_t i = chunk_begin(t); i < chunk_begin(t + 1); ++i) {
+                new (buffer + offset[bucket_of[i]]++)
+                value_type(std::move(begin[i]));
+            }
+        });
+
+    std::vector<uint32_t>().swap(bucket_of);
+
+    // sort buckets and move them back into the input range
+    parallel_sort_run(
+        num_threads, [&](size_t b) {
+            value_type* bbegin = buffer + bkt_begin[b];
+            value_type* bend = buffer + bkt_begin[b + 1];
+            std::sort(bbegin, bend, cmp);
+            std::move(bbegin, bend, begin + bkt_begin[b]);
+            for (value_type* it = bbegin; it != bend; ++it)
+                it->~value_type();
+        });
+
+    ::operator delete (buffer);
+
+    busy_threads.fetch_sub(num_threads);
+}
+
+} // namespace common
+} // namespace thrill
+
+#endif // !THRILL_COMMON_PARALLEL_SORT_HEADER
+
+/******************************************************************************/
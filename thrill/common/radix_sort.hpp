@@ -19,25 +19,38 @@
 #include <thrill/common/logger.hpp>
 
 #include <algorithm>
+#include <array>
+#include <cstdint>
 #include <functional>
 #include <type_traits>
 
 namespace thrill {
 namespace common {
 
+/*!
+ * Character extractor for radix_sort_CI(), which calls the at_radix(depth)
+ * method of items.
+ */
+class RadixCharAtRadix
+{
+public:
+    template <typename Type>
+    auto operator () (const Type& t, size_t depth) const {
+        return t.at_radix(depth);
+    }
+};
+
 /*!
  * Internal helper method, use radix_sort_CI below.
  */
 template <
     size_t MaxDepth, typename Iterator, typename Char,
-    typename Comparator =
-        std::less<typename std::iterator_traits<Iterator>::value_type>,
-    typename SubSorter = NoOperation<void> >
+    typename Comparator, typename SubSorter, typename CharExtractor>
 static inline
 void radix_sort_CI(Iterator begin, Iterator end, size_t K,
                    const Comparator& cmp,
                    const SubSorter& sub_sort, size_t depth,
-                   Char* char_cache) {
+                   Char* char_cache, const CharExtractor& char_at) {
 
     const size_t size = end - begin;
     if (size < 32)
@@ -48,7 +61,7 @@ void radix_sort_CI(Iterator begin, Iterator end, size_t K,
     // cache characters
     Char* cc = char_cache;
     for (Iterator it = begin; it != end; ++it, ++cc) {
-        *cc = it->at_radix(depth);
+        *cc = char_at(*it, depth);
         assert(*cc < K);
     }
 
@@ -97,7 +110,7 @@ void radix_sort_CI(Iterator begin, Iterator end, size_t K,
             if (bkt_size[i] <= 1) continue;
             radix_sort_CI<MaxDepth>(
                 begin + bsum, begin + bsum + bkt_size[i],
-                K, cmp, sub_sort, depth + 1, char_cache);
+                K, cmp, sub_sort, depth + 1, char_cache, char_at);
         }
     }
 }
@@ -134,10 +147,107 @@ void radix_sort_CI(Iterator begin, Iterator end, size_t K,
     // allocate character cache once
     Char* char_cache = new Char[size];
     radix_sort_CI<MaxDepth>(
-        begin, end, K, cmp, sub_sort, /* depth */ 0, char_cache);
+        begin, end, K, cmp, sub_sort, /* depth */ 0, char_cache,
+        RadixCharAtRadix());
+    delete[] char_cache;
+}
+
+/*!
+ * Radix sort the iterator range [begin,end) by 8-bit characters extracted from
+ * items using char_at(item, depth). Sort unconditionally up to depth MaxDepth,
+ * then call the sub_sort method for further sorting. Small buckets are sorted
+ * using std::sort() with given comparator, which must be consistent with the
+ * character order.
+ */
+template <
+    size_t MaxDepth, typename Iterator, typename CharExtractor,
+    typename Comparator =
+        std::less<typename std::iterator_traits<Iterator>::value_type>,
+    typename SubSorter = NoOperation<void> >
+static inline
+void radix_sort_key_CI(Iterator begin, Iterator end,
+                       const CharExtractor& char_at,
+                       const Comparator& cmp = Comparator(),
+                       const SubSorter& sub_sort = SubSorter()) {
+
+    if (MaxDepth == 0) {
+        // allow post-radix sorting when max depth is reached
+        sub_sort(begin, end, cmp);
+        return;
+    }
+
+    const size_t size = end - begin;
+
+    // allocate character cache once
+    uint8_t* char_cache = new uint8_t[size];
+    radix_sort_CI<MaxDepth>(
+        begin, end, /* K */ 256, cmp, sub_sort, /* depth */ 0, char_cache,
+        char_at);
     delete[] char_cache;
 }
 
+/*!
+ * Traits class mapping sort keys to big-endian 8-bit radix characters and a
+ * 64-bit prefix, both consistent with std::less on the key. Defined for
+ * integral types and fixed-length byte strings std::array<uint8_t, N>.
+ */
+template <typename Key, typename Enable = void>
+class RadixKeyTraits;
+
+template <typename Key>
+class RadixKeyTraits<
+        Key, typename std::enable_if<std::is_integral<Key>::value>::type>
+{
+public:
+    using Unsigned = typename std::make_unsigned<Key>::type;
+
+    //! number of 8-bit characters in the key
+    static constexpr size_t key_bytes = sizeof(Key);
+
+    //! map key to unsigned integer with same order: flip sign bit if signed.
+    static Unsigned ToUnsigned(const Key& key) {
+        return std::is_signed<Key>::value
+               ? static_cast<Unsigned>(key)
+               ^ (Unsigned(1) << (8 * sizeof(Key) - 1))
+               : static_cast<Unsigned>(key);
+    }
+
+    //! 8-bit character at depth, most significant first.
+    static uint8_t Char(const Key& key, size_t depth) {
+        return static_cast<uint8_t>(
+            ToUnsigned(key) >> (8 * (key_bytes - 1 - depth)));
+    }
+
+    //! 64-bit prefix of the key, the most significant bits are aligned.
+    static uint64_t Prefix(const Key& key) {
+        return static_cast<uint64_t>(ToUnsigned(key))
+               << (64 - 8 * key_bytes);
+    }
+};
+
+template <size_t N>
+class RadixKeyTraits<std::array<uint8_t, N> >
+{
+public:
+    using Key = std::array<uint8_t, N>;
+
+    //! number of 8-bit characters in the key
+    static constexpr size_t key_bytes = N;
+
+    //! 8-bit character at depth
+    static uint8_t Char(const Key& key, size_t depth) {
+        return key[depth];
+    }
+
+    //! 64-bit prefix of the key: the first eight characters in big-endian.
+    static uint64_t Prefix(const Key& key) {
+        uint64_t prefix = 0;
+        for (size_t i = 0; i < 8; ++i)
+            prefix = (prefix << 8) | (i < N ? key[i] : 0);
+        return prefix;
+    }
+};
+
 /*!
  * SortAlgorithm class for use with api::Sort() which calls radix_sort_CI() if K
  * is small enough.
@@ -61,6 +61,15 @@ public:
         return --value_;
     }
 
+    //! function decrements the semaphore if it is > 0 without blocking, and
+    //! returns whether it did.
+    bool try_wait() {
+        std::unique_lock<std::mutex> lock(mutex_);
+        if (value_ <= 0) return false;
+        --value_;
+        return true;
+    }
+
     //! return the current value -- should only be used for debugging.
     size_t value() const { return value_; }
 
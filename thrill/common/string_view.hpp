@@ -194,6 +194,33 @@ void SplitView(
     callback(StringView(last, it));
 }
 
+/*!
+ * Split the given FastString at each separator character into distinct
+ * substrings, and call the given callback for each substring. Multiple
+ * consecutive separators are considered individually and will result in empty
+ * split substrings.
+ *
+ * \param str       string to split
+ * \param sep       separator character
+ * \param callback  callback taking a StringView of the substring
+ */
+template <typename F>
+static inline
+void SplitView(const FastString& str, char sep, F&& callback) {
+
+    const char* it = str.begin(), * last = it;
+
+    for ( ; it != str.end(); ++it)
+    {
+        if (*it == sep)
+        {
+            callback(StringView(last, it - last));
+            last = it + 1;
+        }
+    }
+    callback(StringView(last, it - last));
+}
+
 } // namespace common
 } // namespace thrill
 
@@ -0,0 +1,95 @@
+/*******************************************************************************
+ * thrill/core/count_min_sketch.hpp
+ *
+ * Count-Min sketch for estimating key frequencies in a stream, used to detect
+ * heavy hitter keys.
+ *
+ * Part of Project Thrill - http://project-thrill.org
+ *
+ * Copyright (C) 2016 Timo Bingmann <tb@panthema.net>
+ *
+ * All rights reserved. Published under the BSD-2 license in the LICENSE file.
+ ******************************************************************************/
+
+#pragma once
+#ifndef THRILL_CORE_COUNT_MIN_SKETCH_HEADER
+#define THRILL_CORE_COUNT_MIN_SKETCH_HEADER
+
+#include <thrill/core/reduce_functional.hpp>
+
+#include <algorithm>
+#include <cassert>
+#include <functional>
+#include <limits>
+#include <vector>
+
+namespace thrill {
+namespace core {
+
+/*!
+ * A Count-Min sketch with depth rows of width counters. Each key increments
+ * one counter in each row, selected by a row-salted hash. The estimated count
+ * of a key is the minimum of its counters, which never underestimates the
+ * true count, and overestimates it by at most e/width * total() with
+ * probability 1 - exp(-depth).
+ */
+template <typename Key, typename HashFunction = std::hash<Key> >
+class CountMinSketch
+{
+public:
+    explicit CountMinSketch(size_t width = 1024, size_t depth = 4,
+                            const HashFunction& hash_function = HashFunction())
+        : width_(width), depth_(depth),
+          counters_(width * depth, 0),
+          hash_function_(hash_function) {
+        assert(width_ > 0 && depth_ > 0);
+    }
+
+    //! increment the counters of key and return its new estimated count
+    size_t Insert(const Key& key) {
+        const uint64_t hash = hash_function_(key);
+        size_t estimate = std::numeric_limits<size_t>::max();
+        for (size_t r = 0; r < depth_; ++r) {
+            size_t& c = counters_[r * width_ + Index(hash, r)];
+            estimate = std::min(estimate, ++c);
+        }
+        ++total_;
+        return estimate;
+    }
+
+    //! return estimated count of key
+    size_t Estimate(const Key& key) const {
+        const uint64_t hash = hash_function_(key);
+        size_t estimate = std::numeric_limits<size_t>::max();
+        for (size_t r = 0; r < depth_; ++r)
+            estimate = std::min(estimate, counters_[r * width_ + Index(hash, r)]);
+        return estimate;
+    }
+
+    //! total number of inserted keys
+    size_t total() const { return total_; }
+
+private:
+    //! number of counters per row
+    size_t width_;
+    //! number of rows
+    size_t depth_;
+    //! depth_ rows of width_ counters
+    std::vector<size_t> counters_;
+    //! total number of inserted keys
+    size_t total_ = 0;
+    //! hash function for keys
+    HashFunction hash_function_;
+
+    //! counter index of hash in row r
+    size_t Index(uint64_t hash, size_t r) const {
+        return Hash128to64(r + 1, hash) % width_;
+    }
+};
+
+} // namespace core
+} // namespace thrill
+
+#endif // !THRILL_CORE_COUNT_MIN_SKETCH_HEADER
+
+/******************************************************************************/
@@ -13,7 +13,9 @@
 #include <thrill/common/string.hpp>
 #include <thrill/common/system_exception.hpp>
 #include <thrill/core/file_io.hpp>
+#include <thrill/core/gzip.hpp>
 #include <thrill/core/simple_glob.hpp>
+#include <thrill/io/syscall_file.hpp>
 
 #include <fcntl.h>
 #include <sys/stat.h>
@@ -22,6 +24,7 @@
 
 #include <dirent.h>
 #include <glob.h>
+#include <sys/mman.h>
 #include <sys/wait.h>
 #include <unistd.h>
 
@@ -130,6 +133,7 @@ SysFileList GlobFileSizePrefixSum(const std::vector<std::string>& files) {
     struct stat filestat;
     uint64_t total_size = 0;
     bool contains_compressed = false;
+    bool contains_unsplittable = false;
 
     for (const std::string& file : files) {
 
@@ -139,11 +143,17 @@ SysFileList GlobFileSizePrefixSum(const std::vector<std::string>& files) {
         }
         if (!S_ISREG(filestat.st_mode)) continue;
 
-        contains_compressed = contains_compressed || IsCompressed(file);
+        bool is_compressed = IsCompressed(file);
+        bool is_bgzf = common::EndsWith(file, ".gz") && IsBgzfFile(file);
+
+        contains_compressed = contains_compressed || is_compressed;
+        contains_unsplittable =
+            contains_unsplittable || (is_compressed && !is_bgzf);
 
         file_info.emplace_back(
             SysFileInfo { std::move(file),
-                          static_cast<uint64_t>(filestat.st_size), total_size });
+                          static_cast<uint64_t>(filestat.st_size), total_size,
+                          is_bgzf });
 
         total_size += filestat.st_size;
     }
@@ -151,16 +161,21 @@ SysFileList GlobFileSizePrefixSum(const std::vector<std::string>& files) {
     // sentinel entry
     file_info.emplace_back(
         SysFileInfo { std::string(),
-                      static_cast<uint64_t>(0), total_size });
+                      static_cast<uint64_t>(0), total_size, false });
 
     return SysFileList {
-               std::move(file_info), total_size, contains_compressed
+               std::move(file_info), total_size,
+               contains_compressed, contains_unsplittable
     };
 }
 
 /******************************************************************************/
 
 void SysFile::close() {
+    if (gzip_) {
+        delete gzip_;
+        gzip_ = nullptr;
+    }
     if (fd_ >= 0) {
         sLOG << "SysFile::close(): fd" << fd_;
         if (::close(fd_) != 0)
@@ -219,7 +234,14 @@ SysFile SysFile::OpenForRead(const std::string& path) {
 
     const char* decompressor;
 
-    if (common::EndsWith(path, ".gz")) {
+    if (common::EndsWith(path, ".gz") && HaveZlib()) {
+        common::PortSetCloseOnExec(fd);
+
+        sLOG << "SysFile::OpenForRead(): gzip filefd" << fd;
+
+        return SysFile(fd, 0, new GzipReader(fd));
+    }
+    else if (common::EndsWith(path, ".gz")) {
         decompressor = "gzip";
     }
     else if (common::EndsWith(path, ".bz2")) {
@@ -290,6 +312,10 @@ SysFile SysFile::OpenForRead(const std::string& path) {
 #endif
 }
 
+ssize_t SysFile::read_gzip(void* data, size_t count) {
+    return gzip_->read(data, count);
+}
+
 SysFile SysFile::OpenForWrite(const std::string& path) {
 
     // first create the file and see if we can write it at all.
@@ -374,6 +400,95 @@ SysFile SysFile::OpenForWrite(const std::string& path) {
 #endif
 }
 
+/******************************************************************************/
+// ReadAheadFile
+
+bool default_read_mmap = false;
+
+void ReadAheadFile::open(const std::string& path, size_t size, size_t offset,
+                         size_t block_size, bool use_mmap) {
+    close();
+
+    size_ = size;
+    pos_ = offset;
+    block_size_ = block_size;
+
+#if !defined(_MSC_VER)
+    if (use_mmap && size_ != 0) {
+        int fd = ::open(path.c_str(), O_RDONLY | O_BINARY, 0);
+        if (fd < 0) {
+            throw common::ErrnoException("Cannot open file " + path);
+        }
+
+        void* addr = ::mmap(nullptr, size_, PROT_READ, MAP_PRIVATE, fd, 0);
+        ::close(fd);
+        if (addr == MAP_FAILED) {
+            throw common::ErrnoException("Cannot mmap file " + path);
+        }
+        ::madvise(addr, size_, MADV_SEQUENTIAL);
+
+        sLOG << "ReadAheadFile::open(): mapped" << path << "size" << size_;
+
+        map_ = static_cast<unsigned char*>(addr);
+        return;
+    }
+#else
+    common::UNUSED(use_mmap);
+#endif
+
+    file_ = io::FileBasePtr(
+        new io::SyscallFile(path, io::FileBase::RDONLY | io::FileBase::NO_LOCK));
+
+    front_.resize(block_size_);
+    back_.resize(block_size_);
+    issue();
+}
+
+void ReadAheadFile::issue() {
+    if (pos_ >= size_) return;
+
+    back_size_ = std::min(block_size_, size_ - pos_);
+    request_ = file_->aread(back_.data(), pos_, back_size_);
+    pos_ += back_size_;
+}
+
+size_t ReadAheadFile::read(const unsigned char** data) {
+    if (map_) {
+        size_t bytes = pos_ < size_ ? std::min(block_size_, size_ - pos_) : 0;
+        *data = map_ + std::min(pos_, size_);
+        pos_ += bytes;
+        return bytes;
+    }
+
+    *data = front_.data();
+    if (!request_) return 0;
+
+    request_->wait();
+    request_.reset();
+
+    std::swap(front_, back_);
+    size_t bytes = back_size_;
+    *data = front_.data();
+
+    // start reading the next block while this one is processed
+    issue();
+    return bytes;
+}
+
+void ReadAheadFile::close() {
+    if (request_) {
+        request_->wait();
+        request_.reset();
+    }
+    file_.reset();
+#if !defined(_MSC_VER)
+    if (map_) {
+        ::munmap(map_, size_);
+        map_ = nullptr;
+    }
+#endif
+}
+
 /******************************************************************************/
 
 #if defined(_MSC_VER)
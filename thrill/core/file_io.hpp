@@ -16,6 +16,8 @@
 #include <thrill/common/logger.hpp>
 #include <thrill/common/porting.hpp>
 #include <thrill/common/system_exception.hpp>
+#include <thrill/io/file_base.hpp>
+#include <thrill/io/request.hpp>
 
 #if defined(_MSC_VER)
 
@@ -34,6 +36,12 @@
 namespace thrill {
 namespace core {
 
+class GzipReader;
+
+//! whether ReadAheadFile maps uncompressed input files into memory instead of
+//! reading them asynchronously, set via THRILL_READ_MMAP.
+extern bool default_read_mmap;
+
 //! function which takes pathbase and replaces $$$ with worker and ### with
 //! the file_part values.
 std::string FillFilePattern(const std::string& pathbase,
@@ -60,6 +68,9 @@ struct SysFileInfo {
     uint64_t    size;
     //! exclusive prefix sum of file sizes.
     uint64_t    size_ex_psum;
+    //! if the file is compressed in the blocked gzip format (BGZF), which
+    //! can be split at block boundaries.
+    bool        is_bgzf;
 
     //! inclusive prefix sum of file sizes.
     uint64_t    size_inc_psum() const { return size_ex_psum + size; }
@@ -80,6 +91,9 @@ struct SysFileList {
 
     //! whether the list contains a compressed file.
     bool                     contains_compressed;
+
+    //! whether the list contains a compressed file which cannot be split.
+    bool                     contains_unsplittable;
 };
 
 /*!
@@ -109,7 +123,7 @@ public:
     /*!
      * Open file for reading and return file descriptor. Handles compressed
      * files by calling a decompressor in a pipe, like "cat $f | gzip -dc |" in
-     * bash.
+     * bash. Gzip files are decompressed in-process if zlib is available.
      *
      * \param path Path to open
      */
@@ -129,14 +143,14 @@ public:
     SysFile& operator = (const SysFile&) = delete;
     //! move-constructor
     SysFile(SysFile&& f) noexcept
-        : fd_(f.fd_), pid_(f.pid_) {
-        f.fd_ = -1, f.pid_ = 0;
+        : fd_(f.fd_), pid_(f.pid_), gzip_(f.gzip_) {
+        f.fd_ = -1, f.pid_ = 0, f.gzip_ = nullptr;
     }
     //! move-assignment
     SysFile& operator = (SysFile&& f) {
         close();
-        fd_ = f.fd_, pid_ = f.pid_;
-        f.fd_ = -1, f.pid_ = 0;
+        fd_ = f.fd_, pid_ = f.pid_, gzip_ = f.gzip_;
+        f.fd_ = -1, f.pid_ = 0, f.gzip_ = nullptr;
         return *this;
     }
 
@@ -153,6 +167,7 @@ public:
     //! POSIX read function.
     ssize_t read(void* data, size_t count) {
         assert(fd_ >= 0);
+        if (gzip_) return read_gzip(data, count);
 #if defined(_MSC_VER)
         return ::_read(fd_, data, static_cast<unsigned>(count));
 #else
@@ -175,8 +190,8 @@ public:
 
 private:
     //! private constructor: use OpenForRead or OpenForWrite.
-    explicit SysFile(int fd, int pid = 0) noexcept
-        : fd_(fd), pid_(pid) { }
+    explicit SysFile(int fd, int pid = 0, GzipReader* gzip = nullptr) noexcept
+        : fd_(fd), pid_(pid), gzip_(gzip) { }
 
     //! file descriptor
     int fd_ = -1;
@@ -187,6 +202,80 @@ private:
 
     //! pid of child process to wait for
     pid_t pid_ = 0;
+
+    //! in-process decompressor of gzip files reading from fd_
+    GzipReader* gzip_ = nullptr;
+
+    //! read decompressed data via gzip_
+    ssize_t read_gzip(void* data, size_t count);
+};
+
+/*!
+ * Reads a range of an uncompressed file sequentially in blocks. By default the
+ * next block is read asynchronously via the io:: request queues while the
+ * current one is processed. Alternatively the file is mapped into memory with
+ * madvise(MADV_SEQUENTIAL), and blocks are returned as views into the mapping.
+ */
+class ReadAheadFile
+{
+    static constexpr bool debug = false;
+
+public:
+    ReadAheadFile() = default;
+
+    //! non-copyable: delete copy-constructor
+    ReadAheadFile(const ReadAheadFile&) = delete;
+    //! non-copyable: delete assignment operator
+    ReadAheadFile& operator = (const ReadAheadFile&) = delete;
+
+    ~ReadAheadFile() {
+        close();
+    }
+
+    /*!
+     * Open file for reading blocks of block_size, starting at offset.
+     *
+     * \param path Path to open
+     * \param size Size of the file
+     * \param offset Position of the first block
+     * \param block_size Size of the blocks returned by read()
+     * \param use_mmap Map the file into memory instead of reading it.
+     */
+    void open(const std::string& path, size_t size, size_t offset,
+              size_t block_size, bool use_mmap = default_read_mmap);
+
+    /*!
+     * Returns the next block of the file in [*data, *data + size), which is
+     * valid until the next call to read() or close(). Returns zero at the end
+     * of the file.
+     */
+    size_t read(const unsigned char** data);
+
+    //! wait for outstanding reads and release the file
+    void close();
+
+private:
+    //! issue an asynchronous read of the next block into back_
+    void issue();
+
+    //! file handle for asynchronous reads
+    io::FileBasePtr file_;
+    //! outstanding read into back_
+    io::RequestPtr request_;
+    //! block returned by read() and block being read asynchronously
+    std::vector<unsigned char> front_, back_;
+    //! size of the block being read into back_
+    size_t back_size_ = 0;
+
+    //! mapping of the whole file, if mmap is used
+    unsigned char* map_ = nullptr;
+
+    //! size of the file
+    size_t size_ = 0;
+    //! position of the next block to read or issue
+    size_t pos_ = 0;
+    //! size of blocks
+    size_t block_size_ = 0;
 };
 
 /*!
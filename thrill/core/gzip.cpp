@@ -0,0 +1,373 @@
+/*******************************************************************************
+ * thrill/core/gzip.cpp
+ *
+ * In-process gzip decompression via zlib, and the blocked gzip format (BGZF),
+ * which can be split at block boundaries.
+ *
+ * Part of Project Thrill - http://project-thrill.org
+ *
+ * Copyright (C) 2016 Timo Bingmann <tb@panthema.net>
+ *
+ * All rights reserved. Published under the BSD-2 license in the LICENSE file.
+ ******************************************************************************/
+
+#include <thrill/common/logger.hpp>
+#include <thrill/common/system_exception.hpp>
+#include <thrill/core/gzip.hpp>
+
+#if !defined(_MSC_VER)
+#include <unistd.h>
+#endif
+
+#if THRILL_HAVE_ZLIB
+#include <zlib.h>
+#endif
+
+#include <algorithm>
+#include <cassert>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <string>
+
+namespace thrill {
+namespace core {
+
+/******************************************************************************/
+// BGZF Block Format
+
+//! gzip member header with FEXTRA flag and the six byte "BC" extra field
+//! containing the block size minus one in the last two bytes.
+static const unsigned char bgzf_header[bgzf_header_size] = {
+    0x1F, 0x8B, 0x08, 0x04, 0x00, 0x00, 0x00, 0x00, 0x00, 0xFF,
+    0x06, 0x00, 0x42, 0x43, 0x02, 0x00, 0x00, 0x00
+};
+
+//! check the fixed bytes of a BGZF block header, ignoring MTIME, XFL and OS.
+static inline bool IsBgzfHeader(const unsigned char* p) {
+    return p[0] == 0x1F && p[1] == 0x8B && p[2] == 0x08 && p[3] == 0x04 &&
+           std::memcmp(p + 10, bgzf_header + 10, 6) == 0;
+}
+
+//! total size of the BGZF block with header at p
+static inline size_t BgzfBlockSize(const unsigned char* p) {
+    return (static_cast<size_t>(p[16]) | (static_cast<size_t>(p[17]) << 8)) + 1;
+}
+
+static inline uint32_t Load32LE(const unsigned char* p) {
+    return static_cast<uint32_t>(p[0]) | (static_cast<uint32_t>(p[1]) << 8) |
+           (static_cast<uint32_t>(p[2]) << 16) |
+           (static_cast<uint32_t>(p[3]) << 24);
+}
+
+static inline void Store32LE(unsigned char* p, uint32_t v) {
+    p[0] = static_cast<unsigned char>(v);
+    p[1] = static_cast<unsigned char>(v >> 8);
+    p[2] = static_cast<unsigned char>(v >> 16);
+    p[3] = static_cast<unsigned char>(v >> 24);
+}
+
+bool HaveZlib() {
+#if THRILL_HAVE_ZLIB
+    return true;
+#else
+    return false;
+#endif
+}
+
+bool IsBgzfFile(const std::string& path) {
+    if (!HaveZlib()) return false;
+
+    std::ifstream in(path, std::ios::binary);
+    char header[bgzf_header_size];
+    in.read(header, bgzf_header_size);
+
+    return in.gcount() == static_cast<std::streamsize>(bgzf_header_size) &&
+           IsBgzfHeader(reinterpret_cast<unsigned char*>(header));
+}
+
+#if THRILL_HAVE_ZLIB
+
+size_t BgzfCompress(const void* src, size_t size,
+                    void* dst, size_t dst_capacity, int level) {
+    assert(size <= bgzf_max_input_size);
+
+    size_t overhead = bgzf_header_size + bgzf_trailer_size;
+    if (dst_capacity < overhead) return 0;
+
+    unsigned char* out = static_cast<unsigned char*>(dst);
+    dst_capacity = std::min(dst_capacity, bgzf_max_block_size);
+
+    // compress raw deflate stream without zlib or gzip wrapper
+    z_stream zs;
+    std::memset(&zs, 0, sizeof(zs));
+    if (deflateInit2(&zs, level, Z_DEFLATED, -15, 8,
+                     Z_DEFAULT_STRATEGY) != Z_OK) {
+        throw common::SystemException("BgzfCompress: deflateInit2 failed");
+    }
+
+    zs.next_in = static_cast<Bytef*>(const_cast<void*>(src));
+    zs.avail_in = static_cast<uInt>(size);
+    zs.next_out = out + bgzf_header_size;
+    zs.avail_out = static_cast<uInt>(dst_capacity - overhead);
+
+    int ret = deflate(&zs, Z_FINISH);
+    size_t csize = zs.total_out;
+    deflateEnd(&zs);
+
+    if (ret != Z_STREAM_END) return 0;
+
+    size_t block_size = csize + overhead;
+    std::copy(bgzf_header, bgzf_header + bgzf_header_size, out);
+    out[16] = static_cast<unsigned char>(block_size - 1);
+    out[17] = static_cast<unsigned char>((block_size - 1) >> 8);
+
+    unsigned char* trailer = out + bgzf_header_size + csize;
+    Store32LE(trailer, static_cast<uint32_t>(
+                  crc32(0, static_cast<const Bytef*>(src),
+                        static_cast<uInt>(size))));
+    Store32LE(trailer + 4, static_cast<uint32_t>(size));
+
+    return block_size;
+}
+
+/******************************************************************************/
+// GzipReader
+
+struct GzipReader::Data {
+    z_stream zs;
+};
+
+GzipReader::GzipReader(int fd)
+    : fd_(fd), in_(64 * 1024), d_(new Data) {
+    std::memset(&d_->zs, 0, sizeof(d_->zs));
+    // 15 + 16: window of 32 KiB, expect gzip header
+    if (inflateInit2(&d_->zs, 15 + 16) != Z_OK) {
+        throw common::SystemException("GzipReader: inflateInit2 failed");
+    }
+}
+
+GzipReader::~GzipReader() {
+    inflateEnd(&d_->zs);
+}
+
+ssize_t GzipReader::read(void* data, size_t count) {
+    z_stream& zs = d_->zs;
+
+    zs.next_out = static_cast<Bytef*>(data);
+    zs.avail_out = static_cast<uInt>(count);
+
+    while (zs.avail_out == count && count != 0) {
+        if (zs.avail_in == 0) {
+#if defined(_MSC_VER)
+            ssize_t r = ::_read(fd_, in_.data(),
+                                static_cast<unsigned>(in_.size()));
+#else
+            ssize_t r = ::read(fd_, in_.data(), in_.size());
+#endif
+            if (r < 0) return -1;
+            if (r == 0) {
+                if (in_member_) {
+                    throw common::SystemException(
+                              "GzipReader: unexpected end of gzip stream");
+                }
+                break;
+            }
+            zs.next_in = in_.data();
+            zs.avail_in = static_cast<uInt>(r);
+        }
+
+        in_member_ = true;
+        int ret = inflate(&zs, Z_NO_FLUSH);
+        if (ret == Z_STREAM_END) {
+            // continue with the next member of concatenated gzip files
+            in_member_ = false;
+            inflateReset(&zs);
+        }
+        else if (ret != Z_OK && ret != Z_BUF_ERROR) {
+            throw common::SystemException(
+                      std::string("GzipReader: corrupted gzip stream: ")
+                      + (zs.msg ? zs.msg : "unknown error"));
+        }
+    }
+
+    return count - zs.avail_out;
+}
+
+/******************************************************************************/
+// BgzfReader
+
+struct BgzfReader::Data {
+    z_stream zs;
+};
+
+BgzfReader::BgzfReader()
+    : d_(new Data) {
+    std::memset(&d_->zs, 0, sizeof(d_->zs));
+    // negative window bits: raw deflate stream, BGZF headers are parsed here.
+    if (inflateInit2(&d_->zs, -15) != Z_OK) {
+        throw common::SystemException("BgzfReader: inflateInit2 failed");
+    }
+}
+
+BgzfReader::~BgzfReader() {
+    inflateEnd(&d_->zs);
+}
+
+void BgzfReader::open(const std::string& path, size_t size, size_t offset,
+                      size_t read_size) {
+    path_ = path;
+    size_ = size;
+    offset_ = offset;
+    in_.clear();
+    in_pos_ = 0;
+    out_.resize(bgzf_max_block_size);
+
+    file_.open(path, size, offset, read_size);
+
+    if (offset == 0) return;
+
+    // scan for the next block boundary, which is at most one block ahead.
+    size_t begin = offset;
+    while (fill(bgzf_header_size) && !at_block_start()) {
+        if (offset_ - begin >= bgzf_max_block_size) {
+            throw common::SystemException(
+                      "BgzfReader: no BGZF block found in " + path);
+        }
+        ++in_pos_, ++offset_;
+    }
+    // the offset is in the last block: drop its tail
+    if (in_.size() - in_pos_ < bgzf_header_size)
+        in_pos_ = in_.size();
+
+    sLOG << "BgzfReader::open() path" << path << "offset" << begin
+         << "first block at" << offset_;
+}
+
+bool BgzfReader::fill(size_t n) {
+    while (in_.size() - in_pos_ < n) {
+        const unsigned char* data;
+        size_t bytes = file_.read(&data);
+        if (bytes == 0) return false;
+
+        // move unconsumed data to the front and append the new block
+        in_.erase(in_.begin(), in_.begin() + in_pos_);
+        in_pos_ = 0;
+        in_.insert(in_.end(), data, data + bytes);
+    }
+    return true;
+}
+
+bool BgzfReader::at_block_start() {
+    if (!IsBgzfHeader(in_.data() + in_pos_)) return false;
+
+    size_t block_size = BgzfBlockSize(in_.data() + in_pos_);
+    if (block_size < bgzf_header_size + bgzf_trailer_size) return false;
+
+    // the block must end exactly at the end of the file or the next block.
+    if (!fill(block_size + bgzf_header_size))
+        return offset_ + block_size == size_;
+
+    return IsBgzfHeader(in_.data() + in_pos_ + block_size);
+}
+
+size_t BgzfReader::read(const unsigned char** data, size_t* offset) {
+    z_stream& zs = d_->zs;
+    *data = out_.data();
+
+    while (fill(bgzf_header_size)) {
+        const unsigned char* block = in_.data() + in_pos_;
+        size_t block_size = BgzfBlockSize(block);
+
+        if (!IsBgzfHeader(block) ||
+            block_size < bgzf_header_size + bgzf_trailer_size) {
+            throw common::SystemException(
+                      "BgzfReader: invalid BGZF block header in " + path_
+                      + " at offset " + std::to_string(offset_));
+        }
+        if (!fill(block_size)) {
+            throw common::SystemException(
+                      "BgzfReader: truncated BGZF block in " + path_);
+        }
+        block = in_.data() + in_pos_;
+
+        const unsigned char* trailer = block + block_size - bgzf_trailer_size;
+        uint32_t crc = Load32LE(trailer);
+        size_t out_size = Load32LE(trailer + 4);
+
+        inflateReset(&zs);
+        zs.next_in = const_cast<Bytef*>(block + bgzf_header_size);
+        zs.avail_in = static_cast<uInt>(
+            block_size - bgzf_header_size - bgzf_trailer_size);
+        zs.next_out = out_.data();
+        zs.avail_out = static_cast<uInt>(out_.size());
+
+        if (inflate(&zs, Z_FINISH) != Z_STREAM_END ||
+            zs.total_out != out_size ||
+            crc32(0, out_.data(), static_cast<uInt>(out_size)) != crc) {
+            throw common::SystemException(
+                      "BgzfReader: corrupted BGZF block in " + path_
+                      + " at offset " + std::to_string(offset_));
+        }
+
+        *offset = offset_;
+        in_pos_ += block_size;
+        offset_ += block_size;
+
+        // skip empty blocks, like the end of file marker.
+        if (out_size != 0)
+            return out_size;
+    }
+
+    if (in_pos_ != in_.size()) {
+        throw common::SystemException(
+                  "BgzfReader: truncated BGZF block in " + path_);
+    }
+    return 0;
+}
+
+void BgzfReader::close() {
+    file_.close();
+}
+
+#else // !THRILL_HAVE_ZLIB
+
+size_t BgzfCompress(const void*, size_t, void*, size_t, int) {
+    throw common::SystemException("BgzfCompress: compiled without zlib");
+}
+
+struct GzipReader::Data { };
+
+GzipReader::GzipReader(int fd)
+    : fd_(fd) {
+    throw common::SystemException("GzipReader: compiled without zlib");
+}
+
+GzipReader::~GzipReader() { }
+
+ssize_t GzipReader::read(void*, size_t) {
+    return -1;
+}
+
+struct BgzfReader::Data { };
+
+BgzfReader::BgzfReader() { }
+
+BgzfReader::~BgzfReader() { }
+
+void BgzfReader::open(const std::string&, size_t, size_t, size_t) {
+    throw common::SystemException("BgzfReader: compiled without zlib");
+}
+
+size_t BgzfReader::read(const unsigned char**, size_t*) {
+    return 0;
+}
+
+void BgzfReader::close() { }
+
+#endif // !THRILL_HAVE_ZLIB
+
+} // namespace core
+} // namespace thrill
+
+/******************************************************************************/
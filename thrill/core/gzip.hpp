@@ -0,0 +1,178 @@
+/*******************************************************************************
+ * thrill/core/gzip.hpp
+ *
+ * In-process gzip decompression via zlib, and the blocked gzip format (BGZF),
+ * which can be split at block boundaries.
+ *
+ * Part of Project Thrill - http://project-thrill.org
+ *
+ * Copyright (C) 2016 Timo Bingmann <tb@panthema.net>
+ *
+ * All rights reserved. Published under the BSD-2 license in the LICENSE file.
+ ******************************************************************************/
+
+#pragma once
+#ifndef THRILL_CORE_GZIP_HEADER
+#define THRILL_CORE_GZIP_HEADER
+
+#include <thrill/core/file_io.hpp>
+
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace thrill {
+namespace core {
+
+// BGZF files are gzip files consisting of a series of gzip members, each
+// compressing at most 64 KiB and carrying its compressed size in a "BC" extra
+// field. Hence any gzip decompressor can read them, and readers can seek to
+// block boundaries. The file is terminated by an empty block.
+
+//! size of the header of a BGZF block
+static constexpr size_t bgzf_header_size = 18;
+//! size of the CRC32 and ISIZE trailer of a BGZF block
+static constexpr size_t bgzf_trailer_size = 8;
+//! maximum size of a compressed BGZF block
+static constexpr size_t bgzf_max_block_size = 0x10000;
+//! maximum uncompressed size of a BGZF block, such that it fits compressed.
+static constexpr size_t bgzf_max_input_size = 0xFF00;
+
+//! whether zlib is available for in-process (de)compression of gzip files.
+bool HaveZlib();
+
+//! Returns true if the file at path starts with a BGZF block header and can be
+//! read by BgzfReader.
+bool IsBgzfFile(const std::string& path);
+
+/*!
+ * Compress size bytes from src, which must be at most bgzf_max_input_size, into
+ * one BGZF block of at most dst_capacity bytes at dst using the given zlib
+ * compression level.
+ *
+ * \return size of the BGZF block, or zero if it does not fit into dst_capacity
+ * bytes.
+ */
+size_t BgzfCompress(const void* src, size_t size,
+                    void* dst, size_t dst_capacity, int level = 6);
+
+/*!
+ * Decompresses a stream of gzip members from a file descriptor in-process
+ * using zlib, replacing a forked "gzip -d" for SysFile.
+ */
+class GzipReader
+{
+public:
+    //! decompress from the file descriptor fd, which remains owned by caller.
+    explicit GzipReader(int fd);
+
+    //! non-copyable: delete copy-constructor
+    GzipReader(const GzipReader&) = delete;
+    //! non-copyable: delete assignment operator
+    GzipReader& operator = (const GzipReader&) = delete;
+
+    ~GzipReader();
+
+    //! read up to count decompressed bytes into data, returns zero at the end
+    //! of the stream and -1 on read errors of the file descriptor.
+    ssize_t read(void* data, size_t count);
+
+private:
+    //! file descriptor of compressed data
+    int fd_;
+
+    //! buffer of compressed data
+    std::vector<unsigned char> in_;
+
+    //! whether a gzip member was started but not finished
+    bool in_member_ = false;
+
+    //! pimpl data struct with zlib stream
+    struct Data;
+
+    //! pimpl data struct with zlib stream
+    std::unique_ptr<Data> d_;
+};
+
+/*!
+ * Reads a BGZF file sequentially block-wise, starting at the first block at or
+ * after a given offset, which allows splitting BGZF files among workers by
+ * ranges of compressed bytes. Each block is decompressed in-process and
+ * delivered together with the file offset of its compressed block. Compressed
+ * data is read ahead asynchronously via ReadAheadFile.
+ */
+class BgzfReader
+{
+    static constexpr bool debug = false;
+
+public:
+    BgzfReader();
+
+    //! non-copyable: delete copy-constructor
+    BgzfReader(const BgzfReader&) = delete;
+    //! non-copyable: delete assignment operator
+    BgzfReader& operator = (const BgzfReader&) = delete;
+
+    ~BgzfReader();
+
+    /*!
+     * Open BGZF file and seek to the first block at or after offset.
+     *
+     * \param path Path to open
+     * \param size Size of the file
+     * \param offset Offset in the compressed file to seek to
+     * \param read_size Size of compressed blocks read from the file
+     */
+    void open(const std::string& path, size_t size, size_t offset,
+              size_t read_size);
+
+    /*!
+     * Decompresses the next non-empty BGZF block into [*data, *data + size),
+     * which is valid until the next call to read() or close(), and sets
+     * *offset to the file offset of the compressed block. Returns zero at the
+     * end of the file.
+     */
+    size_t read(const unsigned char** data, size_t* offset);
+
+    //! release the file
+    void close();
+
+private:
+    //! read ahead file of compressed data
+    ReadAheadFile file_;
+    //! path of file for error messages
+    std::string path_;
+    //! size of the file
+    size_t size_ = 0;
+
+    //! buffer of compressed data from file_, consumed up to in_pos_
+    std::vector<unsigned char> in_;
+    //! position of unconsumed data in in_
+    size_t in_pos_ = 0;
+    //! file offset of in_[in_pos_]
+    size_t offset_ = 0;
+
+    //! buffer for decompressed block
+    std::vector<unsigned char> out_;
+
+    //! pimpl data struct with zlib stream
+    struct Data;
+
+    //! pimpl data struct with zlib stream
+    std::unique_ptr<Data> d_;
+
+    //! ensure that at least n unconsumed bytes are in in_, returns false if
+    //! the file ends earlier.
+    bool fill(size_t n);
+
+    //! check whether a BGZF block starts at in_pos_ by also checking that the
+    //! next block follows it.
+    bool at_block_start();
+};
+
+} // namespace core
+} // namespace thrill
+
+#endif // !THRILL_CORE_GZIP_HEADER
+
+/******************************************************************************/
@@ -19,9 +19,11 @@
 #include <thrill/api/context.hpp>
 #include <thrill/common/logger.hpp>
 #include <thrill/core/reduce_bucket_hash_table.hpp>
+#include <thrill/core/multiway_merge.hpp>
 #include <thrill/core/reduce_functional.hpp>
 #include <thrill/core/reduce_old_probing_hash_table.hpp>
 #include <thrill/core/reduce_probing_hash_table.hpp>
+#include <thrill/core/reduce_tagged_probing_hash_table.hpp>
 #include <thrill/data/file.hpp>
 
 #include <algorithm>
@@ -179,8 +181,11 @@ public:
 
         assert(consume && "Items were spilled hence Flushing must consume");
 
-        // if partially reduce files remain, create new hash tables to process
-        // them iteratively.
+        // if partially reduce files remain, re-reduce them with subtables
+        // whose fan-out is chosen from the number of spilled items, such that
+        // the subtable's spilled partitions are expected to fit into RAM in
+        // the next iteration. Files which cannot be handled this way are
+        // reduced via external sorting.
 
         size_t iteration = 1;
 
@@ -193,27 +198,39 @@ public:
 
             std::vector<data::File> next_remaining_files;
 
-            Table subtable(
-                table_.ctx(), table_.dia_id(),
-                table_.key_extractor(), table_.reduce_function(), emitter_,
-                /* num_partitions */ 32, config_, /* immediate_flush */ false,
-                IndexFunction(iteration, table_.index_function()),
-                table_.equal_to_function());
-
-            subtable.Initialize(table_.limit_memory_bytes());
-
             size_t num_subfile = 0;
 
             for (data::File& file : remaining_files)
             {
-                // insert all items from the partially reduced file
+                size_t fan_out = ReReduceFanOut(file.num_items());
+
                 sLOG << "re-reducing subfile" << num_subfile++
-                     << "containing" << file.num_items() << "items";
+                     << "containing" << file.num_items() << "items"
+                     << "with fan-out" << fan_out;
+
+                // files which were already re-reduced should fit into RAM, if
+                // they do not, the data is heavily skewed.
+                if (fan_out > max_fan_out() || (iteration > 1 && fan_out > 1)) {
+                    SortReduceFile<DoCache>(file, writer);
+                    continue;
+                }
+
+                Table subtable(
+                    table_.ctx(), table_.dia_id(),
+                    table_.key_extractor(), table_.reduce_function(), emitter_,
+                    fan_out, config_, /* immediate_flush */ false,
+                    IndexFunction(iteration, table_.index_function()),
+                    table_.equal_to_function());
 
-                data::File::ConsumeReader reader = file.GetConsumeReader();
+                subtable.Initialize(table_.limit_memory_bytes());
 
-                while (reader.HasNext()) {
-                    subtable.Insert(reader.Next<KeyValuePair>());
+                {
+                    // insert all items from the partially reduced file
+                    data::File::ConsumeReader reader = file.GetConsumeReader();
+
+                    while (reader.HasNext()) {
+                        subtable.Insert(reader.Next<KeyValuePair>());
+                    }
                 }
 
                 // after insertion, flush fully reduced partitions and save
@@ -301,6 +318,136 @@ public:
     //! \}
 
 private:
+    //! \name Re-Reducing Spilled Items
+    //! \{
+
+    //! pair of a key's hash and the key/value pair, sorted by the external
+    //! sorting fallback.
+    using HashKeyValuePair = std::pair<size_t, KeyValuePair>;
+
+    //! minimum expected number of items in a partition of a re-reduce
+    //! subtable, smaller partitions would spill many tiny blocks.
+    static constexpr size_t min_partition_items_ = 4096;
+
+    //! number of items a table with limit_memory_bytes holds before spilling
+    double TableCapacity() const {
+        return static_cast<double>(table_.limit_memory_bytes())
+               * config_.limit_partition_fill_rate()
+               / static_cast<double>(sizeof(KeyValuePair));
+    }
+
+    //! Number of partitions of a subtable re-reducing num_items spilled items:
+    //! one if all of them are expected to fit into the subtable, otherwise
+    //! enough partitions such that each spilled partition is expected to fit
+    //! into RAM in the next iteration, with a slack of two for hash variance.
+    size_t ReReduceFanOut(size_t num_items) const {
+        return std::max<size_t>(
+            1, static_cast<size_t>(
+                std::ceil(2.0 * static_cast<double>(num_items)
+                          / TableCapacity())));
+    }
+
+    //! Maximum number of partitions of a subtable
+    size_t max_fan_out() const {
+        return std::max<size_t>(
+            2, static_cast<size_t>(TableCapacity() / min_partition_items_));
+    }
+
+    //! Reduce the items in a spilled file by sorting them by the hash of their
+    //! keys: sorted runs which fit into RAM are reduced and written to Files,
+    //! which are then merged, reduced again, and emitted. Hence each item is
+    //! read twice, regardless of the file's size.
+    template <bool DoCache>
+    void SortReduceFile(data::File& file, data::File::Writer* writer) {
+
+        const size_t run_items = std::max<size_t>(
+            1, table_.limit_memory_bytes() / 2 / sizeof(HashKeyValuePair));
+
+        sLOG << "ReducePostPhase: sorting" << file.num_items()
+             << "spilled items in runs of" << run_items << "items";
+
+        auto hash_less =
+            [](const HashKeyValuePair& a, const HashKeyValuePair& b) {
+                return a.first < b.first;
+            };
+
+        std::vector<data::File> runs;
+        {
+            data::File::ConsumeReader reader = file.GetConsumeReader();
+            std::vector<HashKeyValuePair> run;
+            std::vector<HashKeyValuePair> group;
+
+            while (reader.HasNext()) {
+                run.clear();
+                while (reader.HasNext() && run.size() < run_items) {
+                    KeyValuePair kv = reader.Next<KeyValuePair>();
+                    size_t hash = table_.index_function()(
+                        kv.first, 1, 0, 0).remaining_hash;
+                    run.emplace_back(hash, std::move(kv));
+                }
+
+                std::sort(run.begin(), run.end(), hash_less);
+
+                runs.emplace_back(table_.ctx().GetFile(table_.dia_id()));
+                data::File::Writer run_writer = runs.back().GetWriter();
+
+                auto put = [&run_writer](const HashKeyValuePair& p) {
+                               run_writer.Put(p);
+                           };
+                for (HashKeyValuePair& p : run)
+                    AddToHashGroup(group, std::move(p), put);
+                FlushHashGroup(group, put);
+            }
+        }
+
+        std::vector<data::File::ConsumeReader> seq;
+        seq.reserve(runs.size());
+        for (data::File& run : runs)
+            seq.emplace_back(run.GetConsumeReader());
+
+        auto puller = make_multiway_merge_tree<HashKeyValuePair>(
+            seq.begin(), seq.end(), hash_less);
+
+        auto emit = [this, writer](const HashKeyValuePair& p) {
+                        if (DoCache) writer->Put(p.second);
+                        emitter_.Emit(p.second);
+                    };
+
+        std::vector<HashKeyValuePair> group;
+        while (puller.HasNext())
+            AddToHashGroup(group, puller.Next(), emit);
+        FlushHashGroup(group, emit);
+    }
+
+    //! Add an item to the group of items with equal hash, reducing it with an
+    //! item of equal key. If the item's hash differs, the group is flushed
+    //! first.
+    template <typename Emit>
+    void AddToHashGroup(std::vector<HashKeyValuePair>& group,
+                        HashKeyValuePair&& p, Emit& emit) {
+        if (!group.empty() && group.front().first != p.first)
+            FlushHashGroup(group, emit);
+
+        for (HashKeyValuePair& g : group) {
+            if (table_.equal_to_function()(g.second.first, p.second.first)) {
+                g.second.second = table_.reduce_function()(
+                    g.second.second, p.second.second);
+                return;
+            }
+        }
+        group.emplace_back(std::move(p));
+    }
+
+    //! Emit and clear the group of items with equal hash.
+    template <typename Emit>
+    void FlushHashGroup(std::vector<HashKeyValuePair>& group, Emit& emit) {
+        for (const HashKeyValuePair& g : group)
+            emit(g);
+        group.clear();
+    }
+
+    //! \}
+
     //! Stored reduce config to initialize the subtable.
     ReduceConfig config_;
 
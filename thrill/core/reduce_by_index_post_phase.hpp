@@ -19,6 +19,7 @@
 #include <thrill/core/reduce_bucket_hash_table.hpp>
 #include <thrill/core/reduce_functional.hpp>
 #include <thrill/core/reduce_probing_hash_table.hpp>
+#include <thrill/core/reduce_tagged_probing_hash_table.hpp>
 #include <thrill/data/file.hpp>
 
 #include <algorithm>
@@ -54,6 +54,13 @@ public:
         size_t local_index(size_t size) const {
             return remaining_hash % size;
         }
+
+        //! seven hash bits independent of the local index, used as tag byte
+        //! by ReduceTaggedProbingHashTable
+        uint8_t tag() const {
+            return static_cast<uint8_t>(
+                (remaining_hash * 0x9E3779B97F4A7C15ull) >> 57);
+        }
     };
 
     explicit ReduceByHash(
@@ -106,6 +113,13 @@ public:
             return global_index % num_buckets_per_partition
                    * size / num_buckets_per_partition;
         }
+
+        //! low bits of the index, used as tag byte by
+        //! ReduceTaggedProbingHashTable. Neighbouring slots hold consecutive
+        //! indexes, hence their tags differ.
+        uint8_t tag() const {
+            return static_cast<uint8_t>(global_index & 0x7F);
+        }
     };
 
     explicit ReduceByIndex(const common::Range& range)
@@ -16,17 +16,21 @@
 #ifndef THRILL_CORE_REDUCE_PRE_PHASE_HEADER
 #define THRILL_CORE_REDUCE_PRE_PHASE_HEADER
 
+#include <thrill/common/defines.hpp>
 #include <thrill/common/logger.hpp>
+#include <thrill/core/count_min_sketch.hpp>
 #include <thrill/core/reduce_bucket_hash_table.hpp>
 #include <thrill/core/reduce_functional.hpp>
 #include <thrill/core/reduce_old_probing_hash_table.hpp>
 #include <thrill/core/reduce_probing_hash_table.hpp>
+#include <thrill/core/reduce_tagged_probing_hash_table.hpp>
 #include <thrill/data/block_writer.hpp>
 
 #include <algorithm>
 #include <cassert>
 #include <cmath>
 #include <functional>
+#include <memory>
 #include <string>
 #include <utility>
 #include <vector>
@@ -74,11 +78,40 @@ public:
     //! non-robust keys
     void Emit(const size_t& partition_id, const KeyValuePair& p) {
         assert(partition_id < writer_.size());
+        if (THRILL_UNLIKELY(sketch_ != nullptr) && IsHeavyHitter(p.first)) {
+            // send partial aggregate of heavy hitter to next spread worker
+            ++spread_items_;
+            ReducePrePhaseEmitterSwitch<KeyValuePair, VolatileKey>::Put(
+                p, (*spread_writer_)[spread_next_]);
+            if (++spread_next_ == spread_writer_->size()) spread_next_ = 0;
+            return;
+        }
         stats_[partition_id]++;
         ReducePrePhaseEmitterSwitch<KeyValuePair, VolatileKey>::Put(
             p, writer_[partition_id]);
     }
 
+    //! Enable spreading of heavy hitter keys: items of keys, whose estimated
+    //! share of all emitted items is at least ratio, are sent round-robin to
+    //! the spread_writer instead of their partition.
+    void EnableSpreading(std::vector<data::DynBlockWriter>& spread_writer,
+                         double ratio) {
+        assert(spread_writer.size() > 0);
+        spread_writer_ = &spread_writer;
+        spread_ratio_ = ratio;
+        sketch_ = std::make_unique<Sketch>();
+    }
+
+    //! Close the spread writers.
+    void CloseSpreading() {
+        if (!spread_writer_) return;
+        sLOG << "spread" << spread_items_ << "heavy hitter items of"
+             << sketch_->total();
+        for (data::DynBlockWriter& e : *spread_writer_)
+            e.Close();
+        sketch_.reset();
+    }
+
     void Flush(size_t partition_id) {
         assert(partition_id < writer_.size());
         writer_[partition_id].Flush();
@@ -99,6 +132,34 @@ public:
 
     //! Emitter stats.
     std::vector<size_t> stats_;
+
+private:
+    using Key = typename KeyValuePair::first_type;
+    using Sketch = CountMinSketch<Key>;
+
+    //! Set of emitters for spread heavy hitter items, or nullptr.
+    std::vector<data::DynBlockWriter>* spread_writer_ = nullptr;
+
+    //! Frequency sketch of emitted keys, only allocated if spreading.
+    std::unique_ptr<Sketch> sketch_;
+
+    //! Minimum estimated share of a heavy hitter key.
+    double spread_ratio_ = 1.0;
+
+    //! Next spread writer to send a heavy hitter item to.
+    size_t spread_next_ = 0;
+
+    //! Number of spread heavy hitter items.
+    size_t spread_items_ = 0;
+
+    //! count key and check whether it is a heavy hitter. A key must have been
+    //! emitted at least twice, since a single item cannot be spread.
+    bool IsHeavyHitter(const Key& key) {
+        size_t count = sketch_->Insert(key);
+        return count >= 2 &&
+               static_cast<double>(count) >=
+               spread_ratio_ * static_cast<double>(sketch_->total());
+    }
 };
 
 template <typename ValueType, typename Key, typename Value,
@@ -179,6 +240,20 @@ public:
         emit_.Flush(partition_id);
     }
 
+    //! Spread partial aggregates of heavy hitter keys round-robin over the
+    //! spread_writers, see ReducePrePhaseEmitter::EnableSpreading().
+    void EnableSpreading(std::vector<data::DynBlockWriter>& spread_writers,
+                         double ratio) {
+        emit_.EnableSpreading(spread_writers, ratio);
+    }
+
+    //! Closes the spread writers after FlushAll(). This also deallocates the
+    //! table, as no more items can be inserted.
+    void CloseSpreading() {
+        emit_.CloseSpreading();
+        table_.Dispose();
+    }
+
     //! Closes all emitter
     void CloseAll() {
         emit_.CloseAll();
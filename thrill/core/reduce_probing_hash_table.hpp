@@ -222,7 +222,7 @@ public:
             while (THRILL_UNLIKELY(
                        items_per_partition_[h.partition_id] >
                        limit_items_per_partition_[h.partition_id])) {
-                SpillPartition(h.partition_id);
+                SpillOrGrowPartition(h.partition_id);
             }
 
             return;
@@ -277,7 +277,7 @@ public:
                 << items_per_partition_[h.partition_id] << " >= "
                 << limit_items_per_partition_[h.partition_id]
                 << " among " << partition_size_[h.partition_id];
-            SpillPartition(h.partition_id);
+            SpillOrGrowPartition(h.partition_id);
         }
     }
 
@@ -332,6 +332,60 @@ public:
             = new_size * config_.limit_partition_fill_rate();
     }
 
+    /*!
+     * Grow a partition which still contains items by moving them out and
+     * reinserting them into the larger area.
+     */
+    void GrowPartitionRehash(size_t partition_id) {
+
+        KeyValuePair* pbegin =
+            items_ + partition_id * num_buckets_per_partition_;
+        KeyValuePair* pend = pbegin + partition_size_[partition_id];
+
+        std::vector<KeyValuePair> items;
+        items.reserve(items_per_partition_[partition_id]);
+
+        for (KeyValuePair* iter = pbegin; iter != pend; ++iter) {
+            if (iter->first != Key()) {
+                items.emplace_back(std::move(*iter));
+                *iter = KeyValuePair();
+            }
+        }
+
+        GrowPartition(partition_id);
+
+        pend = pbegin + partition_size_[partition_id];
+
+        for (KeyValuePair& kv : items) {
+            typename IndexFunction::Result h = index_function_(
+                kv.first, num_partitions_,
+                num_buckets_per_partition_, num_buckets_);
+
+            KeyValuePair* iter =
+                pbegin + h.local_index(partition_size_[partition_id]);
+
+            while (iter->first != Key()) {
+                if (THRILL_UNLIKELY(++iter == pend))
+                    iter = pbegin;
+            }
+            *iter = std::move(kv);
+        }
+    }
+
+    /*!
+     * Handle a partition which reached its fill limit: partitions of tables
+     * which flush immediately are flushed and then grown. Otherwise, spilled
+     * items must be read again later, hence the partition is grown in place as
+     * long as possible and only spilled when it reached its maximum size.
+     */
+    void SpillOrGrowPartition(size_t partition_id) {
+        if (!immediate_flush_ &&
+            partition_size_[partition_id] < num_buckets_per_partition_) {
+            return GrowPartitionRehash(partition_id);
+        }
+        SpillPartition(partition_id);
+    }
+
     //! \name Spilling Mechanisms to External Memory Files
     //! \{
 
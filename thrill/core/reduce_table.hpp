@@ -27,7 +27,7 @@ namespace core {
 
 //! Enum class to select a hash table implementation.
 enum class ReduceTableImpl {
-    PROBING, OLD_PROBING, BUCKET
+    PROBING, OLD_PROBING, BUCKET, TAGGED_PROBING
 };
 
 /*!
@@ -64,6 +64,17 @@ public:
     //! the pre and post phases simultaneously.
     static constexpr bool use_post_thread_ = true;
 
+    //! only for ReduceByKey: detect heavy hitter keys among the items flushed
+    //! by the pre phase, and spread their partial aggregates round-robin over
+    //! all workers instead of sending them to the key's worker. These reduce
+    //! the spread items once more and forward them to the key's worker, such
+    //! that it receives only one item per worker for each heavy hitter.
+    bool spread_heavy_hitters_ = false;
+
+    //! only for spread_heavy_hitters_: keys whose estimated share of all items
+    //! flushed by the pre phase is at least this ratio are heavy hitters.
+    double heavy_hitter_ratio_ = 0.01;
+
     //! \name Accessors
     //! \{
 
@@ -0,0 +1,592 @@
+/*******************************************************************************
+ * thrill/core/reduce_tagged_probing_hash_table.hpp
+ *
+ * Part of Project Thrill - http://project-thrill.org
+ *
+ * Copyright (C) 2016 Timo Bingmann <tb@panthema.net>
+ *
+ * All rights reserved. Published under the BSD-2 license in the LICENSE file.
+ ******************************************************************************/
+
+#pragma once
+#ifndef THRILL_CORE_REDUCE_TAGGED_PROBING_HASH_TABLE_HEADER
+#define THRILL_CORE_REDUCE_TAGGED_PROBING_HASH_TABLE_HEADER
+
+#include <thrill/common/math.hpp>
+#include <thrill/core/reduce_functional.hpp>
+#include <thrill/core/reduce_table.hpp>
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <limits>
+#include <utility>
+#include <vector>
+
+namespace thrill {
+namespace core {
+
+/*!
+ * A linear probing hash table like ReduceProbingHashTable, which additionally
+ * keeps one control byte per slot in a separate array. A control byte is
+ * either empty_tag_ or seven hash bits of the slot's key, delivered by the
+ * IndexFunction's Result::tag().
+ *
+ * Probing loads a group of 16 control bytes and compares them to the key's tag
+ * using one SSE2 instruction, resulting in a bit mask of candidate slots. Only
+ * candidate slots are compared using the equal_to_function_, and the first
+ * empty slot in the group terminates the probe sequence. Hence most
+ * unsuccessful key comparisons are avoided, and the key/value slots are only
+ * touched for likely matches.
+ *
+ * Since emptiness is stored in the control bytes, the key Key() needs no
+ * special sentinel handling, and key/value slots are only constructed when
+ * occupied.
+ *
+ * Groups never wrap around the end of a partition, slots at the end of a
+ * partition which do not fill a whole group are probed one by one.
+ *
+ * The control bytes cost an additional cache line access per insert, hence
+ * this table pays off for high limit_partition_fill_rate_ and for keys which
+ * are expensive to compare, such as strings.
+ */
+template <typename ValueType, typename Key, typename Value,
+          typename KeyExtractor, typename ReduceFunction, typename Emitter,
+          const bool VolatileKey,
+          typename ReduceConfig_,
+          typename IndexFunction,
+          typename EqualToFunction = std::equal_to<Key> >
+class ReduceTaggedProbingHashTable
+    : public ReduceTable<ValueType, Key, Value,
+                         KeyExtractor, ReduceFunction, Emitter,
+                         VolatileKey, ReduceConfig_,
+                         IndexFunction, EqualToFunction>
+{
+    using Super = ReduceTable<ValueType, Key, Value,
+                              KeyExtractor, ReduceFunction, Emitter,
+                              VolatileKey, ReduceConfig_, IndexFunction,
+                              EqualToFunction>;
+    using Super::debug;
+    static constexpr bool debug_items = false;
+
+public:
+    using KeyValuePair = std::pair<Key, Value>;
+    using ReduceConfig = ReduceConfig_;
+
+    ReduceTaggedProbingHashTable(
+        Context& ctx, size_t dia_id,
+        const KeyExtractor& key_extractor,
+        const ReduceFunction& reduce_function,
+        Emitter& emitter,
+        size_t num_partitions,
+        const ReduceConfig& config = ReduceConfig(),
+        bool immediate_flush = false,
+        const IndexFunction& index_function = IndexFunction(),
+        const EqualToFunction& equal_to_function = EqualToFunction())
+        : Super(ctx, dia_id,
+                key_extractor, reduce_function, emitter,
+                num_partitions, config, immediate_flush,
+                index_function, equal_to_function)
+    { assert(num_partitions > 0); }
+
+    //! Construct the hash table itself, and mark all control bytes as empty.
+    void Initialize(size_t limit_memory_bytes) {
+        assert(!items_);
+
+        limit_memory_bytes_ = limit_memory_bytes;
+
+        // calculate num_buckets_per_partition_ from the memory limit and the
+        // number of partitions required, initialize partition_size_ array.
+
+        assert(limit_memory_bytes_ >= 0 &&
+               "limit_memory_bytes must be greater than or equal to 0. "
+               "A byte size of zero results in exactly one item per partition");
+
+        num_buckets_per_partition_ = std::max<size_t>(
+            1,
+            (size_t)(static_cast<double>(limit_memory_bytes_)
+                     / static_cast<double>(sizeof(KeyValuePair) + 1)
+                     / static_cast<double>(num_partitions_)));
+
+        num_buckets_ = num_buckets_per_partition_ * num_partitions_;
+
+        assert(num_buckets_per_partition_ > 0);
+        assert(num_buckets_ > 0);
+
+        partition_size_.resize(
+            num_partitions_,
+            std::min(size_t(config_.initial_items_per_partition_),
+                     num_buckets_per_partition_));
+
+        // calculate limit on the number of items in a partition before these
+        // are spilled to disk or flushed to network.
+
+        double limit_fill_rate = config_.limit_partition_fill_rate();
+
+        assert(limit_fill_rate >= 0.0 && limit_fill_rate <= 1.0
+               && "limit_partition_fill_rate must be between 0.0 and 1.0. "
+               "with a fill rate of 0.0, items are immediately flushed.");
+
+        limit_items_per_partition_.resize(
+            num_partitions_,
+            static_cast<size_t>(
+                static_cast<double>(partition_size_[0]) * limit_fill_rate));
+
+        assert(limit_items_per_partition_[0] >= 0);
+
+        // allocate the slots uninitialized, they are constructed on insert.
+
+        items_ = static_cast<KeyValuePair*>(
+            operator new (num_buckets_ * sizeof(KeyValuePair)));
+
+        tags_ = static_cast<uint8_t*>(operator new (num_buckets_));
+        memset(tags_, empty_tag_, num_buckets_);
+    }
+
+    ~ReduceTaggedProbingHashTable() {
+        if (items_) Dispose();
+    }
+
+    /*!
+     * Inserts a value. Calls the key_extractor_, makes a key-value-pair and
+     * inserts the pair via the Insert() function.
+     */
+    void Insert(const Value& p) {
+        Insert(std::make_pair(key_extractor_(p), p));
+    }
+
+    /*!
+     * Inserts a value into the table, potentially reducing it in case both the
+     * key of the value already in the table and the key of the value to be
+     * inserted are the same.
+     *
+     * An insert may trigger a partial flush of the partition with the most
+     * items if the maximal number of items in the table (max_num_items_table)
+     * is reached.
+     *
+     * Alternatively, it may trigger a resize of the table in case the maximal
+     * fill ratio per partition is reached.
+     *
+     * \param kv Value to be inserted into the table.
+     */
+    void Insert(const KeyValuePair& kv) {
+
+        while (THRILL_UNLIKELY(mem::memory_exceeded && num_items_ != 0))
+            SpillAnyPartition();
+
+        typename IndexFunction::Result h = index_function_(
+            kv.first, num_partitions_,
+            num_buckets_per_partition_, num_buckets_);
+
+        assert(h.partition_id < num_partitions_);
+
+        const size_t psize = partition_size_[h.partition_id];
+        const uint8_t tag = h.tag();
+
+        // calculate local index depending on the current subtable's size
+        size_t pos = h.local_index(psize);
+
+        KeyValuePair* pitems =
+            items_ + h.partition_id * num_buckets_per_partition_;
+        uint8_t* ptags =
+            tags_ + h.partition_id * num_buckets_per_partition_;
+
+        for (size_t probed = 0; probed < psize; ) {
+
+            if (THRILL_LIKELY(pos + group_size_ <= psize)) {
+                // probe a whole group of slots
+                unsigned empty = MatchEmpty(ptags + pos);
+                unsigned match = MatchTag(ptags + pos, tag);
+
+                // only slots before the first empty one are part of the probe
+                // sequence.
+                if (empty)
+                    match &= (empty & (~empty + 1)) - 1;
+
+                while (match) {
+                    size_t i = pos + common::ffs(match) - 1;
+                    if (equal_to_function_(pitems[i].first, kv.first)) {
+                        LOGC(debug_items)
+                            << "match of key: " << kv.first
+                            << " and " << pitems[i].first << " ... reducing...";
+
+                        pitems[i].second =
+                            reduce_function_(pitems[i].second, kv.second);
+                        return;
+                    }
+                    match &= match - 1;
+                }
+
+                if (empty)
+                    return InsertAt(h.partition_id, pos + common::ffs(empty) - 1,
+                                    tag, kv);
+
+                pos += group_size_;
+                probed += group_size_;
+            }
+            else {
+                // probe single slots at the end of the partition
+                if (ptags[pos] == empty_tag_)
+                    return InsertAt(h.partition_id, pos, tag, kv);
+
+                if (ptags[pos] == tag &&
+                    equal_to_function_(pitems[pos].first, kv.first)) {
+                    pitems[pos].second =
+                        reduce_function_(pitems[pos].second, kv.second);
+                    return;
+                }
+
+                ++pos, ++probed;
+            }
+
+            // wrap around if beyond the current partition
+            if (THRILL_UNLIKELY(pos == psize))
+                pos = 0;
+        }
+
+        // flush partition and retry, if all slots are reserved
+        SpillPartition(h.partition_id);
+        return Insert(kv);
+    }
+
+    //! Deallocate items and memory
+    void Dispose() {
+        if (!items_) return;
+
+        // dispose the occupied items by destructor
+
+        for (size_t id = 0; id < num_partitions_; ++id) {
+            size_t begin = id * num_buckets_per_partition_;
+            size_t end = begin + partition_size_[id];
+
+            for (size_t i = begin; i != end; ++i) {
+                if (tags_[i] != empty_tag_)
+                    items_[i].~KeyValuePair();
+            }
+        }
+
+        operator delete (items_);
+        items_ = nullptr;
+        operator delete (tags_);
+        tags_ = nullptr;
+
+        Super::Dispose();
+    }
+
+    //! Grow a partition after a spill or flush (if possible)
+    void GrowPartition(size_t partition_id) {
+
+        if (partition_size_[partition_id] == num_buckets_per_partition_)
+            return;
+
+        size_t new_size = std::min(
+            num_buckets_per_partition_, 2 * partition_size_[partition_id]);
+
+        sLOG << "Growing partition" << partition_id
+             << "from" << partition_size_[partition_id] << "to" << new_size
+             << "limit_items" << new_size * config_.limit_partition_fill_rate();
+
+        // the new slots' control bytes are still empty since Initialize()
+
+        partition_size_[partition_id] = new_size;
+        limit_items_per_partition_[partition_id]
+            = new_size * config_.limit_partition_fill_rate();
+    }
+
+    //! \name Spilling Mechanisms to External Memory Files
+    //! \{
+
+    //! Spill all items of a partition into an external memory File.
+    void SpillPartition(size_t partition_id) {
+
+        if (immediate_flush_) {
+            return FlushPartition(
+                partition_id, /* consume */ true, /* grow */ true);
+        }
+
+        LOG << "Spilling " << items_per_partition_[partition_id]
+            << " items of partition with id: " << partition_id;
+
+        if (items_per_partition_[partition_id] == 0)
+            return;
+
+        data::File::Writer writer = partition_files_[partition_id].GetWriter();
+
+        size_t begin = partition_id * num_buckets_per_partition_;
+        size_t end = begin + partition_size_[partition_id];
+
+        for (size_t i = begin; i != end; ++i) {
+            if (tags_[i] != empty_tag_) {
+                writer.Put(items_[i]);
+                items_[i].~KeyValuePair();
+                tags_[i] = empty_tag_;
+            }
+        }
+
+        // reset partition specific counter
+        num_items_ -= items_per_partition_[partition_id];
+        items_per_partition_[partition_id] = 0;
+        assert(num_items_ == this->num_items_calc());
+
+        LOG << "Spilled items of partition with id: " << partition_id;
+
+        GrowPartition(partition_id);
+    }
+
+    //! Spill all items of an arbitrary partition into an external memory File.
+    void SpillAnyPartition() {
+        // maybe make a policy later -tb
+        return SpillLargestPartition();
+    }
+
+    //! Spill all items of the largest partition into an external memory File.
+    void SpillLargestPartition() {
+        // get partition with max size
+        size_t size_max = 0, index = 0;
+
+        for (size_t i = 0; i < num_partitions_; ++i)
+        {
+            if (items_per_partition_[i] > size_max)
+            {
+                size_max = items_per_partition_[i];
+                index = i;
+            }
+        }
+
+        if (size_max == 0) {
+            return;
+        }
+
+        return SpillPartition(index);
+    }
+
+    //! \}
+
+    //! \name Flushing Mechanisms to Next Stage or Phase
+    //! \{
+
+    template <typename Emit>
+    void FlushPartitionEmit(
+        size_t partition_id, bool consume, bool grow, Emit emit) {
+
+        LOG << "Flushing " << items_per_partition_[partition_id]
+            << " items of partition: " << partition_id;
+
+        size_t begin = partition_id * num_buckets_per_partition_;
+        size_t end = begin + partition_size_[partition_id];
+
+        for (size_t i = begin; i != end; ++i)
+        {
+            if (tags_[i] != empty_tag_) {
+                emit(partition_id, items_[i]);
+
+                if (consume) {
+                    items_[i].~KeyValuePair();
+                    tags_[i] = empty_tag_;
+                }
+            }
+        }
+
+        if (consume) {
+            // reset partition specific counter
+            num_items_ -= items_per_partition_[partition_id];
+            items_per_partition_[partition_id] = 0;
+            assert(num_items_ == this->num_items_calc());
+        }
+
+        LOG << "Done flushed items of partition: " << partition_id;
+
+        if (grow)
+            GrowPartition(partition_id);
+    }
+
+    void FlushPartition(size_t partition_id, bool consume, bool grow) {
+        FlushPartitionEmit(
+            partition_id, consume, grow,
+            [this](const size_t& partition_id, const KeyValuePair& p) {
+                this->emitter_.Emit(partition_id, p);
+            });
+    }
+
+    void FlushAll() {
+        for (size_t i = 0; i < num_partitions_; ++i) {
+            FlushPartition(i, /* consume */ true, /* grow */ false);
+        }
+    }
+
+    //! \}
+
+private:
+    using Super::config_;
+    using Super::equal_to_function_;
+    using Super::immediate_flush_;
+    using Super::index_function_;
+    using Super::items_per_partition_;
+    using Super::key_extractor_;
+    using Super::limit_memory_bytes_;
+    using Super::num_buckets_;
+    using Super::num_buckets_per_partition_;
+    using Super::num_items_;
+    using Super::num_partitions_;
+    using Super::partition_files_;
+    using Super::reduce_function_;
+
+    //! number of control bytes compared at once
+    static constexpr size_t group_size_ = 16;
+
+    //! control byte of empty slots, tags have the highest bit cleared.
+    static constexpr uint8_t empty_tag_ = 0x80;
+
+    //! Storing the actual hash table, slots are constructed if occupied.
+    KeyValuePair* items_ = nullptr;
+
+    //! One control byte per slot: empty_tag_ or the tag of the slot's key.
+    uint8_t* tags_ = nullptr;
+
+    //! Current sizes of the partitions because the valid allocated areas grow
+    std::vector<size_t> partition_size_;
+
+    //! Current limits on the number of items in a partitions, different for
+    //! different partitions, because the valid allocated areas grow.
+    std::vector<size_t> limit_items_per_partition_;
+
+    //! construct a new pair in an empty slot and check the partition's limit
+    void InsertAt(size_t partition_id, size_t pos, uint8_t tag,
+                  const KeyValuePair& kv) {
+        size_t i = partition_id * num_buckets_per_partition_ + pos;
+        assert(tags_[i] == empty_tag_);
+
+        new (items_ + i)KeyValuePair(kv);
+        tags_[i] = tag;
+
+        // increase counter for partition
+        ++items_per_partition_[partition_id];
+        ++num_items_;
+
+        while (THRILL_UNLIKELY(
+                   items_per_partition_[partition_id] >=
+                   limit_items_per_partition_[partition_id])) {
+            LOG << "Spill due to "
+                << items_per_partition_[partition_id] << " >= "
+                << limit_items_per_partition_[partition_id]
+                << " among " << partition_size_[partition_id];
+            SpillOrGrowPartition(partition_id);
+        }
+    }
+
+    /*!
+     * Grow a partition which still contains items by moving them out and
+     * reinserting them into the larger area.
+     */
+    void GrowPartitionRehash(size_t partition_id) {
+
+        size_t begin = partition_id * num_buckets_per_partition_;
+        size_t end = begin + partition_size_[partition_id];
+
+        std::vector<KeyValuePair> items;
+        items.reserve(items_per_partition_[partition_id]);
+
+        for (size_t i = begin; i != end; ++i) {
+            if (tags_[i] != empty_tag_) {
+                items.emplace_back(std::move(items_[i]));
+                items_[i].~KeyValuePair();
+                tags_[i] = empty_tag_;
+            }
+        }
+
+        GrowPartition(partition_id);
+
+        const size_t psize = partition_size_[partition_id];
+
+        for (KeyValuePair& kv : items) {
+            typename IndexFunction::Result h = index_function_(
+                kv.first, num_partitions_,
+                num_buckets_per_partition_, num_buckets_);
+
+            size_t pos = h.local_index(psize);
+
+            while (tags_[begin + pos] != empty_tag_) {
+                if (THRILL_UNLIKELY(++pos == psize))
+                    pos = 0;
+            }
+            new (items_ + begin + pos)KeyValuePair(std::move(kv));
+            tags_[begin + pos] = h.tag();
+        }
+    }
+
+    /*!
+     * Handle a partition which reached its fill limit: partitions of tables
+     * which flush immediately are flushed and then grown. Otherwise, spilled
+     * items must be read again later, hence the partition is grown in place as
+     * long as possible and only spilled when it reached its maximum size.
+     */
+    void SpillOrGrowPartition(size_t partition_id) {
+        if (!immediate_flush_ &&
+            partition_size_[partition_id] < num_buckets_per_partition_) {
+            return GrowPartitionRehash(partition_id);
+        }
+        SpillPartition(partition_id);
+    }
+
+#if defined(__SSE2__)
+    //! bit mask of control bytes in group equal to tag
+    static unsigned MatchTag(const uint8_t* group, uint8_t tag) {
+        __m128i ctrl = _mm_loadu_si128(reinterpret_cast<const __m128i*>(group));
+        return static_cast<unsigned>(_mm_movemask_epi8(
+                                         _mm_cmpeq_epi8(
+                                             ctrl, _mm_set1_epi8(
+                                                 static_cast<char>(tag)))));
+    }
+
+    //! bit mask of empty control bytes in group (those with highest bit set)
+    static unsigned MatchEmpty(const uint8_t* group) {
+        __m128i ctrl = _mm_loadu_si128(reinterpret_cast<const __m128i*>(group));
+        return static_cast<unsigned>(_mm_movemask_epi8(ctrl));
+    }
+#else
+    //! bit mask of control bytes in group equal to tag
+    static unsigned MatchTag(const uint8_t* group, uint8_t tag) {
+        unsigned mask = 0;
+        for (size_t i = 0; i < group_size_; ++i)
+            mask |= unsigned(group[i] == tag) << i;
+        return mask;
+    }
+
+    //! bit mask of empty control bytes in group (those with highest bit set)
+    static unsigned MatchEmpty(const uint8_t* group) {
+        unsigned mask = 0;
+        for (size_t i = 0; i < group_size_; ++i)
+            mask |= unsigned(group[i] >> 7) << i;
+        return mask;
+    }
+#endif
+};
+
+template <typename ValueType, typename Key, typename Value,
+          typename KeyExtractor, typename ReduceFunction,
+          typename Emitter, const bool VolatileKey,
+          typename ReduceConfig, typename IndexFunction,
+          typename EqualToFunction>
+class ReduceTableSelect<
+        ReduceTableImpl::TAGGED_PROBING,
+        ValueType, Key, Value, KeyExtractor, ReduceFunction,
+        Emitter, VolatileKey, ReduceConfig, IndexFunction, EqualToFunction>
+{
+public:
+    using type = ReduceTaggedProbingHashTable<
+              ValueType, Key, Value, KeyExtractor, ReduceFunction,
+              Emitter, VolatileKey, ReduceConfig,
+              IndexFunction, EqualToFunction>;
+};
+
+} // namespace core
+} // namespace thrill
+
+#endif // !THRILL_CORE_REDUCE_TAGGED_PROBING_HASH_TABLE_HEADER
+
+/******************************************************************************/
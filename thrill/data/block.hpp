@@ -19,6 +19,7 @@
 #include <thrill/mem/pool.hpp>
 
 #include <cassert>
+#include <chrono>
 #include <ostream>
 #include <string>
 
@@ -353,6 +354,10 @@ private:
     PinnedBlock block_;
     //! running read request
     io::RequestPtr req_;
+    //! buffer receiving the compressed data of a compressed swapped block
+    Byte* em_buffer_ = nullptr;
+    //! time the read request was issued, for measuring the read latency
+    std::chrono::steady_clock::time_point tp_issue_;
 
     //! indication that the PinnedBlocks ready
     std::atomic<bool> ready_;
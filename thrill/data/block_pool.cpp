@@ -8,9 +8,11 @@
  * All rights reserved. Published under the BSD-2 license in the LICENSE file.
  ******************************************************************************/
 
+#include <thrill/common/config.hpp>
 #include <thrill/common/die.hpp>
 #include <thrill/common/logger.hpp>
 #include <thrill/common/lru_cache.hpp>
+#include <thrill/common/lz_codec.hpp>
 #include <thrill/common/math.hpp>
 #include <thrill/data/block.hpp>
 #include <thrill/data/block_pool.hpp>
@@ -31,6 +33,8 @@
 namespace thrill {
 namespace data {
 
+bool default_swap_compress = false;
+
 //! debug block life cycle output: create, destroy
 static constexpr bool debug_blc = false;
 
@@ -43,6 +47,12 @@ static constexpr bool debug_mem = false;
 //! debug block eviction: evict, write complete, read complete
 static constexpr bool debug_em = false;
 
+//! number of unpins a local worker defers before applying them to the LRU list
+static constexpr size_t unpin_batch = 16;
+
+//! maximum number of Blocks a File reader prefetches adaptively
+static constexpr size_t max_prefetch = 16;
+
 /******************************************************************************/
 // std::new_handler() which gets called when malloc() returns nullptr
 
@@ -211,6 +221,20 @@ std::ostream& operator << (std::ostream& os, const BlockPool::PinCount& p) {
     return os;
 }
 
+/******************************************************************************/
+// BlockPool::Shard
+
+struct BlockPool::Shard {
+    //! locked when changing the worker's pin counts in ByteBlocks, and when
+    //! accessing unpinned_. Lock order is BlockPool::mutex_ before this one.
+    alignas(common::g_cache_line_size) std::mutex mutex_;
+
+    //! ByteBlocks on which the worker released its last pin, but which still
+    //! hold one count in total_pins_ and in the PinCount until the unpins are
+    //! applied. A ByteBlock may be contained multiple times.
+    std::vector<ByteBlock*, mem::GPoolAllocator<ByteBlock*> > unpinned_;
+};
+
 /******************************************************************************/
 // BlockPool::Data
 
@@ -287,9 +311,20 @@ public:
     //! total number of bytes in swapped blocks
     Counter swapped_bytes_;
 
+    //! compress blocks evicted to EM
+    bool swap_compress_ = default_swap_compress;
+
+    //! total number of bytes of blocks evicted to EM, and of their (possibly
+    //! compressed) extents written to EM.
+    size_t swap_raw_bytes_ = 0, swap_disk_bytes_ = 0;
+
     //! number of bytes currently being read from to EM.
     Counter reading_bytes_;
 
+    //! moving average of the latency of reads from EM, zero until the first
+    //! read completed.
+    std::chrono::nanoseconds read_latency_ { 0 };
+
     //! total number of ByteBlocks allocated
     size_t total_byte_blocks_ = 0;
 
@@ -306,6 +341,9 @@ public:
     //! also additionally reserved memory via BlockPoolMemoryHolder.
     Counter total_ram_bytes_;
 
+    //! one shard per local worker
+    std::vector<Shard> shards_;
+
     //! last time statistics where outputted
     std::chrono::steady_clock::time_point tp_last_
         = std::chrono::steady_clock::now();
@@ -318,7 +356,11 @@ public:
           hard_ram_limit_(hard_ram_limit),
           bm_(io::BlockManager::GetInstance()),
           aligned_alloc_(mem::Allocator<char>(block_pool.mem_manager_)),
-          pin_count_(workers_per_host) { }
+          pin_count_(workers_per_host),
+          shards_(workers_per_host) {
+        for (Shard& shard : shards_)
+            shard.unpinned_.reserve(unpin_batch);
+    }
 
     //! Updates the memory manager for internal memory. If the hard limit is
     //! reached, the call is blocked intil memory is free'd
@@ -328,10 +370,15 @@ public:
     //! BlockPool::RequestInternalMemory calls
     void IntReleaseInternalMemory(size_t size);
 
-    //! Unpins a block. If all pins are removed, the block might be swapped.
-    //! Returns immediately. Actual unpinning is async.
-    void IntUnpinBlock(
-        BlockPool& bp, ByteBlock* block_ptr, size_t local_worker_id);
+    //! Applies a deferred unpin of a block by a local worker. If all pins are
+    //! removed, the block might be swapped.
+    void IntUnpinBlock(ByteBlock* block_ptr, size_t local_worker_id);
+
+    //! Applies all deferred unpins of a local worker.
+    void IntFlushUnpinned(size_t local_worker_id);
+
+    //! Applies all deferred unpins of all local workers.
+    void IntFlushUnpinned();
 
     //! Evict a block from the lru list into external memory
     io::RequestPtr IntEvictBlockLRU();
@@ -340,6 +387,15 @@ public:
     //! swapped.
     io::RequestPtr IntEvictBlock(ByteBlock* block_ptr);
 
+    //! Compress the block's data into em_buffer_ for eviction, if this saves
+    //! at least one aligned I/O unit. Returns the size of the extent to write.
+    size_t IntCompressBlock(ByteBlock* block_ptr);
+
+    //! size of the buffer for compressing a block for eviction
+    static size_t CompressBufferSize(const ByteBlock* block_ptr) {
+        return block_ptr->size() - THRILL_DEFAULT_ALIGN;
+    }
+
     //! \name Block Statistics
     //! \{
 
@@ -445,6 +501,7 @@ BlockPool::~BlockPool() {
     d_->cv_total_byte_blocks_.wait(
         lock, [this]() { return d_->total_byte_blocks_ == 0; });
 
+    d_->IntFlushUnpinned();
     d_->pin_count_.AssertZero();
     die_unequal(d_->total_ram_bytes_, 0u);
     die_unequal(d_->total_bytes_, 0u);
@@ -458,7 +515,9 @@ BlockPool::~BlockPool() {
     logger_ << "class" << "BlockPool"
             << "event" << "destroy"
             << "max_pins" << d_->pin_count_.max_pins
-            << "max_pinned_bytes" << d_->pin_count_.max_pinned_bytes;
+            << "max_pinned_bytes" << d_->pin_count_.max_pinned_bytes
+            << "swap_raw_bytes" << d_->swap_raw_bytes_
+            << "swap_disk_bytes" << d_->swap_disk_bytes_;
 
     std::unique_lock<std::recursive_mutex> s_new_lock(s_new_mutex);
     s_blockpools.erase(
@@ -530,31 +589,38 @@ ByteBlockPtr BlockPool::MapExternalBlock(
 //! Pins a block by swapping it in if required.
 PinRequestPtr BlockPool::PinBlock(const Block& block, size_t local_worker_id) {
     assert(local_worker_id < workers_per_host_);
-    std::unique_lock<std::mutex> lock(mutex_);
 
     ByteBlock* block_ptr = block.byte_block().get();
 
-    if (block_ptr->pin_count_[local_worker_id] > 0) {
-        // We may get a Block who's underlying is already pinned, since
-        // PinnedBlock become Blocks when transfered between Files or delivered
-        // via GetItemRange() or Scatter().
+    {
+        std::unique_lock<std::mutex> shard_lock(
+            d_->shards_[local_worker_id].mutex_);
 
-        die_unless(!d_->unpinned_blocks_.exists(block_ptr));
-        die_unless(d_->reading_.find(block_ptr) == d_->reading_.end());
+        if (block_ptr->pin_count_[local_worker_id] > 0) {
+            // We may get a Block who's underlying is already pinned, since
+            // PinnedBlock become Blocks when transfered between Files or
+            // delivered via GetItemRange() or Scatter(). The total pin count
+            // cannot drop to zero, hence the mutex_ is not needed.
 
-        LOGC(debug_pin)
-            << "BlockPool::PinBlock block=" << &block
-            << " already pinned by thread";
+            LOGC(debug_pin)
+                << "BlockPool::PinBlock block=" << &block
+                << " already pinned by thread";
 
-        IntIncBlockPinCount(block_ptr, local_worker_id);
+            ++block_ptr->pin_count_[local_worker_id];
+            ++block_ptr->total_pins_;
+            shard_lock.unlock();
 
-        return PinRequestPtr(mem::GPool().make<PinRequest>(
-                                 this, PinnedBlock(block, local_worker_id)));
+            return PinRequestPtr(mem::GPool().make<PinRequest>(
+                                     this, PinnedBlock(block, local_worker_id)));
+        }
     }
 
+    std::unique_lock<std::mutex> lock(mutex_);
+
     if (block_ptr->total_pins_ > 0) {
-        // This block was already pinned by another thread, hence we only need
-        // to get a pin for the new thread.
+        // This block was already pinned by another thread, or this thread's
+        // unpin is still deferred, hence we only need to get a pin for the new
+        // thread.
 
         die_unless(!d_->unpinned_blocks_.exists(block_ptr));
         die_unless(d_->reading_.find(block_ptr) == d_->reading_.end());
@@ -653,10 +719,14 @@ PinRequestPtr BlockPool::PinBlock(const Block& block, size_t local_worker_id) {
             this, PinnedBlock(block, local_worker_id), /* ready */ false));
     d_->reading_[block_ptr] = read;
 
-    // allocate block memory.
+    // allocate block memory, and a buffer for the compressed extent.
     lock.unlock();
     Byte* data = read->byte_block()->data_ =
                      d_->aligned_alloc_.allocate(block_ptr->size());
+    if (block_ptr->em_compressed_size_) {
+        data = read->em_buffer_ =
+                   d_->aligned_alloc_.allocate(block_ptr->em_bid_.size);
+    }
     lock.lock();
 
     if (!block_ptr->ext_file_) {
@@ -673,12 +743,13 @@ PinRequestPtr BlockPool::PinBlock(const Block& block, size_t local_worker_id) {
     read->req_ =
         block_ptr->em_bid_.storage->aread(
             // parameters for the read
-            data, block_ptr->em_bid_.offset, block_ptr->size(),
+            data, block_ptr->em_bid_.offset, block_ptr->em_bid_.size,
             // construct an immediate CompletionHandler callback
             io::CompletionHandler::make<
                 PinRequest, & PinRequest::OnComplete>(*read));
 
     d_->reading_bytes_ += block_ptr->size();
+    read->tp_issue_ = std::chrono::steady_clock::now();
 
     return read;
 }
@@ -689,11 +760,26 @@ void PinRequest::OnComplete(io::Request* req, bool success) {
 
 void BlockPool::OnReadComplete(
     PinRequest* read, io::Request* req, bool success) {
-    std::unique_lock<std::mutex> lock(mutex_);
 
     ByteBlock* block_ptr = read->block_.byte_block().get();
     size_t block_size = block_ptr->size();
 
+    if (read->em_buffer_) {
+        // decompress outside of the lock, the block is not visible to other
+        // threads until ready_ is set.
+        if (success && !req->error() &&
+            !common::LzDecompress(
+                read->em_buffer_, block_ptr->em_compressed_size_,
+                read->byte_block()->data_, block_size)) {
+            die("BlockPool: corrupt compressed block read from "
+                << block_ptr->em_bid_);
+        }
+        d_->aligned_alloc_.deallocate(read->em_buffer_, block_ptr->em_bid_.size);
+        read->em_buffer_ = nullptr;
+    }
+
+    std::unique_lock<std::mutex> lock(mutex_);
+
     LOGC(debug_em)
         << "OnReadComplete():"
         << " req " << req << " block " << block_ptr
@@ -724,12 +810,20 @@ void BlockPool::OnReadComplete(
     }
     else    // success
     {
+        // update moving average of read latency
+        std::chrono::nanoseconds latency =
+            std::chrono::duration_cast<std::chrono::nanoseconds>(
+                std::chrono::steady_clock::now() - read->tp_issue_);
+        d_->read_latency_ = d_->read_latency_.count() == 0 ? latency
+                            : (7 * d_->read_latency_ + latency) / 8;
+
         // set pin on ByteBlock
         IntIncBlockPinCount(block_ptr, read->block_.local_worker_id_);
 
         if (!block_ptr->ext_file_) {
             d_->bm_->delete_block(block_ptr->em_bid_);
             block_ptr->em_bid_ = io::BID<0>();
+            block_ptr->em_compressed_size_ = 0;
         }
     }
 
@@ -750,20 +844,32 @@ void BlockPool::OnReadComplete(
 }
 
 void BlockPool::IncBlockPinCount(ByteBlock* block_ptr, size_t local_worker_id) {
-    std::unique_lock<std::mutex> lock(mutex_);
     assert(local_worker_id < workers_per_host_);
+    // the total pin count is > 0 and cannot drop to zero while we hold a pin,
+    // hence only the worker's shard is locked.
+    std::unique_lock<std::mutex> shard_lock(d_->shards_[local_worker_id].mutex_);
     die_unless(block_ptr->pin_count_[local_worker_id] > 0);
-    return IntIncBlockPinCount(block_ptr, local_worker_id);
+
+    ++block_ptr->pin_count_[local_worker_id];
+    ++block_ptr->total_pins_;
+
+    LOGC(debug_pin)
+        << "BlockPool::IncBlockPinCount()"
+        << " block=" << block_ptr
+        << " ++block.pin_count[" << local_worker_id << "]="
+        << block_ptr->pin_count_[local_worker_id]
+        << " ++block.total_pins_=" << block_ptr->total_pins_;
 }
 
 void BlockPool::IntIncBlockPinCount(ByteBlock* block_ptr, size_t local_worker_id) {
     assert(local_worker_id < workers_per_host_);
+    std::unique_lock<std::mutex> shard_lock(d_->shards_[local_worker_id].mutex_);
 
     ++block_ptr->pin_count_[local_worker_id];
     ++block_ptr->total_pins_;
 
     LOGC(debug_pin)
-        << "BlockPool::IncBlockPinCount()"
+        << "BlockPool::IntIncBlockPinCount()"
         << " block=" << block_ptr
         << " ++block.pin_count[" << local_worker_id << "]="
         << block_ptr->pin_count_[local_worker_id]
@@ -772,45 +878,75 @@ void BlockPool::IntIncBlockPinCount(ByteBlock* block_ptr, size_t local_worker_id
 }
 
 void BlockPool::DecBlockPinCount(ByteBlock* block_ptr, size_t local_worker_id) {
-    std::unique_lock<std::mutex> lock(mutex_);
-
     assert(local_worker_id < workers_per_host_);
+    Shard& shard = d_->shards_[local_worker_id];
+    std::unique_lock<std::mutex> shard_lock(shard.mutex_);
+
     die_unless(block_ptr->pin_count_[local_worker_id] > 0);
     die_unless(block_ptr->total_pins_ > 0);
 
     size_t p = --block_ptr->pin_count_[local_worker_id];
-    size_t tp = --block_ptr->total_pins_;
 
     LOGC(debug_pin)
         << "BlockPool::DecBlockPinCount()"
         << " block=" << block_ptr
         << " --block.pin_count[" << local_worker_id << "]=" << p
-        << " --block.total_pins_=" << tp
+        << " block.total_pins_=" << block_ptr->total_pins_
         << " local_worker_id=" << local_worker_id;
 
-    if (p == 0)
-        d_->IntUnpinBlock(*this, block_ptr, local_worker_id);
+    if (p != 0) {
+        // the worker still holds a pin, the total cannot drop to zero.
+        --block_ptr->total_pins_;
+        return;
+    }
+
+    // the worker released its last pin: defer the decrement of total_pins_
+    // and the insertion into the LRU list, which require the mutex_.
+    shard.unpinned_.push_back(block_ptr);
+    if (shard.unpinned_.size() < unpin_batch) return;
+
+    shard_lock.unlock();
+    std::unique_lock<std::mutex> lock(mutex_);
+    d_->IntFlushUnpinned(local_worker_id);
+}
+
+void BlockPool::Data::IntFlushUnpinned(size_t local_worker_id) {
+    Shard& shard = shards_[local_worker_id];
+    std::unique_lock<std::mutex> shard_lock(shard.mutex_);
+
+    for (ByteBlock* block_ptr : shard.unpinned_)
+        IntUnpinBlock(block_ptr, local_worker_id);
+
+    shard.unpinned_.clear();
+}
+
+void BlockPool::Data::IntFlushUnpinned() {
+    for (size_t i = 0; i < shards_.size(); ++i)
+        IntFlushUnpinned(i);
 }
 
 void BlockPool::Data::IntUnpinBlock(
-    BlockPool& bp, ByteBlock* block_ptr, size_t local_worker_id) {
-    die_unless(local_worker_id < bp.workers_per_host_);
+    ByteBlock* block_ptr, size_t local_worker_id) {
 
     // decrease per-thread total pin count (memory locked by thread)
-    die_unless(block_ptr->pin_count(local_worker_id) == 0);
-
     pin_count_.Decrement(local_worker_id, block_ptr->size());
 
-    if (block_ptr->total_pins_ != 0) {
+    die_unless(block_ptr->total_pins_ > 0);
+    if (--block_ptr->total_pins_ != 0) {
         LOGC(debug_pin)
             << "BlockPool::IntUnpinBlock()"
             << " --block.total_pins_=" << block_ptr->total_pins_;
         return;
     }
 
-    // if all per-thread pins are zero, allow this Block to be swapped out.
+    // if all per-thread pins are zero, allow this Block to be swapped out. A
+    // Block read sequentially is the next to be evicted, since its reader
+    // will not revisit it, while the Blocks following it are read soon.
     die_unless(!unpinned_blocks_.exists(block_ptr));
-    unpinned_blocks_.put(block_ptr);
+    if (block_ptr->evict_first_.exchange(false))
+        unpinned_blocks_.put_back(block_ptr);
+    else
+        unpinned_blocks_.put(block_ptr);
     unpinned_bytes_ += block_ptr->size();
 
     LOGC(debug_pin)
@@ -822,6 +958,7 @@ void BlockPool::Data::IntUnpinBlock(
 
 size_t BlockPool::total_blocks() noexcept {
     std::unique_lock<std::mutex> lock(mutex_);
+    d_->IntFlushUnpinned();
     return d_->int_total_blocks();
 }
 
@@ -869,11 +1006,13 @@ size_t BlockPool::Data::int_total_bytes() noexcept {
 
 size_t BlockPool::pinned_blocks() noexcept {
     std::unique_lock<std::mutex> lock(mutex_);
+    d_->IntFlushUnpinned();
     return d_->pin_count_.total_pins_;
 }
 
 size_t BlockPool::unpinned_blocks() noexcept {
     std::unique_lock<std::mutex> lock(mutex_);
+    d_->IntFlushUnpinned();
     return d_->unpinned_blocks_.size();
 }
 
@@ -882,6 +1021,21 @@ size_t BlockPool::writing_blocks() noexcept {
     return d_->writing_.size();
 }
 
+size_t BlockPool::swap_raw_bytes() noexcept {
+    std::unique_lock<std::mutex> lock(mutex_);
+    return d_->swap_raw_bytes_;
+}
+
+std::chrono::nanoseconds BlockPool::read_latency() noexcept {
+    std::unique_lock<std::mutex> lock(mutex_);
+    return d_->read_latency_;
+}
+
+size_t BlockPool::swap_disk_bytes() noexcept {
+    std::unique_lock<std::mutex> lock(mutex_);
+    return d_->swap_disk_bytes_;
+}
+
 size_t BlockPool::swapped_blocks() noexcept {
     std::unique_lock<std::mutex> lock(mutex_);
     return d_->swapped_.size();
@@ -901,7 +1055,10 @@ void BlockPool::DestroyBlock(ByteBlock* block_ptr) {
     // this method is called by ByteBlockPtr's deleter when the reference
     // counter reaches zero to deallocate the block.
 
-    // pinned blocks cannot be destroyed since they are always unpinned first
+    // pinned blocks cannot be destroyed since they are always unpinned first,
+    // but the unpins may still be deferred in the shards.
+    if (block_ptr->total_pins_ != 0)
+        d_->IntFlushUnpinned();
     die_unless(block_ptr->total_pins_ == 0);
 
     do {
@@ -1036,6 +1193,11 @@ void BlockPool::Data::IntRequestInternalMemory(
         << " unpinned_blocks_.size()=" << unpinned_blocks_.size()
         << " swapped_.size()=" << swapped_.size();
 
+    // make blocks with deferred unpins available for eviction
+    if (soft_ram_limit_ != 0 &&
+        total_ram_bytes_ + requested_bytes_ > soft_ram_limit_ + writing_bytes_)
+        IntFlushUnpinned();
+
     while (soft_ram_limit_ != 0 &&
            unpinned_blocks_.size() &&
            total_ram_bytes_ + requested_bytes_ > soft_ram_limit_ + writing_bytes_)
@@ -1052,6 +1214,8 @@ void BlockPool::Data::IntRequestInternalMemory(
     // wait for memory change due to blocks begin written and deallocated.
     while (hard_ram_limit_ != 0 && total_ram_bytes_ + size > hard_ram_limit_)
     {
+        IntFlushUnpinned();
+
         while (hard_ram_limit_ != 0 &&
                unpinned_blocks_.size() &&
                total_ram_bytes_ + requested_bytes_ > hard_ram_limit_ + writing_bytes_)
@@ -1116,6 +1280,8 @@ void BlockPool::AdviseFree(size_t size) {
         << " unpinned_blocks_.size()=" << d_->unpinned_blocks_.size()
         << " swapped_.size()=" << d_->swapped_.size();
 
+    d_->IntFlushUnpinned();
+
     while (d_->soft_ram_limit_ != 0 && d_->unpinned_blocks_.size() &&
            d_->total_ram_bytes_ + d_->requested_bytes_ + size > d_->hard_ram_limit_ + d_->writing_bytes_)
     {
@@ -1143,6 +1309,7 @@ void BlockPool::Data::IntReleaseInternalMemory(size_t size) {
 
 void BlockPool::EvictBlock(ByteBlock* block_ptr) {
     std::unique_lock<std::mutex> lock(mutex_);
+    d_->IntFlushUnpinned();
 
     die_unless(block_ptr->in_memory());
 
@@ -1153,6 +1320,47 @@ void BlockPool::EvictBlock(ByteBlock* block_ptr) {
     d_->IntEvictBlock(block_ptr);
 }
 
+size_t BlockPool::PrefetchDepth(
+    size_t num_prefetch, size_t block_size,
+    std::chrono::steady_clock::duration consume_time) {
+    std::unique_lock<std::mutex> lock(mutex_);
+
+    // prefetch enough Blocks to cover the read latency while consuming them,
+    // or at least one more Block than before.
+    size_t depth = num_prefetch + 1;
+    if (d_->read_latency_.count() != 0 && consume_time.count() > 0) {
+        depth = std::max(
+            depth, static_cast<size_t>(d_->read_latency_ / consume_time) + 1);
+    }
+    depth = std::min(depth, max_prefetch);
+
+    if (block_size == 0)
+        return std::max(depth, num_prefetch);
+
+    // each reader may use a sixteenth of its worker's share of memory
+    if (d_->hard_ram_limit_ != 0) {
+        depth = std::min(
+            depth, d_->hard_ram_limit_ / workers_per_host_ / 16 / block_size);
+    }
+
+    // and must not evict other blocks to make room for read-ahead
+    if (d_->soft_ram_limit_ != 0) {
+        size_t used = d_->total_ram_bytes_ + d_->requested_bytes_;
+        size_t free = used < d_->soft_ram_limit_
+                      ? d_->soft_ram_limit_ - used : 0;
+        depth = std::min(depth, num_prefetch + free / block_size);
+    }
+
+    LOGC(debug_em)
+        << "BlockPool::PrefetchDepth()"
+        << " num_prefetch=" << num_prefetch
+        << " read_latency_=" << d_->read_latency_.count()
+        << " consume_time=" << consume_time.count()
+        << " depth=" << depth;
+
+    return std::max(depth, num_prefetch);
+}
+
 io::RequestPtr BlockPool::GetAnyWriting() {
     std::unique_lock<std::mutex> lock(mutex_);
     if (!d_->writing_.size()) return io::RequestPtr();
@@ -1161,6 +1369,7 @@ io::RequestPtr BlockPool::GetAnyWriting() {
 
 io::RequestPtr BlockPool::EvictBlockLRU() {
     std::unique_lock<std::mutex> lock(mutex_);
+    d_->IntFlushUnpinned();
     return d_->IntEvictBlockLRU();
 }
 
@@ -1196,20 +1405,24 @@ io::RequestPtr BlockPool::Data::IntEvictBlock(ByteBlock* block_ptr) {
 
     die_unless(block_ptr->em_bid_.storage == nullptr);
 
-    // allocate EM block
-    block_ptr->em_bid_.size = block_ptr->size();
+    // allocate EM block, possibly a smaller extent for compressed data.
+    block_ptr->em_bid_.size = IntCompressBlock(block_ptr);
     bm_->new_block(io::FullyRandom(), block_ptr->em_bid_);
 
     LOGC(debug_em)
         << "EvictBlock(): " << block_ptr << " - " << *block_ptr
-        << " to em_bid " << block_ptr->em_bid_;
+        << " to em_bid " << block_ptr->em_bid_
+        << " compressed " << block_ptr->em_compressed_size_;
 
     writing_bytes_ += block_ptr->size();
+    swap_raw_bytes_ += block_ptr->size();
+    swap_disk_bytes_ += block_ptr->em_bid_.size;
 
     // initiate writing to EM.
     io::RequestPtr req =
         block_ptr->em_bid_.storage->awrite(
-            block_ptr->data_, block_ptr->em_bid_.offset, block_ptr->size(),
+            block_ptr->em_buffer_ ? block_ptr->em_buffer_ : block_ptr->data_,
+            block_ptr->em_bid_.offset, block_ptr->em_bid_.size,
             // construct an immediate CompletionHandler callback
             io::CompletionHandler::make<
                 ByteBlock, & ByteBlock::OnWriteComplete>(block_ptr));
@@ -1217,6 +1430,36 @@ io::RequestPtr BlockPool::Data::IntEvictBlock(ByteBlock* block_ptr) {
     return (writing_[block_ptr] = std::move(req));
 }
 
+size_t BlockPool::Data::IntCompressBlock(ByteBlock* block_ptr) {
+    block_ptr->em_compressed_size_ = 0;
+
+    // only compress whole multiples of the I/O alignment, and only if this
+    // saves at least one aligned unit.
+    if (!swap_compress_ || block_ptr->size() < 2 * THRILL_DEFAULT_ALIGN ||
+        block_ptr->size() % THRILL_DEFAULT_ALIGN != 0)
+        return block_ptr->size();
+
+    size_t buffer_size = CompressBufferSize(block_ptr);
+    Byte* buffer = aligned_alloc_.allocate(buffer_size);
+
+    size_t size = common::LzCompress(
+        block_ptr->data_, block_ptr->size(), buffer, buffer_size);
+
+    if (size == 0) {
+        aligned_alloc_.deallocate(buffer, buffer_size);
+        return block_ptr->size();
+    }
+
+    // clear padding up to the aligned extent size
+    size_t extent = common::IntegerDivRoundUp(
+        size, size_t(THRILL_DEFAULT_ALIGN)) * THRILL_DEFAULT_ALIGN;
+    std::fill(buffer + size, buffer + extent, 0);
+
+    block_ptr->em_buffer_ = buffer;
+    block_ptr->em_compressed_size_ = size;
+    return extent;
+}
+
 void BlockPool::OnWriteComplete(
     ByteBlock* block_ptr, io::Request* req, bool success) {
     std::unique_lock<std::mutex> lock(mutex_);
@@ -1230,6 +1473,12 @@ void BlockPool::OnWriteComplete(
     die_unequal(d_->writing_.erase(block_ptr), 1u);
     d_->writing_bytes_ -= block_ptr->size();
 
+    if (block_ptr->em_buffer_) {
+        d_->aligned_alloc_.deallocate(
+            block_ptr->em_buffer_, Data::CompressBufferSize(block_ptr));
+        block_ptr->em_buffer_ = nullptr;
+    }
+
     if (!success)
     {
         // request was canceled. this is not an I/O error, but intentional,
@@ -1241,6 +1490,7 @@ void BlockPool::OnWriteComplete(
 
         d_->bm_->delete_block(block_ptr->em_bid_);
         block_ptr->em_bid_ = io::BID<0>();
+        block_ptr->em_compressed_size_ = 0;
     }
     else    // success
     {
@@ -1257,6 +1507,7 @@ void BlockPool::OnWriteComplete(
 
 void BlockPool::RunTask(const std::chrono::steady_clock::time_point& tp) {
     std::unique_lock<std::mutex> lock(mutex_);
+    d_->IntFlushUnpinned();
 
     io::StatsData stnow(*io::Stats::GetInstance());
     io::StatsData stf = stnow - d_->io_stats_first_;
@@ -1290,6 +1541,12 @@ void BlockPool::RunTask(const std::chrono::steady_clock::time_point& tp) {
             << "unpinned_bytes" << unpinned_bytes
             << "swapped_blocks" << d_->swapped_.size()
             << "swapped_bytes" << d_->swapped_bytes_.hmax_update()
+            << "swap_raw_bytes" << d_->swap_raw_bytes_
+            << "swap_disk_bytes" << d_->swap_disk_bytes_
+            << "swap_compression_ratio"
+            << (d_->swap_raw_bytes_ == 0 ? 1.0 :
+                static_cast<double>(d_->swap_disk_bytes_)
+                / static_cast<double>(d_->swap_raw_bytes_))
             << "max_pinned_blocks" << d_->pin_count_.max_pins
             << "max_pinned_bytes" << d_->pin_count_.max_pinned_bytes
             << "writing_blocks" << d_->writing_.size()
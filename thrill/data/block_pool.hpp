@@ -21,6 +21,7 @@
 #include <thrill/mem/manager.hpp>
 
 #include <algorithm>
+#include <chrono>
 #include <functional>
 #include <mutex>
 #include <string>
@@ -33,10 +34,19 @@ namespace data {
 //! \addtogroup data_layer
 //! \{
 
+//! default setting whether BlockPools compress blocks evicted to disk.
+extern bool default_swap_compress;
+
 /*!
  * Pool to allocate, keep, swap out/in, and free all ByteBlocks on the host.
  * Starts a backgroud thread which is responsible for disk I/O
+ *
+ * Pins and unpins by a local worker of a Block it already holds a pin on only
+ * lock the worker's shard. When a worker releases its last pin on a Block, the
+ * unpin is deferred into the shard and applied to the global pin counters and
+ * the LRU list in batches.
  */
+
 class BlockPool : public common::ProfileTask
 {
     static constexpr bool debug = false;
@@ -128,6 +138,14 @@ public:
     //! swapped.
     void EvictBlock(ByteBlock* block_ptr);
 
+    //! Determine the read-ahead of a File reader which had to wait for a Block
+    //! of block_size, after consuming the previous one for the given time. The
+    //! read-ahead is extended to cover the average read latency, but limited
+    //! to a share of the local worker's memory and the RAM left before
+    //! blocks have to be evicted.
+    size_t PrefetchDepth(size_t num_prefetch, size_t block_size,
+                         std::chrono::steady_clock::duration consume_time);
+
     //! \name Block Statistics
     //! \{
 
@@ -158,6 +176,16 @@ public:
     //! Total number of blocks currently begin read from EM.
     size_t reading_blocks() noexcept;
 
+    //! Total number of block bytes evicted to EM.
+    size_t swap_raw_bytes() noexcept;
+
+    //! Total number of bytes written to EM for evicted blocks, which is less
+    //! than swap_raw_bytes() if they were compressed.
+    size_t swap_disk_bytes() noexcept;
+
+    //! Moving average of the latency of reading swapped blocks.
+    std::chrono::nanoseconds read_latency() noexcept;
+
     //! \}
 
     //! \name Methods for ProfileTask
@@ -193,13 +221,17 @@ private:
     //! substructure containing pin counters
     struct PinCount;
 
+    //! per local worker state for pinning and unpinning without the mutex_
+    struct Shard;
+
     //! pimpl data structure
     class Data;
 
     //! pimpl data structure
     std::unique_ptr<Data> d_;
 
-    //! Increment a ByteBlock's pin count - without locking the mutex
+    //! Increment a ByteBlock's pin count - without locking the mutex, but
+    //! locking the local worker's shard.
     void IntIncBlockPinCount(ByteBlock* block_ptr, size_t local_worker_id);
 
     //! callback for async write of blocks during eviction
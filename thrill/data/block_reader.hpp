@@ -22,6 +22,7 @@
 
 #include <algorithm>
 #include <string>
+#include <type_traits>
 #include <vector>
 
 namespace thrill {
@@ -111,6 +112,20 @@ public:
         return Serialization<BlockReader, T>::Deserialize(*this);
     }
 
+    /*!
+     * NextBatch() replaces the contents of out with up to n next items and
+     * returns their number. POD items are copied out of each Block in one
+     * piece, only items spanning Blocks are deserialized individually.
+     */
+    template <typename T>
+    size_t NextBatch(std::vector<T>& out, size_t n) {
+        out.clear();
+        AppendBatch(
+            out, n, std::integral_constant<
+                bool, std::is_pod<T>::value && !std::is_pointer<T>::value>());
+        return out.size();
+    }
+
     //! HasNext() returns true if at least one more item is available.
     THRILL_ATTRIBUTE_ALWAYS_INLINE
     bool HasNext() {
@@ -344,6 +359,36 @@ public:
     //! \}
 
 private:
+    //! Append up to n items by copying runs of PODs straight out of the Block.
+    template <typename T>
+    void AppendBatch(std::vector<T>& out, size_t n, std::true_type) {
+        if (self_verify && typecode_verify_)
+            return AppendBatch(out, n, std::false_type());
+        while (out.size() < n && HasNext()) {
+            size_t k = std::min(
+                std::min(n - out.size(), num_items_),
+                static_cast<size_t>(end_ - current_) / sizeof(T));
+            if (k == 0) {
+                // item straddles a Block boundary
+                out.emplace_back(Next<T>());
+                continue;
+            }
+            size_t pos = out.size();
+            out.resize(pos + k);
+            std::copy(current_, current_ + k * sizeof(T),
+                      reinterpret_cast<Byte*>(out.data() + pos));
+            current_ += k * sizeof(T);
+            num_items_ -= k;
+        }
+    }
+
+    //! Append up to n items by deserializing them one by one.
+    template <typename T>
+    void AppendBatch(std::vector<T>& out, size_t n, std::false_type) {
+        while (out.size() < n && HasNext())
+            out.emplace_back(Next<T>());
+    }
+
     //! Instance of BlockSource. This is NOT a reference, as to enable embedding
     //! of FileBlockSource to compose classes into File::Reader.
     BlockSource source_;
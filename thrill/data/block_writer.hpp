@@ -61,8 +61,7 @@ public:
     explicit BlockWriter(BlockSink* sink,
                          size_t max_block_size = default_block_size)
         : sink_(sink),
-          // block_size_(std::min(size_t(start_block_size), max_block_size)),
-          block_size_(max_block_size),
+          block_size_(std::min(start_block_size, max_block_size)),
           max_block_size_(max_block_size) {
         assert(max_block_size_ > 0);
     }
@@ -397,7 +396,7 @@ private:
         }
         sLOG << "AllocateBlock(): good, got" << bytes_.get();
         // increase block size, up to max.
-        if (block_size_ < max_block_size_) block_size_ *= 2;
+        block_size_ = std::min(2 * block_size_, max_block_size_);
 
         current_ = bytes_->begin();
         end_ = bytes_->end();
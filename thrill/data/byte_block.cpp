@@ -18,7 +18,7 @@
 namespace thrill {
 namespace data {
 
-size_t start_block_size = 2 * 1024 * 1024;
+size_t start_block_size = 16 * 1024;
 size_t default_block_size = 2 * 1024 * 1024;
 
 ByteBlock::ByteBlock(BlockPool* block_pool, Byte* data, size_t size)
@@ -40,7 +40,6 @@ ByteBlock::ByteBlock(
 void ByteBlock::Deleter::operator () (ByteBlock* bb) const {
     sLOG << "ByteBlock[" << bb << "]::deleter()"
          << "pin_count_" << bb->pin_count_str();
-    assert(bb->total_pins_ == 0);
     assert(bb->reference_count() == 0);
 
     // call BlockPool's DestroyBlock() to de-register ByteBlock and free data
@@ -75,7 +74,7 @@ std::ostream& operator << (std::ostream& os, const ByteBlock& b) {
     os << "[ByteBlock" << " " << &b
        << " size_=" << b.size_
        << " block_pool_=" << b.block_pool_
-       << " total_pins_=" << b.total_pins_
+       << " total_pins_=" << b.total_pins_.load()
        << " ext_file_=" << b.ext_file_;
     return os << "]";
 }
@@ -17,6 +17,7 @@
 #include <thrill/io/file_base.hpp>
 #include <thrill/mem/pool.hpp>
 
+#include <atomic>
 #include <string>
 #include <vector>
 
@@ -26,7 +27,9 @@ namespace data {
 //! \addtogroup data_layer
 //! \{
 
-//! starting size of blocks in BlockWriter.
+//! starting size of blocks in BlockWriter. The size doubles with every block
+//! up to the BlockWriter's maximum, such that short Streams and Files do not
+//! allocate whole default-sized blocks.
 extern size_t start_block_size;
 
 //! default size of blocks in File, Channel, BlockQueue, etc.
@@ -104,6 +107,10 @@ public:
     //! decrement pin count, possibly signal block pool that if it reaches zero.
     void DecPinCount(size_t local_worker_id);
 
+    //! hint that the block is not needed again soon, e.g. because it was read
+    //! sequentially. When it is unpinned, the BlockPool evicts it first.
+    void AdviseEvictFirst() { evict_first_ = true; }
+
 private:
     //! the memory block itself is referenced as it is in a a separate memory
     //! region that can be swapped out
@@ -115,17 +122,31 @@ private:
     //! reference to BlockPool for deletion.
     BlockPool* block_pool_;
 
-    //! counts the number of pins in this block per thread_id.
+    //! counts the number of pins in this block per thread_id. Each entry is
+    //! guarded by the BlockPool's shard of the local worker.
     std::vector<size_t, mem::GPoolAllocator<size_t> > pin_count_;
 
     //! counts the total number of pins, the data_ may be swapped out when this
-    //! reaches zero.
-    size_t total_pins_ = 0;
+    //! reaches zero. It only drops to or rises from zero while the BlockPool's
+    //! mutex is held.
+    std::atomic<size_t> total_pins_ { 0 };
+
+    //! hint to evict the block first once all pins are released, reset when
+    //! the block is unpinned.
+    std::atomic<bool> evict_first_ { false };
 
     //! external memory block, which contains a pointer to io::FileBase, an
-    //! offset into the file, and (unfortunately) also the size.
+    //! offset into the file, and (unfortunately) also the size. If the block
+    //! was swapped out compressed, the size is that of the aligned extent.
     io::BID<0> em_bid_;
 
+    //! length of the compressed data at the start of em_bid_, zero if the
+    //! block was swapped out uncompressed.
+    size_t em_compressed_size_ = 0;
+
+    //! buffer holding the compressed data while it is being written.
+    Byte* em_buffer_ = nullptr;
+
     //! shared pointer to external file, if this is != nullptr then the Block
     //! was created for directly reading binary files.
     io::FileBasePtr ext_file_;
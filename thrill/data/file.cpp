@@ -10,6 +10,7 @@
 
 #include <thrill/data/file.hpp>
 
+#include <algorithm>
 #include <deque>
 #include <string>
 
@@ -98,6 +99,44 @@ std::ostream& operator << (std::ostream& os, const File& f) {
     return os << "]]";
 }
 
+/******************************************************************************/
+// Common Prefetching of Block Sources
+
+/*!
+ * Wait for the first of the Blocks prefetched by a File's reader, this might
+ * block if the read is not finished. In that case, the read-ahead was too short
+ * to hide the I/O latency, and num_prefetch is extended if adapt_prefetch is
+ * set. Delivered Blocks are advised to be evicted first once unpinned, since
+ * readers scan Files sequentially.
+ */
+static PinnedBlock WaitPrefetched(
+    BlockPool& block_pool, std::deque<PinRequestPtr>& fetching_blocks,
+    size_t& num_prefetch, bool adapt_prefetch,
+    std::chrono::steady_clock::time_point& tp_last) {
+
+    std::chrono::steady_clock::time_point tp_now =
+        std::chrono::steady_clock::now();
+
+    PinRequestPtr& front = fetching_blocks.front();
+    if (adapt_prefetch && !front->ready()) {
+        // Blocks of a File grow up to default_block_size, hence the front
+        // Block's size underestimates the following ones.
+        num_prefetch = block_pool.PrefetchDepth(
+            num_prefetch,
+            std::max(front->byte_block()->size(), default_block_size),
+            tp_now - tp_last);
+    }
+
+    PinnedBlock b = front->Wait();
+    fetching_blocks.pop_front();
+
+    if (b.IsValid())
+        b.byte_block()->AdviseEvictFirst();
+
+    tp_last = std::chrono::steady_clock::now();
+    return b;
+}
+
 /******************************************************************************/
 // KeepFileBlockSource
 
@@ -106,11 +145,13 @@ KeepFileBlockSource::KeepFileBlockSource(
     size_t num_prefetch,
     size_t first_block, size_t first_item)
     : file_(file), local_worker_id_(local_worker_id),
-      num_prefetch_(num_prefetch),
+      num_prefetch_(num_prefetch), adapt_prefetch_(num_prefetch != 0),
+      tp_last_(std::chrono::steady_clock::now()),
       first_block_(first_block), current_block_(first_block),
       first_item_(first_item) { }
 
 void KeepFileBlockSource::Prefetch(size_t prefetch) {
+    adapt_prefetch_ = false;
     if (prefetch >= num_prefetch_) {
         num_prefetch_ = prefetch;
         // prefetch #desired blocks
@@ -147,10 +188,8 @@ PinnedBlock KeepFileBlockSource::NextBlock() {
                 NextUnpinnedBlock().Pin(local_worker_id_));
         }
 
-        // this might block if the prefetching is not finished
-        PinnedBlock b = fetching_blocks_.front()->Wait();
-        fetching_blocks_.pop_front();
-        return b;
+        return WaitPrefetched(*file_.block_pool(), fetching_blocks_,
+                              num_prefetch_, adapt_prefetch_, tp_last_);
     }
 }
 
@@ -174,18 +213,24 @@ Block KeepFileBlockSource::NextUnpinnedBlock() {
 ConsumeFileBlockSource::ConsumeFileBlockSource(
     File* file, size_t local_worker_id, size_t num_prefetch)
     : file_(file), local_worker_id_(local_worker_id),
-      num_prefetch_(num_prefetch) {
-    Prefetch(num_prefetch_);
+      num_prefetch_(num_prefetch), adapt_prefetch_(num_prefetch != 0),
+      tp_last_(std::chrono::steady_clock::now()) {
+    while (fetching_blocks_.size() < num_prefetch_ && !file_->blocks_.empty()) {
+        fetching_blocks_.emplace_back(
+            file_->blocks_.front().Pin(local_worker_id_));
+        file_->blocks_.pop_front();
+    }
 }
 
 ConsumeFileBlockSource::ConsumeFileBlockSource(ConsumeFileBlockSource&& s)
     : file_(s.file_), local_worker_id_(s.local_worker_id_),
-      num_prefetch_(s.num_prefetch_),
-      fetching_blocks_(std::move(s.fetching_blocks_)) {
+      num_prefetch_(s.num_prefetch_), adapt_prefetch_(s.adapt_prefetch_),
+      fetching_blocks_(std::move(s.fetching_blocks_)), tp_last_(s.tp_last_) {
     s.file_ = nullptr;
 }
 
 void ConsumeFileBlockSource::Prefetch(size_t prefetch) {
+    adapt_prefetch_ = false;
     if (prefetch >= num_prefetch_) {
         num_prefetch_ = prefetch;
         while (fetching_blocks_.size() < num_prefetch_ && !file_->blocks_.empty()) {
@@ -219,10 +264,8 @@ PinnedBlock ConsumeFileBlockSource::NextBlock() {
         file_->blocks_.pop_front();
     }
 
-    // this might block if the prefetching is not finished
-    PinnedBlock b = fetching_blocks_.front()->Wait();
-    fetching_blocks_.pop_front();
-    return b;
+    return WaitPrefetched(*file_->block_pool(), fetching_blocks_,
+                          num_prefetch_, adapt_prefetch_, tp_last_);
 }
 
 ConsumeFileBlockSource::~ConsumeFileBlockSource() {
@@ -22,6 +22,7 @@
 #include <thrill/data/dyn_block_reader.hpp>
 
 #include <cassert>
+#include <chrono>
 #include <deque>
 #include <functional>
 #include <limits>
@@ -60,6 +61,9 @@ public:
     using ConsumeReader = BlockReader<ConsumeFileBlockSource>;
     using DynWriter = DynBlockWriter;
 
+    //! initial number of Blocks read ahead by Readers. If they still have to
+    //! wait for swapped Blocks, the read-ahead grows as determined by
+    //! BlockPool::PrefetchDepth().
     static constexpr size_t default_prefetch = 2;
 
     //! Constructor from BlockPool
@@ -304,7 +308,8 @@ public:
     //! BlockReader
     PinnedBlock NextBlock();
 
-    //! Perform prefetch
+    //! Perform prefetch of a fixed number of Blocks, which disables the
+    //! adaptive read-ahead.
     void Prefetch(size_t prefetch);
 
 protected:
@@ -324,9 +329,15 @@ private:
     //! number of block prefetch operations
     size_t num_prefetch_;
 
+    //! whether num_prefetch_ is extended if reading stalls
+    bool adapt_prefetch_;
+
     //! current prefetch operations
     std::deque<data::PinRequestPtr> fetching_blocks_;
 
+    //! time the last Block was delivered, for measuring the consumption time
+    std::chrono::steady_clock::time_point tp_last_;
+
     //! number of the first block
     size_t first_block_;
 
@@ -362,7 +373,8 @@ public:
     //! move-constructor: default
     ConsumeFileBlockSource(ConsumeFileBlockSource&& s);
 
-    //! Perform prefetch
+    //! Perform prefetch of a fixed number of Blocks, which disables the
+    //! adaptive read-ahead.
     void Prefetch(size_t prefetch);
 
     //! Get the next block of file.
@@ -381,8 +393,14 @@ private:
     //! number of block prefetch operations
     size_t num_prefetch_;
 
+    //! whether num_prefetch_ is extended if reading stalls
+    bool adapt_prefetch_;
+
     //! current prefetch operations
     std::deque<data::PinRequestPtr> fetching_blocks_;
+
+    //! time the last Block was delivered, for measuring the consumption time
+    std::chrono::steady_clock::time_point tp_last_;
 };
 
 //! Get BlockReader seeked to the corresponding item index
@@ -11,6 +11,7 @@
 
 #include <thrill/data/multiplexer.hpp>
 
+#include <thrill/common/lz_codec.hpp>
 #include <thrill/data/cat_stream.hpp>
 #include <thrill/data/mix_stream.hpp>
 #include <thrill/data/multiplexer_header.hpp>
@@ -211,6 +212,12 @@ common::JsonLogger& Multiplexer::logger() {
 
 /******************************************************************************/
 
+//! round up a Block size to the allocation size of ByteBlocks
+static inline size_t AllocSize(size_t size) {
+    if (size < THRILL_DEFAULT_ALIGN) size = THRILL_DEFAULT_ALIGN;
+    return common::RoundUpToPowerOfTwo(size);
+}
+
 //! expects the next MultiplexerHeader from a socket and passes to
 //! OnMultiplexerHeader
 void Multiplexer::AsyncReadMultiplexerHeader(Connection& s) {
@@ -240,10 +247,8 @@ void Multiplexer::OnMultiplexerHeader(Connection& s, net::Buffer&& buffer) {
     StreamId id = header.stream_id;
     size_t local_worker = header.receiver_local_worker;
 
-    // round of allocation size to next power of two
-    size_t alloc_size = header.size;
-    if (alloc_size < THRILL_DEFAULT_ALIGN) alloc_size = THRILL_DEFAULT_ALIGN;
-    alloc_size = common::RoundUpToPowerOfTwo(alloc_size);
+    // round of allocation size of the payload to next power of two
+    size_t alloc_size = AllocSize(header.wire_size());
 
     if (header.magic == MagicByte::CatStreamBlock)
     {
@@ -268,7 +273,7 @@ void Multiplexer::OnMultiplexerHeader(Connection& s, net::Buffer&& buffer) {
                 alloc_size, local_worker);
 
             dispatcher_.AsyncRead(
-                s, header.size, std::move(bytes),
+                s, header.wire_size(), std::move(bytes),
                 [this, header, stream](Connection& s, PinnedByteBlockPtr&& bytes) {
                     OnCatStreamBlock(s, header, stream, std::move(bytes));
                 });
@@ -297,7 +302,7 @@ void Multiplexer::OnMultiplexerHeader(Connection& s, net::Buffer&& buffer) {
                 alloc_size, local_worker);
 
             dispatcher_.AsyncRead(
-                s, header.size, std::move(bytes),
+                s, header.wire_size(), std::move(bytes),
                 [this, header, stream](Connection& s, PinnedByteBlockPtr&& bytes) mutable {
                     OnMixStreamBlock(s, header, stream, std::move(bytes));
                 });
@@ -317,6 +322,9 @@ void Multiplexer::OnCatStreamBlock(
          << "in CatStream" << header.stream_id
          << "from worker" << header.sender_worker;
 
+    if (header.is_compressed)
+        bytes = Decompress(header, std::move(bytes));
+
     stream->OnStreamBlock(
         header.sender_worker,
         PinnedBlock(std::move(bytes), 0, header.size,
@@ -338,6 +346,9 @@ void Multiplexer::OnMixStreamBlock(
          << "in MixStream" << header.stream_id
          << "from worker" << header.sender_worker;
 
+    if (header.is_compressed)
+        bytes = Decompress(header, std::move(bytes));
+
     stream->OnStreamBlock(
         header.sender_worker,
         PinnedBlock(std::move(bytes), 0, header.size,
@@ -350,6 +361,21 @@ void Multiplexer::OnMixStreamBlock(
     AsyncReadMultiplexerHeader(s);
 }
 
+PinnedByteBlockPtr Multiplexer::Decompress(
+    const StreamMultiplexerHeader& header, PinnedByteBlockPtr&& bytes) {
+
+    PinnedByteBlockPtr raw = block_pool_.AllocateByteBlock(
+        AllocSize(header.size), header.receiver_local_worker);
+
+    if (!common::LzDecompress(bytes->data(), header.compressed_size,
+                              raw->data(), header.size)) {
+        die("Multiplexer: corrupt compressed Block in stream "
+            << header.stream_id << " from worker " << header.sender_worker);
+    }
+
+    return raw;
+}
+
 BlockQueue* Multiplexer::CatLoopback(
     size_t stream_id, size_t from_worker_id, size_t to_worker_id) {
     std::unique_lock<std::mutex> lock(mutex_);
@@ -213,6 +213,11 @@ private:
     void OnMixStreamBlock(
         Connection& s, const StreamMultiplexerHeader& header,
         const MixStreamPtr& stream, PinnedByteBlockPtr&& bytes);
+
+    //! Decompress the payload of a Block compressed by the StreamSink into a
+    //! new ByteBlock.
+    PinnedByteBlockPtr Decompress(
+        const StreamMultiplexerHeader& header, PinnedByteBlockPtr&& bytes);
 };
 
 //! \}
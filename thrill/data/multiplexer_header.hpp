@@ -41,12 +41,16 @@ public:
     MagicByte magic = MagicByte::Invalid;
     uint32_t size = 0;
     uint32_t num_items = 0;
-    // previous two bits are packed with first_item
-    uint32_t first_item : 30;
+    // previous three bits are packed with first_item
+    uint32_t first_item : 29;
     //! typecode self verify
     uint32_t typecode_verify : 1;
     //! is last block piggybacked indicator
     uint32_t is_last_block : 1;
+    //! payload is compressed with common::LzCompress()
+    uint32_t is_compressed : 1;
+    //! size of the compressed payload, if is_compressed is set.
+    uint32_t compressed_size = 0;
 
     MultiplexerHeader() = default;
 
@@ -55,13 +59,20 @@ public:
           size(static_cast<uint32_t>(b.size())),
           num_items(static_cast<uint32_t>(b.num_items())),
           first_item(static_cast<uint32_t>(b.first_item_relative())),
-          typecode_verify(b.typecode_verify()) {
+          typecode_verify(b.typecode_verify()),
+          is_last_block(0),
+          is_compressed(0) {
         if (!self_verify)
             assert(!typecode_verify);
     }
 
+    //! number of payload bytes following the header on the connection
+    size_t wire_size() const {
+        return is_compressed ? compressed_size : size;
+    }
+
     static constexpr size_t header_size =
-        sizeof(MagicByte) + 3 * sizeof(uint32_t);
+        sizeof(MagicByte) + 4 * sizeof(uint32_t);
 
     static constexpr size_t total_size =
         header_size + 3 * sizeof(size_t);
@@ -17,6 +17,8 @@
 namespace thrill {
 namespace data {
 
+bool default_stream_compress = false;
+
 Stream::Stream(Multiplexer& multiplexer, const StreamId& id,
                size_t local_worker_id, size_t dia_id)
     : id_(id),
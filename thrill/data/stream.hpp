@@ -31,6 +31,9 @@ namespace data {
 
 using StreamId = size_t;
 
+//! default setting whether Streams compress Blocks sent to other hosts.
+extern bool default_stream_compress;
+
 enum class MagicByte : uint8_t {
     Invalid, CatStreamBlock, MixStreamBlock, PartitionBlock
 };
@@ -68,6 +71,14 @@ public:
 
     void OnAllClosed(const char* stream_type);
 
+    //! Enable or disable compression of Blocks sent to other hosts. Must be set
+    //! before the Writers are used. Blocks which do not compress well are still
+    //! sent raw.
+    void set_compress(bool compress) { compress_ = compress; }
+
+    //! whether Blocks sent to other hosts are compressed.
+    bool compress() const { return compress_; }
+
     //! shuts the stream down.
     virtual void Close() = 0;
 
@@ -193,6 +204,9 @@ protected:
     //! number of received stream closing Blocks.
     common::Semaphore sem_closing_blocks_;
 
+    //! compress Blocks sent to other hosts.
+    bool compress_ = default_stream_compress;
+
     //! friends for access to multiplexer_
     friend class StreamSink;
 };
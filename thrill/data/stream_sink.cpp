@@ -10,10 +10,15 @@
 
 #include <thrill/data/stream_sink.hpp>
 
+#include <thrill/common/lz_codec.hpp>
+#include <thrill/common/math.hpp>
 #include <thrill/data/cat_stream.hpp>
 #include <thrill/data/mix_stream.hpp>
 #include <thrill/data/multiplexer_header.hpp>
 #include <thrill/data/stream.hpp>
+#include <thrill/mem/aligned_allocator.hpp>
+
+#include <algorithm>
 
 namespace thrill {
 namespace data {
@@ -78,6 +83,16 @@ void StreamSink::AppendPinnedBlock(const PinnedBlock& block, bool is_last_block)
     header.receiver_local_worker = peer_local_worker_;
     header.is_last_block = is_last_block;
 
+    PinnedBlock payload = Compress(block);
+    if (payload.IsValid()) {
+        header.is_compressed = 1;
+        header.compressed_size = static_cast<uint32_t>(payload.size());
+        ++compressed_counter_;
+    }
+    else {
+        payload = PinnedBlock(block);
+    }
+
     net::BufferBuilder bb;
     header.Serialize(bb);
 
@@ -85,13 +100,13 @@ void StreamSink::AppendPinnedBlock(const PinnedBlock& block, bool is_last_block)
     assert(buffer.size() == MultiplexerHeader::total_size);
 
     item_counter_ += block.num_items();
-    byte_counter_ += buffer.size() + block.size();
+    byte_counter_ += buffer.size() + payload.size();
     ++block_counter_;
 
     stream_.multiplexer_.dispatcher_.AsyncWrite(
         *connection_,
         // send out Buffer and Block, guaranteed to be successive
-        std::move(buffer), PinnedBlock(block),
+        std::move(buffer), std::move(payload),
         [this](net::Connection&) { sem_.signal(); });
 
     if (is_last_block) {
@@ -118,6 +133,42 @@ void StreamSink::AppendPinnedBlock(PinnedBlock&& block, bool is_last_block) {
     return AppendPinnedBlock(block, is_last_block);
 }
 
+PinnedBlock StreamSink::Compress(const PinnedBlock& block) {
+    if (!stream_.compress_ || block.size() < min_compress_size_)
+        return PinnedBlock();
+
+    if (compress_skip_ != 0) {
+        --compress_skip_;
+        return PinnedBlock();
+    }
+
+    // compression must save at least 1/8, otherwise sending the Block raw is
+    // cheaper than decompressing it on the receiver.
+    size_t limit = block.size() - block.size() / 8;
+
+    size_t alloc_size = std::max<size_t>(limit, THRILL_DEFAULT_ALIGN);
+    alloc_size = common::RoundUpToPowerOfTwo(alloc_size);
+
+    PinnedByteBlockPtr bytes =
+        block_pool()->AllocateByteBlock(alloc_size, local_worker_id_);
+
+    size_t size = common::LzCompress(
+        block.data_begin(), block.size(), bytes->data(), limit);
+
+    if (size == 0) {
+        // poor compression ratio: send the next Blocks raw, and double the
+        // number each time.
+        compress_backoff_ = std::min(
+            2 * compress_backoff_ + 1, max_compress_backoff_);
+        compress_skip_ = compress_backoff_;
+        return PinnedBlock();
+    }
+
+    compress_backoff_ = 0;
+    return PinnedBlock(std::move(bytes), 0, size, 0, 0,
+                       /* typecode_verify */ false);
+}
+
 void StreamSink::Close() {
     if (closed_) return;
     closed_ = true;
@@ -164,6 +215,7 @@ void StreamSink::Finalize() {
         << "items" << item_counter_
         << "bytes" << byte_counter_
         << "blocks" << block_counter_
+        << "compressed_blocks" << compressed_counter_
         << "timespan" << timespan_;
 
     stream_.tx_net_items_ += item_counter_;
@@ -107,9 +107,27 @@ private:
     //! layer for transmission.
     common::Semaphore sem_ { num_queue_ };
 
+    //! minimum Block size worth compressing
+    static constexpr size_t min_compress_size_ = 4096;
+
+    //! maximum number of Blocks sent raw after a Block compressed poorly
+    static constexpr size_t max_compress_backoff_ = 64;
+
+    //! number of Blocks to send raw before trying compression again
+    size_t compress_skip_ = 0;
+
+    //! current back-off after Blocks compressed poorly, doubles each time
+    size_t compress_backoff_ = 0;
+
+    //! Compress the Block's data into a new ByteBlock, if compression is
+    //! enabled and it saves at least 1/8 of the size. Returns an invalid
+    //! PinnedBlock otherwise.
+    PinnedBlock Compress(const PinnedBlock& block);
+
     size_t item_counter_ = 0;
     size_t byte_counter_ = 0;
     size_t block_counter_ = 0;
+    size_t compressed_counter_ = 0;
     common::StatsTimerStart timespan_;
 };
 
@@ -102,7 +102,8 @@ public:
     //! unlink file immediately after opening (available on most Unix)
     bool unlink_on_open;
 
-    //! desired queue length for linuxaio_file and linuxaio_queue
+    //! desired queue length for linuxaio_file/linuxaio_queue and
+    //! uring_file/uring_queue
     int queue_length;
 
     //! \}
@@ -21,6 +21,7 @@
 #include <thrill/io/memory_file.hpp>
 #include <thrill/io/mmap_file.hpp>
 #include <thrill/io/syscall_file.hpp>
+#include <thrill/io/uring_file.hpp>
 
 #include <ostream>
 #include <stdexcept>
@@ -141,6 +142,41 @@ FileBasePtr CreateFile(DiskConfig& cfg, int mode, int disk_allocator_id) {
         return FileBasePtr(result);
     }
 #endif
+#if THRILL_HAVE_IO_URING
+    // uring can have the desired queue length, specified as queue_length=?
+    else if (cfg.io_impl == "uring")
+    {
+        // uring_queue is a singleton.
+        cfg.queue = FileBase::DEFAULT_URING_QUEUE;
+
+        UfsFileBase* result =
+            new UringFile(cfg.path, mode, cfg.queue, disk_allocator_id,
+                          cfg.device_id, cfg.queue_length);
+
+        result->lock();
+
+        // if marked as device but file is not -> throw!
+        if (cfg.raw_device && !result->is_device())
+        {
+            delete result;
+            THRILL_THROWS(IoError, "Disk " << cfg.path << " was expected to be "
+                          "a raw block device, but it is a normal file!");
+        }
+
+        // if is raw_device -> get size and remove some flags.
+        if (result->is_device())
+        {
+            cfg.raw_device = true;
+            cfg.size = result->size();
+            cfg.autogrow = cfg.delete_on_exit = cfg.unlink_on_open = false;
+        }
+
+        if (cfg.unlink_on_open)
+            result->unlink();
+
+        return FileBasePtr(result);
+    }
+#endif
 #if THRILL_HAVE_MMAP_FILE
     else if (cfg.io_impl == "mmap")
     {
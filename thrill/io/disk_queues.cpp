@@ -22,6 +22,9 @@
 #include <thrill/io/linuxaio_request.hpp>
 #include <thrill/io/request_queue_impl_qw_qr.hpp>
 #include <thrill/io/serving_request.hpp>
+#include <thrill/io/uring_file.hpp>
+#include <thrill/io/uring_queue.hpp>
+#include <thrill/io/uring_request.hpp>
 
 #include <map>
 
@@ -60,6 +63,12 @@ void DiskQueues::MakeQueue(const FileBasePtr& file) {
         d_->queues[queue_id] = new LinuxaioQueue(af->desired_queue_length());
         return;
     }
+#endif
+#if THRILL_HAVE_IO_URING
+    if (const UringFile* uf = dynamic_cast<const UringFile*>(file.get())) {
+        d_->queues[queue_id] = new UringQueue(uf->desired_queue_length());
+        return;
+    }
 #endif
     d_->queues[queue_id] = new RequestQueueImplQwQr();
 }
@@ -79,6 +88,13 @@ void DiskQueues::AddRequest(RequestPtr& req, DiskId disk) {
                     dynamic_cast<LinuxaioFile*>(req->file().get())
                     ->desired_queue_length());
         else
+#endif
+#if THRILL_HAVE_IO_URING
+        if (dynamic_cast<UringRequest*>(req.get()))
+            q = d_->queues[disk] = new UringQueue(
+                    dynamic_cast<UringFile*>(req->file().get())
+                    ->desired_queue_length());
+        else
 #endif
         q = d_->queues[disk] = new RequestQueueImplQwQr();
     }
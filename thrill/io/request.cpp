@@ -18,6 +18,7 @@
 #include <thrill/io/linuxaio_request.hpp>
 #include <thrill/io/request.hpp>
 #include <thrill/io/serving_request.hpp>
+#include <thrill/io/uring_request.hpp>
 #include <thrill/mem/aligned_allocator.hpp>
 #include <thrill/mem/pool.hpp>
 
@@ -105,6 +106,11 @@ void RequestDeleter::operator () (Request* req) const {
     else if (LinuxaioRequest* r = dynamic_cast<LinuxaioRequest*>(req)) {
         mem::GPool().destroy(r);
     }
+#endif
+#if THRILL_HAVE_IO_URING
+    else if (UringRequest* r = dynamic_cast<UringRequest*>(req)) {
+        mem::GPool().destroy(r);
+    }
 #endif
     else {
         abort();
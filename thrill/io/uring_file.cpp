@@ -0,0 +1,68 @@
+/*******************************************************************************
+ * thrill/io/uring_file.cpp
+ *
+ * File implementation using Linux io_uring for asynchronous I/O.
+ *
+ * Part of Project Thrill - http://project-thrill.org
+ *
+ * Copyright (C) 2016 Timo Bingmann <tb@panthema.net>
+ *
+ * All rights reserved. Published under the BSD-2 license in the LICENSE file.
+ ******************************************************************************/
+
+#include <thrill/io/uring_file.hpp>
+
+#if THRILL_HAVE_IO_URING
+
+#include <thrill/io/disk_queues.hpp>
+#include <thrill/io/uring_request.hpp>
+#include <thrill/mem/pool.hpp>
+
+namespace thrill {
+namespace io {
+
+RequestPtr UringFile::aread(
+    void* buffer, offset_type offset, size_type bytes,
+    const CompletionHandler& on_cmpl) {
+
+    RequestPtr req(mem::GPool().make<UringRequest>(
+                       on_cmpl, FileBasePtr(this),
+                       buffer, offset, bytes, Request::READ));
+
+    DiskQueues::GetInstance()->AddRequest(req, get_queue_id());
+
+    return req;
+}
+
+RequestPtr UringFile::awrite(
+    void* buffer, offset_type offset, size_type bytes,
+    const CompletionHandler& on_cmpl) {
+
+    RequestPtr req(mem::GPool().make<UringRequest>(
+                       on_cmpl, FileBasePtr(this),
+                       buffer, offset, bytes, Request::WRITE));
+
+    DiskQueues::GetInstance()->AddRequest(req, get_queue_id());
+
+    return req;
+}
+
+void UringFile::serve(void* buffer, offset_type offset, size_type bytes,
+                      Request::ReadOrWriteType type) {
+    // req need not be an UringRequest
+    if (type == Request::READ)
+        aread(buffer, offset, bytes)->wait();
+    else
+        awrite(buffer, offset, bytes)->wait();
+}
+
+const char* UringFile::io_type() const {
+    return "uring";
+}
+
+} // namespace io
+} // namespace thrill
+
+#endif // #if THRILL_HAVE_IO_URING
+
+/******************************************************************************/
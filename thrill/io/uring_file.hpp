@@ -0,0 +1,86 @@
+/*******************************************************************************
+ * thrill/io/uring_file.hpp
+ *
+ * File implementation using Linux io_uring for asynchronous I/O.
+ *
+ * Part of Project Thrill - http://project-thrill.org
+ *
+ * Copyright (C) 2016 Timo Bingmann <tb@panthema.net>
+ *
+ * All rights reserved. Published under the BSD-2 license in the LICENSE file.
+ ******************************************************************************/
+
+#pragma once
+#ifndef THRILL_IO_URING_FILE_HEADER
+#define THRILL_IO_URING_FILE_HEADER
+
+#include <thrill/common/config.hpp>
+
+#if THRILL_HAVE_IO_URING
+
+#include <thrill/io/disk_queued_file.hpp>
+#include <thrill/io/ufs_file_base.hpp>
+#include <thrill/io/uring_queue.hpp>
+
+#include <string>
+
+namespace thrill {
+namespace io {
+
+class UringQueue;
+
+//! \addtogroup io_layer_fileimpl
+//! \{
+
+//! Implementation of \c file based on the Linux io_uring interface for
+//! asynchronous I/O. Like LinuxaioFile, all files share one UringQueue.
+class UringFile final : public UfsFileBase, public DiskQueuedFile
+{
+    friend class UringRequest;
+
+private:
+    int desired_queue_length_;
+
+public:
+    //! Constructs file object
+    //! \param filename path of file
+    //! \param mode open mode, see \c FileBase::OpenMode
+    //! \param queue_id disk queue identifier
+    //! \param allocator_id linked disk_allocator
+    //! \param device_id physical device identifier
+    //! \param desired_queue_length queue length requested from kernel
+    UringFile(
+        const std::string& filename, int mode,
+        int queue_id = DEFAULT_URING_QUEUE,
+        int allocator_id = NO_ALLOCATOR,
+        unsigned int device_id = DEFAULT_DEVICE_ID,
+        int desired_queue_length = 0)
+        : FileBase(device_id),
+          UfsFileBase(filename, mode),
+          DiskQueuedFile(queue_id, allocator_id),
+          desired_queue_length_(desired_queue_length)
+    { }
+
+    void serve(void* buffer, offset_type offset, size_type bytes,
+               Request::ReadOrWriteType type) final;
+    RequestPtr aread(void* buffer, offset_type offset, size_type bytes,
+                     const CompletionHandler& on_cmpl = CompletionHandler()) final;
+    RequestPtr awrite(void* buffer, offset_type offset, size_type bytes,
+                      const CompletionHandler& on_cmpl = CompletionHandler()) final;
+    const char * io_type() const final;
+
+    int desired_queue_length() const {
+        return desired_queue_length_;
+    }
+};
+
+//! \}
+
+} // namespace io
+} // namespace thrill
+
+#endif // #if THRILL_HAVE_IO_URING
+
+#endif // !THRILL_IO_URING_FILE_HEADER
+
+/******************************************************************************/
@@ -0,0 +1,244 @@
+/*******************************************************************************
+ * thrill/io/uring_queue.cpp
+ *
+ * Request queue for UringFile(s), which submits batches of requests to a Linux
+ * io_uring.
+ *
+ * Part of Project Thrill - http://project-thrill.org
+ *
+ * Copyright (C) 2016 Timo Bingmann <tb@panthema.net>
+ *
+ * All rights reserved. Published under the BSD-2 license in the LICENSE file.
+ ******************************************************************************/
+
+#include <thrill/io/file_base.hpp>
+#include <thrill/io/uring_queue.hpp>
+
+#if THRILL_HAVE_IO_URING
+
+#include <thrill/common/die.hpp>
+#include <thrill/io/error_handling.hpp>
+#include <thrill/io/uring_request.hpp>
+
+#include <algorithm>
+#include <cstring>
+
+namespace thrill {
+namespace io {
+
+UringQueue::UringQueue(int desired_queue_length)
+    : ring_(desired_queue_length == 0 ? 64 : desired_queue_length),
+      post_thread_state_(NOT_RUNNING), wait_thread_state_(NOT_RUNNING) {
+    // every posted request occupies one submission entry until it completes.
+    max_events_ = static_cast<int>(ring_.sq_entries());
+    if (desired_queue_length != 0)
+        max_events_ = std::min(max_events_, desired_queue_length);
+
+    num_free_events_.signal(max_events_);
+
+    LOG1 << "Set up an io_uring queue with " << max_events_ << " entries.";
+
+    StartThread(PostAsync, static_cast<void*>(this), post_thread_, post_thread_state_);
+    StartThread(WaitAsync, static_cast<void*>(this), wait_thread_, wait_thread_state_);
+}
+
+UringQueue::~UringQueue() {
+    StopThread(post_thread_, post_thread_state_, num_waiting_requests_);
+    StopThread(wait_thread_, wait_thread_state_, num_posted_requests_);
+}
+
+void UringQueue::AddRequest(RequestPtr& req) {
+    if (req.empty())
+        THRILL_THROW_INVALID_ARGUMENT("Empty request submitted to disk_queue.");
+    if (post_thread_state_() != RUNNING)
+        LOG1 << "Request submitted to stopped queue.";
+    if (!dynamic_cast<UringRequest*>(req.get()))
+        LOG1 << "Non-io_uring request submitted to io_uring queue.";
+
+    std::unique_lock<std::mutex> lock(waiting_mtx_);
+
+    waiting_requests_.push_back(req);
+    num_waiting_requests_.signal();
+}
+
+bool UringQueue::CancelRequest(Request* req) {
+    if (!req)
+        THRILL_THROW_INVALID_ARGUMENT("Empty request canceled disk_queue.");
+    if (post_thread_state_() != RUNNING)
+        LOG1 << "Request canceled in stopped queue.";
+    if (!dynamic_cast<UringRequest*>(req))
+        LOG1 << "Non-io_uring request submitted to io_uring queue.";
+
+    std::unique_lock<std::mutex> lock(waiting_mtx_);
+
+    Queue::iterator pos =
+        std::find(waiting_requests_.begin(), waiting_requests_.end(), req);
+    if (pos == waiting_requests_.end() ||
+        dynamic_cast<UringRequest*>(req)->transferred_ != 0) {
+        // requests posted to the kernel are not canceled, since
+        // IORING_OP_ASYNC_CANCEL cannot stop a running disk transfer either.
+        return false;
+    }
+
+    waiting_requests_.erase(pos);
+
+    // request is canceled, but was not yet posted.
+    dynamic_cast<UringRequest*>(req)->completed(false, true);
+
+    num_waiting_requests_.wait(); // will never block
+    return true;
+}
+
+// internal routines, run by the posting thread
+void UringQueue::PostRequests() {
+    for ( ; ; ) // as long as thread is running
+    {
+        // might block until next request or message comes in
+        size_t num_currently_waiting_requests = num_waiting_requests_.wait();
+
+        // terminate if termination has been requested
+        if (post_thread_state_() == TERMINATING && num_currently_waiting_requests == 0)
+            break;
+
+        // might block because too many requests are posted
+        num_free_events_.wait();
+
+        // prepare the first request, and then all further waiting ones for
+        // which events are free, and submit them with one call.
+        size_t num_prepared = 0;
+        std::unique_lock<std::mutex> lock(waiting_mtx_);
+        for ( ; ; )
+        {
+            if (waiting_requests_.empty()) {
+                // num_waiting_requests-- was premature, compensate for that
+                num_waiting_requests_.signal();
+                num_free_events_.signal();
+                break;
+            }
+
+            RequestPtr req = waiting_requests_.front();
+            waiting_requests_.pop_front();
+
+            struct io_uring_sqe* sqe = ring_.GetSqe();
+            die_unless(sqe);
+            dynamic_cast<UringRequest*>(req.get())->Prepare(sqe);
+            ++num_prepared;
+
+            if (!num_free_events_.try_wait())
+                break;
+            if (!num_waiting_requests_.try_wait()) {
+                num_free_events_.signal();
+                break;
+            }
+        }
+        lock.unlock();
+
+        if (num_prepared == 0) continue;
+
+        while (ring_.Submit() < 0) {
+            if (errno == EINTR || errno == EAGAIN || errno == EBUSY)
+                continue;
+            THRILL_THROW_ERRNO(IoError, "UringQueue::PostRequests"
+                               " io_uring_enter() to_submit=" << num_prepared);
+        }
+
+        num_posted_requests_.signal(num_prepared);
+    }
+}
+
+void UringQueue::HandleCompletion(RequestPtr& req, int res) {
+    UringRequest* ureq = dynamic_cast<UringRequest*>(req.get());
+
+    if (res < 0) {
+        ureq->save_error(
+            mem::safe_string("UringQueue: ") +
+            (ureq->type() == Request::READ ? "read" : "write") +
+            " failed: " + strerror(-res));
+    }
+    else if (res == 0 && ureq->type() == Request::READ) {
+        // read request extends past end-of-file, fill remainder with zeroes.
+        memset(static_cast<char*>(ureq->buffer()) + ureq->transferred_, 0,
+               ureq->bytes() - ureq->transferred_);
+    }
+    else if (res == 0) {
+        ureq->save_error("UringQueue: write returned zero bytes");
+    }
+    else {
+        ureq->transferred_ += res;
+        if (ureq->transferred_ < ureq->bytes()) {
+            // short transfer: requeue the remaining bytes at the front.
+            std::unique_lock<std::mutex> lock(waiting_mtx_);
+            waiting_requests_.push_front(req);
+            num_waiting_requests_.signal();
+            return;
+        }
+    }
+
+    ureq->completed(false);
+}
+
+// internal routines, run by the waiting thread
+void UringQueue::WaitRequests() {
+    for ( ; ; ) // as long as thread is running
+    {
+        // might block until next request is posted or message comes in
+        size_t num_currently_posted_requests = num_posted_requests_.wait();
+
+        // terminate if termination has been requested
+        if (wait_thread_state_() == TERMINATING && num_currently_posted_requests == 0)
+            break;
+
+        // wait for at least one of them to finish
+        while (ring_.WaitCqe() == nullptr) {
+            if (errno == EINTR) {
+                // premature return, e.g. due to signal. Just try again
+                continue;
+            }
+
+            THRILL_THROW_ERRNO(IoError, "UringQueue::WaitRequests"
+                               " io_uring_enter()");
+        }
+
+        // compensate for the one eaten prematurely above
+        num_posted_requests_.signal();
+
+        // handle all available completions
+        while (struct io_uring_cqe* cqe = ring_.PeekCqe())
+        {
+            RequestPtr* r = reinterpret_cast<RequestPtr*>(cqe->user_data);
+            int res = cqe->res;
+            ring_.SeenCqe();
+
+            num_free_events_.signal();
+            num_posted_requests_.wait(); // will never block
+
+            HandleCompletion(*r, res);
+            delete r;                    // release reference
+        }
+    }
+}
+
+void* UringQueue::PostAsync(void* arg) {
+    (static_cast<UringQueue*>(arg))->PostRequests();
+
+    self_type* pthis = static_cast<self_type*>(arg);
+    pthis->post_thread_state_.set_to(TERMINATED);
+
+    return nullptr;
+}
+
+void* UringQueue::WaitAsync(void* arg) {
+    (static_cast<UringQueue*>(arg))->WaitRequests();
+
+    self_type* pthis = static_cast<self_type*>(arg);
+    pthis->wait_thread_state_.set_to(TERMINATED);
+
+    return nullptr;
+}
+
+} // namespace io
+} // namespace thrill
+
+#endif // #if THRILL_HAVE_IO_URING
+
+/******************************************************************************/
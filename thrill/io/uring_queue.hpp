@@ -0,0 +1,97 @@
+/*******************************************************************************
+ * thrill/io/uring_queue.hpp
+ *
+ * Request queue for UringFile(s), which submits batches of requests to a Linux
+ * io_uring.
+ *
+ * Part of Project Thrill - http://project-thrill.org
+ *
+ * Copyright (C) 2016 Timo Bingmann <tb@panthema.net>
+ *
+ * All rights reserved. Published under the BSD-2 license in the LICENSE file.
+ ******************************************************************************/
+
+#pragma once
+#ifndef THRILL_IO_URING_QUEUE_HEADER
+#define THRILL_IO_URING_QUEUE_HEADER
+
+#include <thrill/io/request_queue_impl_worker.hpp>
+
+#if THRILL_HAVE_IO_URING
+
+#include <thrill/common/io_uring.hpp>
+
+#include <list>
+#include <mutex>
+
+namespace thrill {
+namespace io {
+
+class UringRequest;
+
+//! \addtogroup io_layer_req
+//! \{
+
+//! Queue for UringFile(s)
+//!
+//! Only one queue exists in a program, i.e. it is a singleton. Like
+//! LinuxaioQueue it runs one thread posting requests and one waiting for their
+//! completion, which is possible without locking since io_uring has separate
+//! submission and completion rings. The posting thread submits all requests
+//! waiting at the time with a single io_uring_enter() call.
+class UringQueue final : public RequestQueueImplWorker
+{
+    friend class UringRequest;
+
+    using self_type = UringQueue;
+
+private:
+    //! io_uring instance
+    common::IoUring ring_;
+
+    //! storing UringRequest* would drop ownership
+    using Queue = std::list<RequestPtr>;
+
+    //! "waiting" request have been submitted to this queue, but not yet to
+    //! the OS.
+    std::mutex waiting_mtx_;
+    Queue waiting_requests_;
+
+    //! max number of OS requests
+    int max_events_;
+    //! number of requests in waitings_requests
+    common::Semaphore num_waiting_requests_, num_free_events_, num_posted_requests_;
+
+    // two threads, one for posting, one for waiting
+    std::thread post_thread_, wait_thread_;
+    common::SharedState<ThreadState> post_thread_state_, wait_thread_state_;
+
+    static void * PostAsync(void* arg);   // thread start callback
+    static void * WaitAsync(void* arg);   // thread start callback
+    void PostRequests();
+    void WaitRequests();
+
+    //! handle completion of a posted request with result res, which may
+    //! requeue the request if it was transferred only partially.
+    void HandleCompletion(RequestPtr& req, int res);
+
+public:
+    //! Construct queue. Requests max number of requests simultaneously
+    //! submitted to disk, 0 means as many as possible
+    explicit UringQueue(int desired_queue_length = 0);
+
+    void AddRequest(RequestPtr& req) final;
+    bool CancelRequest(Request* req) final;
+    ~UringQueue();
+};
+
+//! \}
+
+} // namespace io
+} // namespace thrill
+
+#endif // #if THRILL_HAVE_IO_URING
+
+#endif // !THRILL_IO_URING_QUEUE_HEADER
+
+/******************************************************************************/
@@ -0,0 +1,91 @@
+/*******************************************************************************
+ * thrill/io/uring_request.cpp
+ *
+ * Request for an UringFile.
+ *
+ * Part of Project Thrill - http://project-thrill.org
+ *
+ * Copyright (C) 2016 Timo Bingmann <tb@panthema.net>
+ *
+ * All rights reserved. Published under the BSD-2 license in the LICENSE file.
+ ******************************************************************************/
+
+#include <thrill/io/uring_request.hpp>
+
+#if THRILL_HAVE_IO_URING
+
+#include <thrill/io/disk_queues.hpp>
+#include <thrill/io/iostats.hpp>
+
+#include <algorithm>
+
+namespace thrill {
+namespace io {
+
+void UringRequest::completed(bool posted, bool canceled) {
+    LOG << "UringRequest[" << this << "] completed("
+        << posted << "," << canceled << ")";
+
+    if (!canceled)
+    {
+        if (type_ == READ)
+            Stats::GetInstance()->read_finished();
+        else
+            Stats::GetInstance()->write_finished();
+    }
+    else if (posted)
+    {
+        if (type_ == READ)
+            Stats::GetInstance()->read_canceled(bytes_);
+        else
+            Stats::GetInstance()->write_canceled(bytes_);
+    }
+    Request::completed(canceled);
+}
+
+void UringRequest::Prepare(struct io_uring_sqe* sqe) {
+    LOG << "UringRequest[" << this << "] Prepare()"
+        << " transferred_=" << transferred_;
+
+    UringFile* uf = dynamic_cast<UringFile*>(file_.get());
+
+    if (transferred_ == 0) {
+        if (type_ == READ)
+            Stats::GetInstance()->read_started(bytes_);
+        else
+            Stats::GetInstance()->write_started(bytes_);
+    }
+
+    // the length field is 32 bits, larger requests are completed in pieces.
+    size_type length = std::min<size_type>(bytes_ - transferred_, 1u << 30);
+
+    sqe->opcode = (type_ == READ) ? IORING_OP_READ : IORING_OP_WRITE;
+    sqe->fd = uf->file_des_;
+    sqe->addr = reinterpret_cast<uint64_t>(
+        static_cast<char*>(buffer_) + transferred_);
+    sqe->len = static_cast<uint32_t>(length);
+    sqe->off = offset_ + transferred_;
+    // indirection, so the I/O system retains a counting_ptr reference
+    sqe->user_data = reinterpret_cast<uint64_t>(new RequestPtr(this));
+}
+
+//! Cancel the request
+//!
+//! Routine is called by user, as part of the request interface.
+bool UringRequest::cancel() {
+    LOG << "UringRequest[" << this << "] cancel()";
+
+    if (!file_) return false;
+
+    RequestPtr req(this);
+    UringQueue* queue = dynamic_cast<UringQueue*>(
+        DiskQueues::GetInstance()->GetQueue(file_->get_queue_id()));
+    return queue->CancelRequest(req.get());
+}
+
+} // namespace io
+} // namespace thrill
+
+#endif // #if THRILL_HAVE_IO_URING
+
+/******************************************************************************/
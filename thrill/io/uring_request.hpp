@@ -0,0 +1,71 @@
+/*******************************************************************************
+ * thrill/io/uring_request.hpp
+ *
+ * Request for an UringFile.
+ *
+ * Part of Project Thrill - http://project-thrill.org
+ *
+ * Copyright (C) 2016 Timo Bingmann <tb@panthema.net>
+ *
+ * All rights reserved. Published under the BSD-2 license in the LICENSE file.
+ ******************************************************************************/
+
+#pragma once
+#ifndef THRILL_IO_URING_REQUEST_HEADER
+#define THRILL_IO_URING_REQUEST_HEADER
+
+#include <thrill/io/uring_file.hpp>
+
+#if THRILL_HAVE_IO_URING
+
+#include <thrill/io/request.hpp>
+
+#include <linux/io_uring.h>
+
+namespace thrill {
+namespace io {
+
+//! \addtogroup io_layer_req
+//! \{
+
+//! Request for an UringFile.
+class UringRequest final : public Request
+{
+    friend class UringQueue;
+
+    //! number of bytes already transferred, a request is resubmitted until
+    //! all are.
+    size_type transferred_ = 0;
+
+public:
+    UringRequest(
+        const CompletionHandler& on_complete,
+        const FileBasePtr& file,
+        void* buffer, offset_type offset, size_type bytes,
+        ReadOrWriteType type)
+        : Request(on_complete, file, buffer, offset, bytes, type) {
+        assert(dynamic_cast<UringFile*>(file.get()));
+        LOG << "UringRequest[" << this << "]" << " UringRequest"
+            << "(file=" << file << " buffer=" << buffer
+            << " offset=" << offset << " bytes=" << bytes
+            << " type=" << type << ")";
+    }
+
+    //! fill the submission queue entry for the remaining bytes
+    void Prepare(struct io_uring_sqe* sqe);
+
+    bool cancel() final;
+    void completed(bool posted, bool canceled);
+    void completed(bool canceled) final { completed(true, canceled); }
+};
+
+//! \}
+
+} // namespace io
+} // namespace thrill
+
+#endif // #if THRILL_HAVE_IO_URING
+
+#endif // !THRILL_IO_URING_REQUEST_HEADER
+
+/******************************************************************************/
@@ -16,6 +16,7 @@
 #define THRILL_NET_CONNECTION_HEADER
 
 #include <thrill/common/config.hpp>
+#include <thrill/common/defines.hpp>
 #include <thrill/common/logger.hpp>
 #include <thrill/common/porting.hpp>
 #include <thrill/data/serialization.hpp>
@@ -38,6 +39,12 @@ namespace net {
 //! \addtogroup net_layer
 //! \{
 
+//! One (data,size) piece of a gather list passed to Connection::SendVec().
+struct IoVec {
+    const void* data;
+    size_t      size;
+};
+
 /*!
  * A Connection represents a link to another peer in a network group. The link
  * need not be an actual stateful TCP connection, but may be reliable and
@@ -98,6 +105,17 @@ public:
     virtual ssize_t SendOne(const void* data, size_t size,
                             Flags flags = NoFlags) = 0;
 
+    //! Non-blocking send of a gather list of count (data,size) pieces in one
+    //! call, like writev(). returns number of bytes possible to send, which may
+    //! end inside any piece. check errno for errors. The default implementation
+    //! sends only from the first piece.
+    virtual ssize_t SendVec(const IoVec* vec, size_t count,
+                            Flags flags = NoFlags) {
+        assert(count > 0);
+        common::UNUSED(count);
+        return SendOne(vec[0].data, vec[0].size, flags);
+    }
+
     //! Send any serializable POD item T. if sending fails, a net::Exception is
     //! thrown.
     template <typename T>
@@ -29,6 +29,7 @@
 #include <functional>
 #include <queue>
 #include <string>
+#include <unordered_map>
 #include <vector>
 
 namespace thrill {
@@ -513,6 +514,126 @@ private:
 
 /******************************************************************************/
 
+/*!
+ * AsyncWriteGather is a write queue for one Connection holding Buffers and
+ * Blocks which are sent back-to-back. Each time the socket is writable, it
+ * sends as many queued pieces as possible in one Connection::SendVec() call,
+ * hence a Multiplexer header and its block payload, as well as consecutive
+ * blocks queued for the same connection, need only a single system call.
+ * Callbacks are called in order as their pieces are completely sent.
+ */
+class AsyncWriteGather
+{
+public:
+    //! Construct empty write queue for a connection
+    explicit AsyncWriteGather(Connection& conn)
+        : conn_(&conn) { }
+
+    //! non-copyable: the dispatcher holds pointers to the object
+    AsyncWriteGather(const AsyncWriteGather&) = delete;
+    AsyncWriteGather& operator = (const AsyncWriteGather&) = delete;
+
+    //! append a buffer to the queue, callback is called when it was sent.
+    void Append(Buffer&& buffer, const AsyncWriteCallback& callback) {
+        assert(buffer.size() != 0);
+        pieces_.emplace_back(std::move(buffer), data::PinnedBlock(), callback);
+    }
+
+    //! append a block to the queue, callback is called when it was sent.
+    void Append(data::PinnedBlock&& block, const AsyncWriteCallback& callback) {
+        assert(block.size() != 0);
+        pieces_.emplace_back(Buffer(), std::move(block), callback);
+    }
+
+    //! Should be called when the socket is writable
+    bool operator () () {
+        IoVec vec[max_pieces_];
+        size_t count = 0;
+        for (auto it = pieces_.begin();
+             it != pieces_.end() && count < max_pieces_; ++it, ++count) {
+            vec[count].data = it->data();
+            vec[count].size = it->size();
+        }
+        assert(count != 0);
+        vec[0].data = reinterpret_cast<const uint8_t*>(vec[0].data)
+                      + front_written_;
+        vec[0].size -= front_written_;
+
+        ssize_t r = conn_->SendVec(vec, count);
+
+        if (r <= 0) {
+            if (errno == EINTR || errno == EAGAIN) return true;
+
+            // signal artificial IsDone, for clean up.
+            std::deque<Piece, mem::GPoolAllocator<Piece> > pieces;
+            std::swap(pieces, pieces_);
+            front_written_ = 0;
+
+            if (errno == EPIPE) {
+                LOG1 << "AsyncWriteGather() got SIGPIPE";
+                for (Piece& p : pieces) {
+                    if (p.callback) p.callback(*conn_);
+                }
+                return false;
+            }
+            throw Exception("AsyncWriteGather() error in send", errno);
+        }
+
+        size_t written = front_written_ + r;
+        while (pieces_.size() && written >= pieces_.front().size()) {
+            written -= pieces_.front().size();
+            // release the piece before calling back, the callback may append
+            // new pieces.
+            AsyncWriteCallback callback = std::move(pieces_.front().callback);
+            pieces_.pop_front();
+            if (callback) callback(*conn_);
+        }
+        front_written_ = written;
+
+        return !pieces_.empty();
+    }
+
+    bool IsDone() const { return pieces_.empty(); }
+
+    //! Connection of this writer
+    Connection& conn() const { return *conn_; }
+
+    //! number of pieces still queued
+    size_t size() const { return pieces_.size(); }
+
+private:
+    //! maximum number of pieces sent in one call
+    static constexpr size_t max_pieces_ = 64;
+
+    //! one queued Buffer or Block
+    struct Piece {
+        Buffer             buffer;
+        data::PinnedBlock  block;
+        AsyncWriteCallback callback;
+
+        Piece(Buffer&& b, data::PinnedBlock&& pb, const AsyncWriteCallback& cb)
+            : buffer(std::move(b)), block(std::move(pb)), callback(cb) { }
+
+        const uint8_t * data() const {
+            return buffer.size() ? buffer.data() : block.data_begin();
+        }
+        size_t size() const {
+            return buffer.size() ? buffer.size() : block.size();
+        }
+    };
+
+    //! Connection reference
+    Connection* conn_;
+
+    //! queue of pieces to send
+    std::deque<Piece, mem::GPoolAllocator<Piece> > pieces_;
+
+    //! size of the front piece already written
+    size_t front_written_ = 0;
+};
+
+/******************************************************************************/
+
 /*!
  * Dispatcher is a high level wrapper for asynchronous callback processing.. One
  * can register Connection objects for readability and writability checks,
@@ -629,13 +750,8 @@ public:
             return;
         }
 
-        // add new async writer object
-        async_write_.emplace_back(c, std::move(buffer), done_cb);
-
-        // register write callback
-        AsyncWriteBuffer& awb = async_write_.back();
-        AddWrite(c, AsyncCallback::make<
-                     AsyncWriteBuffer, & AsyncWriteBuffer::operator ()>(&awb));
+        // append to the connection's async writer object
+        WriteGather(c).Append(std::move(buffer), done_cb);
     }
 
     //! asynchronously write buffer and callback when delivered. The buffer is
@@ -650,13 +766,26 @@ public:
             return;
         }
 
-        // add new async writer object
-        async_write_block_.emplace_back(c, std::move(block), done_cb);
+        // append to the connection's async writer object
+        WriteGather(c).Append(std::move(block), done_cb);
+    }
 
-        // register write callback
-        AsyncWriteBlock& awb = async_write_block_.back();
-        AddWrite(c, AsyncCallback::make<
-                     AsyncWriteBlock, & AsyncWriteBlock::operator ()>(&awb));
+    //! asynchronously write a header buffer followed by a block, and callback
+    //! when both are delivered. Both are MOVED into the async writer and sent
+    //! with one system call if possible.
+    virtual void AsyncWrite(
+        Connection& c, Buffer&& buffer, data::PinnedBlock&& block,
+        const AsyncWriteCallback& done_cb = AsyncWriteCallback()) {
+        assert(c.IsValid());
+
+        if (block.size() == 0)
+            return AsyncWrite(c, std::move(buffer), done_cb);
+        if (buffer.size() == 0)
+            return AsyncWrite(c, std::move(block), done_cb);
+
+        AsyncWriteGather& awg = WriteGather(c);
+        awg.Append(std::move(buffer), AsyncWriteCallback());
+        awg.Append(std::move(block), done_cb);
     }
 
     //! asynchronously write buffer and callback when delivered. COPIES the data
@@ -720,15 +849,16 @@ public:
             async_read_.pop_front();
         }
         while (async_write_.size() && async_write_.front().IsDone()) {
+            auto it = async_write_tail_.find(&async_write_.front().conn());
+            if (it != async_write_tail_.end() &&
+                it->second == &async_write_.front())
+                async_write_tail_.erase(it);
             async_write_.pop_front();
         }
 
         while (async_read_block_.size() && async_read_block_.front().IsDone()) {
             async_read_block_.pop_front();
         }
-        while (async_write_block_.size() && async_write_block_.front().IsDone()) {
-            async_write_block_.pop_front();
-        }
     }
 
     //! Loop over Dispatch() until terminate_ flag is set.
@@ -750,7 +880,7 @@ public:
 
     //! Check whether there are still AsyncWrite()s in the queue.
     bool HasAsyncWrites() const {
-        return (async_write_.size() != 0) || (async_write_block_.size() != 0);
+        return async_write_.size() != 0;
     }
 
     //! \}
@@ -865,17 +995,39 @@ protected:
     std::deque<AsyncReadBuffer,
                mem::GPoolAllocator<AsyncReadBuffer> > async_read_;
 
-    //! deque of asynchronous writers
-    std::deque<AsyncWriteBuffer,
-               mem::GPoolAllocator<AsyncWriteBuffer> > async_write_;
+    //! deque of asynchronous writers, one per connection with pending writes
+    std::deque<AsyncWriteGather,
+               mem::GPoolAllocator<AsyncWriteGather> > async_write_;
+
+    //! map of connections to their last asynchronous writer in async_write_,
+    //! to which further writes are appended while it is not done.
+    std::unordered_map<
+        Connection*, AsyncWriteGather*,
+        std::hash<Connection*>, std::equal_to<Connection*>,
+        mem::GPoolAllocator<std::pair<Connection* const, AsyncWriteGather*> > >
+    async_write_tail_;
 
     //! deque of asynchronous readers
     std::deque<AsyncReadByteBlock,
                mem::GPoolAllocator<AsyncReadByteBlock> > async_read_block_;
 
-    //! deque of asynchronous writers
-    std::deque<AsyncWriteBlock,
-               mem::GPoolAllocator<AsyncWriteBlock> > async_write_block_;
+    //! Return the pending asynchronous writer of a connection, or create and
+    //! register a new one.
+    AsyncWriteGather& WriteGather(Connection& c) {
+        auto it = async_write_tail_.find(&c);
+        if (it != async_write_tail_.end() && !it->second->IsDone())
+            return *it->second;
+
+        // add new async writer object
+        async_write_.emplace_back(c);
+        AsyncWriteGather& awg = async_write_.back();
+        async_write_tail_[&c] = &awg;
+
+        // register write callback
+        AddWrite(c, AsyncCallback::make<
+                     AsyncWriteGather, & AsyncWriteGather::operator ()>(&awg));
+        return awg;
+    }
 
     //! Default exception handler
     static bool ExceptionCallback(Connection& c) {
@@ -126,8 +126,8 @@ void DispatcherThread::AsyncWrite(
     // the following captures the move-only buffer in a lambda.
     Enqueue([=, &c,
              b1 = std::move(buffer), b2 = std::move(block)]() mutable {
-                dispatcher_->AsyncWrite(c, std::move(b1));
-                dispatcher_->AsyncWrite(c, std::move(b2), done_cb);
+                dispatcher_->AsyncWrite(c, std::move(b1), std::move(b2),
+                                        done_cb);
             });
     WakeUpThread();
 }
@@ -177,6 +177,13 @@ void DispatcherThread::Work() {
             }
         }
 
+        // check once again for termination: Terminate() may have been called
+        // while busy_ was false, in which case it did not interrupt select().
+        if (terminate_ && !dispatcher_->HasAsyncWrites()) {
+            busy_ = false;
+            break;
+        }
+
         // run one dispatch
         dispatcher_->Dispatch();
 
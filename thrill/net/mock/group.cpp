@@ -354,7 +354,9 @@ void Dispatcher::DispatchOne(const std::chrono::milliseconds& timeout) {
             d_lock.lock();
             c_lock.lock();
 
-            if (ret) break;
+            // virtual sockets are always writable, hence call again until the
+            // writer has sent all its pieces.
+            if (ret) continue;
             w.write_cb.pop_front();
         }
 
@@ -0,0 +1,605 @@
+/*******************************************************************************
+ * thrill/net/shm/group.cpp
+ *
+ * Part of Project Thrill - http://project-thrill.org
+ *
+ * Copyright (C) 2016 Timo Bingmann <tb@panthema.net>
+ *
+ * All rights reserved. Published under the BSD-2 license in the LICENSE file.
+ ******************************************************************************/
+
+#include <thrill/net/shm/group.hpp>
+
+#if THRILL_HAVE_NET_SHM
+
+#include <thrill/common/die.hpp>
+#include <thrill/common/logger.hpp>
+#include <thrill/common/system_exception.hpp>
+#include <thrill/net/exception.hpp>
+
+#include <fcntl.h>
+#include <linux/futex.h>
+#include <signal.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cerrno>
+#include <climits>
+#include <cstring>
+#include <ctime>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace thrill {
+namespace net {
+namespace shm {
+
+static_assert(ATOMIC_INT_LOCK_FREE == 2 && ATOMIC_LLONG_LOCK_FREE == 2,
+              "shm network requires address-free lock-free atomics");
+
+static_assert((Group::kRingSize & (Group::kRingSize - 1)) == 0,
+              "kRingSize must be a power of two");
+
+/******************************************************************************/
+// Shared Memory Layout
+
+//! magic value written by host 0 when the shared memory file is ready
+static constexpr uint64_t kSegmentMagic = 0x5448524C53484D31ull; // "THRLSHM1"
+
+//! header at the beginning of the shared memory file
+struct SegmentHeader {
+    //! set to kSegmentMagic once the segment is initialized
+    std::atomic<uint64_t> magic;
+    //! process id of host 0, which created the segment
+    std::atomic<uint64_t> pid;
+};
+
+struct Doorbell {
+    //! futex word incremented to wake sleeping threads
+    alignas(64) std::atomic<uint32_t> seq;
+    //! number of threads sleeping or about to sleep on seq
+    std::atomic<uint32_t>             waiters;
+};
+
+struct Ring {
+    //! total bytes written by the producer
+    alignas(64) std::atomic<uint64_t> head;
+    //! total bytes consumed by the consumer
+    alignas(64) std::atomic<uint64_t> tail;
+    //! set by the producer once it will send no more data
+    alignas(64) std::atomic<uint32_t> closed;
+};
+
+/*!
+ * The mapped shared memory region: a header, the doorbells of all hosts, the
+ * headers of num_hosts^2 ring buffers, and their data areas. All fields are
+ * zero-initialized by the kernel, which is the initial state of all atomics.
+ */
+class Segment
+{
+public:
+    //! take ownership of a mapping of size Size(num_hosts)
+    Segment(void* base, size_t num_hosts)
+        : base_(reinterpret_cast<char*>(base)), num_hosts_(num_hosts) { }
+
+    //! non-copyable: delete copy-constructor
+    Segment(const Segment&) = delete;
+    //! non-copyable: delete assignment operator
+    Segment& operator = (const Segment&) = delete;
+
+    ~Segment() {
+        if (munmap(base_, Size(num_hosts_)) != 0)
+            LOG1 << "shm::Segment: munmap() failed: " << strerror(errno);
+    }
+
+    //! size of the mapping for num_hosts hosts
+    static size_t Size(size_t num_hosts) {
+        return DataOffset(num_hosts) + num_hosts * num_hosts * Group::kRingSize;
+    }
+
+    size_t num_hosts() const { return num_hosts_; }
+
+    SegmentHeader* header() const {
+        return reinterpret_cast<SegmentHeader*>(base_);
+    }
+
+    Doorbell* bell(size_t host) const {
+        assert(host < num_hosts_);
+        return reinterpret_cast<Doorbell*>(
+            base_ + sizeof(Ring) + host * sizeof(Doorbell));
+    }
+
+    Ring* ring(size_t from, size_t to) const {
+        assert(from < num_hosts_ && to < num_hosts_);
+        return reinterpret_cast<Ring*>(
+            base_ + sizeof(Ring) + num_hosts_ * sizeof(Doorbell)
+            + (from * num_hosts_ + to) * sizeof(Ring));
+    }
+
+    char * data(size_t from, size_t to) const {
+        assert(from < num_hosts_ && to < num_hosts_);
+        return base_ + DataOffset(num_hosts_)
+               + (from * num_hosts_ + to) * Group::kRingSize;
+    }
+
+private:
+    //! base address of the mapping
+    char* base_;
+
+    //! number of hosts
+    size_t num_hosts_;
+
+    //! offset of the first ring's data area, aligned to 4 KiB pages.
+    static size_t DataOffset(size_t num_hosts) {
+        size_t off = sizeof(Ring) + num_hosts * sizeof(Doorbell)
+                     + num_hosts * num_hosts * sizeof(Ring);
+        return (off + 4095) & ~size_t(4095);
+    }
+};
+
+static_assert(sizeof(SegmentHeader) <= sizeof(Ring),
+              "SegmentHeader must fit into the first cache lines");
+
+/******************************************************************************/
+// Futex Doorbells
+
+static inline
+void FutexWait(std::atomic<uint32_t>* addr, uint32_t value,
+               const std::chrono::milliseconds& timeout) {
+    struct timespec ts;
+    ts.tv_sec = timeout.count() / 1000;
+    ts.tv_nsec = (timeout.count() % 1000) * 1000000;
+    // the futex is shared between processes, hence not FUTEX_PRIVATE_FLAG.
+    syscall(SYS_futex, reinterpret_cast<uint32_t*>(addr),
+            FUTEX_WAIT, value, &ts, nullptr, 0);
+}
+
+static inline
+void FutexWake(std::atomic<uint32_t>* addr) {
+    syscall(SYS_futex, reinterpret_cast<uint32_t*>(addr),
+            FUTEX_WAKE, INT_MAX, nullptr, nullptr, 0);
+}
+
+//! Wake threads sleeping on bell after publishing data or ring space. The
+//! fence pairs with the one in Group::Wait(): either the sleeper sees the new
+//! ring state, or we see its waiters count.
+static inline
+void RingBell(Doorbell* bell) {
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    if (bell->waiters.load(std::memory_order_relaxed) != 0) {
+        bell->seq.fetch_add(1);
+        FutexWake(&bell->seq);
+    }
+}
+
+/******************************************************************************/
+// shm::Connection
+
+void Connection::Initialize(Group* group, size_t peer) {
+    group_ = group;
+    peer_ = peer;
+
+    const Segment& seg = *group->segment_;
+    size_t my_rank = group->my_host_rank();
+    tx_ = seg.ring(my_rank, peer);
+    rx_ = seg.ring(peer, my_rank);
+    tx_data_ = seg.data(my_rank, peer);
+    rx_data_ = seg.data(peer, my_rank);
+    peer_bell_ = seg.bell(peer);
+}
+
+std::string Connection::ToString() const {
+    return "peer: " + std::to_string(peer_);
+}
+
+std::ostream& Connection::OutputOstream(std::ostream& os) const {
+    return os << "[shm::Connection"
+              << " group=" << group_
+              << " peer=" << peer_
+              << "]";
+}
+
+bool Connection::IsReadable() const {
+    return rx_->head.load(std::memory_order_acquire) !=
+           rx_->tail.load(std::memory_order_relaxed) ||
+           rx_->closed.load(std::memory_order_acquire) != 0;
+}
+
+bool Connection::IsWritable() const {
+    return tx_->head.load(std::memory_order_relaxed) -
+           tx_->tail.load(std::memory_order_acquire) < Group::kRingSize;
+}
+
+void Connection::Close() {
+    tx_->closed.store(1, std::memory_order_release);
+    RingBell(peer_bell_);
+}
+
+ssize_t Connection::SendVec(const IoVec* vec, size_t count, Flags /* flags */) {
+    uint64_t head = tx_->head.load(std::memory_order_relaxed);
+    uint64_t tail = tx_->tail.load(std::memory_order_acquire);
+
+    size_t free = Group::kRingSize - (head - tail);
+    if (free == 0) {
+        errno = EAGAIN;
+        return -1;
+    }
+
+    // copy as many pieces as fit into the ring
+    size_t total = 0;
+    for (size_t i = 0; i < count && free != 0; ++i) {
+        const char* cdata = reinterpret_cast<const char*>(vec[i].data);
+        size_t size = std::min(vec[i].size, free);
+
+        size_t pos = (head + total) & (Group::kRingSize - 1);
+        size_t first = std::min(size, Group::kRingSize - pos);
+        std::copy(cdata, cdata + first, tx_data_ + pos);
+        std::copy(cdata + first, cdata + size, tx_data_);
+
+        total += size;
+        free -= size;
+    }
+
+    tx_->head.store(head + total, std::memory_order_release);
+    RingBell(peer_bell_);
+
+    // set errno : success (other syscalls may have failed)
+    errno = 0;
+    tx_bytes_ += total;
+    return static_cast<ssize_t>(total);
+}
+
+ssize_t Connection::SendOne(const void* data, size_t size, Flags flags) {
+    IoVec vec = { data, size };
+    return SendVec(&vec, 1, flags);
+}
+
+void Connection::SyncSend(const void* data, size_t size, Flags flags) {
+    const char* cdata = reinterpret_cast<const char*>(data);
+
+    while (size != 0) {
+        ssize_t r = SendOne(cdata, size, flags);
+        if (r < 0) {
+            group_->Wait([this]() { return IsWritable(); },
+                         std::chrono::milliseconds(1000));
+            continue;
+        }
+        cdata += r;
+        size -= static_cast<size_t>(r);
+    }
+}
+
+ssize_t Connection::RecvOne(void* out_data, size_t size) {
+    uint64_t tail = rx_->tail.load(std::memory_order_relaxed);
+    uint64_t head = rx_->head.load(std::memory_order_acquire);
+
+    if (head == tail) {
+        if (rx_->closed.load(std::memory_order_acquire) != 0) {
+            // recheck: the peer may have sent data just before closing.
+            head = rx_->head.load(std::memory_order_acquire);
+            if (head == tail) {
+                errno = 0;
+                return 0;
+            }
+        }
+        else {
+            errno = EAGAIN;
+            return -1;
+        }
+    }
+
+    char* out_cdata = reinterpret_cast<char*>(out_data);
+    size = std::min<size_t>(size, head - tail);
+
+    size_t pos = tail & (Group::kRingSize - 1);
+    size_t first = std::min(size, Group::kRingSize - pos);
+    std::copy(rx_data_ + pos, rx_data_ + pos + first, out_cdata);
+    std::copy(rx_data_, rx_data_ + (size - first), out_cdata + first);
+
+    rx_->tail.store(tail + size, std::memory_order_release);
+    RingBell(peer_bell_);
+
+    errno = 0;
+    rx_bytes_ += size;
+    return static_cast<ssize_t>(size);
+}
+
+void Connection::SyncRecv(void* out_data, size_t size) {
+    char* out_cdata = reinterpret_cast<char*>(out_data);
+
+    while (size != 0) {
+        ssize_t r = RecvOne(out_cdata, size);
+        if (r < 0) {
+            group_->Wait([this]() { return IsReadable(); },
+                         std::chrono::milliseconds(1000));
+            continue;
+        }
+        if (r == 0) {
+            throw Exception("shm::Connection::SyncRecv() peer closed "
+                            "connection " + ToString());
+        }
+        out_cdata += r;
+        size -= static_cast<size_t>(r);
+    }
+}
+
+void Connection::SyncSendRecv(const void* send_data, size_t send_size,
+                              void* recv_data, size_t recv_size) {
+    SyncSend(send_data, send_size, NoFlags);
+    SyncRecv(recv_data, recv_size);
+}
+
+/******************************************************************************/
+// shm::Group
+
+Group::Group(size_t my_rank, std::shared_ptr<Segment> segment)
+    : net::Group(my_rank),
+      segment_(std::move(segment)),
+      bell_(segment_->bell(my_rank)) {
+    // create virtual connections, due to complications with non-movable
+    // atomics, use a plain array.
+    size_t num_hosts = segment_->num_hosts();
+    conns_ = std::unique_ptr<Connection[]>(new Connection[num_hosts]);
+    for (size_t i = 0; i < num_hosts; ++i)
+        conns_[i].Initialize(this, i);
+}
+
+Group::~Group() = default;
+
+size_t Group::num_hosts() const {
+    return segment_->num_hosts();
+}
+
+net::Connection& Group::connection(size_t peer) {
+    assert(peer < num_hosts());
+    return conns_[peer];
+}
+
+void Group::Close() {
+    for (size_t i = 0; i < num_hosts(); ++i)
+        conns_[i].Close();
+}
+
+std::unique_ptr<net::Dispatcher> Group::ConstructDispatcher(
+    mem::Manager& mem_manager) const {
+    // construct shm::Dispatcher
+    return std::make_unique<Dispatcher>(mem_manager, *this);
+}
+
+bool Group::Wait(const std::function<bool()>& ready,
+                 const std::chrono::milliseconds& timeout) const {
+    if (ready()) return true;
+
+    uint32_t seq = bell_->seq.load();
+    bell_->waiters.fetch_add(1);
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+
+    // recheck after announcing ourselves as waiter, see RingBell().
+    bool r = ready();
+    if (!r) {
+        FutexWait(&bell_->seq, seq, timeout);
+        r = ready();
+    }
+
+    bell_->waiters.fetch_sub(1);
+    return r;
+}
+
+void Group::Interrupt() const {
+    bell_->seq.fetch_add(1);
+    FutexWake(&bell_->seq);
+}
+
+std::vector<std::unique_ptr<Group> >
+Group::ConstructLoopbackMesh(size_t num_hosts) {
+
+    // anonymous shared mapping, the ring pages are allocated on first use.
+    void* base = mmap(nullptr, Segment::Size(num_hosts),
+                      PROT_READ | PROT_WRITE,
+                      MAP_SHARED | MAP_ANONYMOUS | MAP_NORESERVE, -1, 0);
+    if (base == MAP_FAILED)
+        throw common::ErrnoException("Could not mmap() shared memory", errno);
+
+    std::shared_ptr<Segment> segment =
+        std::make_shared<Segment>(base, num_hosts);
+
+    std::vector<std::unique_ptr<Group> > groups(num_hosts);
+
+    for (size_t i = 0; i < groups.size(); ++i) {
+        groups[i] = std::make_unique<Group>(i, segment);
+    }
+
+    return groups;
+}
+
+std::unique_ptr<Group> Group::Construct(
+    size_t my_rank, size_t num_hosts, const std::string& path) {
+
+    static constexpr std::chrono::seconds kConnectTimeout { 60 };
+
+    size_t size = Segment::Size(num_hosts);
+    int fd;
+
+    if (my_rank == 0) {
+        // remove a stale file of a previous crashed run, then create anew.
+        ::unlink(path.c_str());
+
+        fd = ::open(path.c_str(), O_RDWR | O_CREAT | O_EXCL | O_CLOEXEC, 0600);
+        if (fd < 0) {
+            throw common::ErrnoException(
+                      "Could not create shared memory file " + path, errno);
+        }
+        if (::ftruncate(fd, static_cast<off_t>(size)) != 0) {
+            ::close(fd);
+            throw common::ErrnoException(
+                      "Could not resize shared memory file " + path, errno);
+        }
+    }
+    else {
+        // wait for host 0 to create the file
+        auto tp_start = std::chrono::steady_clock::now();
+        while (true) {
+            fd = ::open(path.c_str(), O_RDWR | O_CLOEXEC);
+            if (fd >= 0) {
+                struct stat st;
+                if (::fstat(fd, &st) == 0 &&
+                    static_cast<size_t>(st.st_size) == size) break;
+                ::close(fd);
+            }
+            if (std::chrono::steady_clock::now() - tp_start > kConnectTimeout) {
+                throw Exception(
+                          "Timeout waiting for shared memory file " + path);
+            }
+            std::this_thread::sleep_for(std::chrono::milliseconds(10));
+        }
+    }
+
+    void* base = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    ::close(fd);
+    if (base == MAP_FAILED)
+        throw common::ErrnoException("Could not mmap() " + path, errno);
+
+    std::shared_ptr<Segment> segment =
+        std::make_shared<Segment>(base, num_hosts);
+    SegmentHeader* header = segment->header();
+
+    if (my_rank == 0) {
+        header->pid.store(static_cast<uint64_t>(getpid()));
+        header->magic.store(kSegmentMagic, std::memory_order_release);
+    }
+    else {
+        // wait for host 0 to initialize the segment. A file left over by a
+        // crashed run is detected by its creator process being gone.
+        auto tp_start = std::chrono::steady_clock::now();
+        while (header->magic.load(std::memory_order_acquire) != kSegmentMagic ||
+               (::kill(static_cast<pid_t>(header->pid.load()), 0) != 0 &&
+                errno == ESRCH))
+        {
+            if (std::chrono::steady_clock::now() - tp_start > kConnectTimeout) {
+                throw Exception(
+                          "Timeout waiting for shared memory file " + path);
+            }
+            std::this_thread::sleep_for(std::chrono::milliseconds(10));
+        }
+    }
+
+    std::unique_ptr<Group> group =
+        std::make_unique<Group>(my_rank, std::move(segment));
+
+    // handshake: once all hosts have mapped the segment, host 0 removes the
+    // file such that it is cleaned up when the last process exits.
+    if (my_rank == 0) {
+        for (size_t p = 1; p < num_hosts; ++p) {
+            uint64_t rank;
+            group->connection(p).SyncRecv(&rank, sizeof(rank));
+            die_unequal(rank, p);
+        }
+        if (::unlink(path.c_str()) != 0) {
+            throw common::ErrnoException(
+                      "Could not unlink shared memory file " + path, errno);
+        }
+        sLOG << "shm::Group::Construct() all" << num_hosts
+             << "hosts mapped" << path;
+    }
+    else {
+        uint64_t rank = my_rank;
+        group->connection(0).SyncSend(&rank, sizeof(rank));
+    }
+
+    return group;
+}
+
+/******************************************************************************/
+// shm::Dispatcher
+
+Dispatcher::Dispatcher(mem::Manager& mem_manager, const Group& group)
+    : net::Dispatcher(mem_manager), group_(group) {
+    watch_.reserve(group.num_hosts());
+    for (size_t i = 0; i < group.num_hosts(); ++i)
+        watch_.emplace_back(mem_manager_);
+}
+
+Dispatcher::Watch& Dispatcher::GetWatch(net::Connection& c) {
+    assert(dynamic_cast<Connection*>(&c));
+    Connection& sc = static_cast<Connection&>(c);
+    assert(sc.peer() < watch_.size());
+    Watch& w = watch_[sc.peer()];
+    w.conn = &sc;
+    return w;
+}
+
+void Dispatcher::AddRead(net::Connection& c, const Callback& read_cb) {
+    GetWatch(c).read_cb.emplace_back(read_cb);
+}
+
+void Dispatcher::AddWrite(net::Connection& c, const Callback& write_cb) {
+    GetWatch(c).write_cb.emplace_back(write_cb);
+}
+
+void Dispatcher::Cancel(net::Connection& c) {
+    Watch& w = GetWatch(c);
+    if (w.read_cb.size() == 0 && w.write_cb.size() == 0)
+        LOG << "shm::Dispatcher::Cancel() " << c
+            << " called with no callbacks registered.";
+    w.read_cb.clear();
+    w.write_cb.clear();
+}
+
+void Dispatcher::Interrupt() {
+    interrupt_ = true;
+    group_.Interrupt();
+}
+
+bool Dispatcher::AnyReady() const {
+    for (const Watch& w : watch_) {
+        if (w.read_cb.size() && w.conn->IsReadable()) return true;
+        if (w.write_cb.size() && w.conn->IsWritable()) return true;
+    }
+    return false;
+}
+
+bool Dispatcher::RunReady() {
+    bool any = false;
+    for (Watch& w : watch_) {
+        if (w.read_cb.size() && w.conn->IsReadable()) {
+            any = true;
+            // run read callbacks until one returns true (in which case it
+            // wants to be called again), or the read_cb list is empty.
+            while (w.read_cb.size() && w.read_cb.front()() == false) {
+                w.read_cb.pop_front();
+            }
+        }
+        if (w.write_cb.size() && w.conn->IsWritable()) {
+            any = true;
+            while (w.write_cb.size() && w.write_cb.front()() == false) {
+                w.write_cb.pop_front();
+            }
+        }
+    }
+    return any;
+}
+
+void Dispatcher::DispatchOne(const std::chrono::milliseconds& timeout) {
+
+    if (RunReady()) return;
+
+    group_.Wait([this]() { return interrupt_.load() || AnyReady(); },
+                timeout);
+
+    if (interrupt_.exchange(false))
+        sLOG << "DispatchOne interrupt";
+
+    RunReady();
+}
+
+} // namespace shm
+} // namespace net
+} // namespace thrill
+
+#endif // THRILL_HAVE_NET_SHM
+
+/******************************************************************************/
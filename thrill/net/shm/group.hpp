@@ -0,0 +1,290 @@
+/*******************************************************************************
+ * thrill/net/shm/group.hpp
+ *
+ * Implementation of a network between processes on the same machine via ring
+ * buffers in shared memory. All classes: Group, Connection, and Dispatcher are
+ * in this file since they are tightly interdependent.
+ *
+ * Part of Project Thrill - http://project-thrill.org
+ *
+ * Copyright (C) 2016 Timo Bingmann <tb@panthema.net>
+ *
+ * All rights reserved. Published under the BSD-2 license in the LICENSE file.
+ ******************************************************************************/
+
+#pragma once
+#ifndef THRILL_NET_SHM_GROUP_HEADER
+#define THRILL_NET_SHM_GROUP_HEADER
+
+#include <thrill/common/config.hpp>
+
+#if THRILL_HAVE_NET_SHM
+
+#include <thrill/net/dispatcher.hpp>
+#include <thrill/net/group.hpp>
+
+#include <atomic>
+#include <chrono>
+#include <functional>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace thrill {
+namespace net {
+namespace shm {
+
+//! \addtogroup net_shm Shared Memory Network API
+//! \ingroup net
+//! \{
+
+class Group;
+class Dispatcher;
+
+//! The mapped shared memory region of a Group containing the doorbells of all
+//! hosts and the ring buffers between them.
+class Segment;
+
+//! Single-producer single-consumer byte ring buffer in shared memory.
+struct Ring;
+
+//! Futex word of a host on which its threads sleep while waiting for data or
+//! free ring space.
+struct Doorbell;
+
+/*!
+ * A Connection to a peer process on the same machine: it consists of two ring
+ * buffers in shared memory, one for each direction. Like a stream socket,
+ * SendOne() and RecvOne() transfer as many bytes as currently fit or are
+ * available. Instead of kernel socket calls, the data is copied directly into
+ * and out of the shared memory, and the peer is woken via a futex only if it
+ * is sleeping.
+ */
+class Connection final : public net::Connection
+{
+public:
+    //! construct from shm::Group
+    void Initialize(Group* group, size_t peer);
+
+    //! return the peer host id of this Connection
+    size_t peer() const { return peer_; }
+
+    //! \name Base Status Functions
+    //! \{
+
+    bool IsValid() const final { return tx_ != nullptr; }
+
+    std::string ToString() const final;
+
+    std::ostream& OutputOstream(std::ostream& os) const final;
+
+    //! \}
+
+    //! \name Send Functions
+    //! \{
+
+    void SyncSend(
+        const void* data, size_t size, Flags /* flags */ = NoFlags) final;
+
+    ssize_t SendOne(
+        const void* data, size_t size, Flags flags = NoFlags) final;
+
+    ssize_t SendVec(
+        const IoVec* vec, size_t count, Flags flags = NoFlags) final;
+
+    //! \}
+
+    //! \name Receive Functions
+    //! \{
+
+    void SyncRecv(void* out_data, size_t size) final;
+
+    ssize_t RecvOne(void* out_data, size_t size) final;
+
+    //! \}
+
+    //! \name Paired SendReceive Methods
+    //! \{
+
+    void SyncSendRecv(const void* send_data, size_t send_size,
+                      void* recv_data, size_t recv_size) final;
+
+    //! \}
+
+    //! whether RecvOne() will not block: there is data or the peer closed.
+    bool IsReadable() const;
+
+    //! whether SendOne() will not block: there is free space in the ring.
+    bool IsWritable() const;
+
+    //! mark outgoing ring as closed and wake the peer.
+    void Close();
+
+private:
+    //! Reference to our group.
+    Group* group_ = nullptr;
+
+    //! Outgoing peer id of this Connection.
+    size_t peer_ = size_t(-1);
+
+    //! ring buffer from us to the peer
+    Ring* tx_ = nullptr;
+
+    //! ring buffer from the peer to us
+    Ring* rx_ = nullptr;
+
+    //! data area of the tx_ ring buffer
+    char* tx_data_ = nullptr;
+
+    //! data area of the rx_ ring buffer
+    char* rx_data_ = nullptr;
+
+    //! the peer's doorbell, rung after sending or freeing ring space.
+    Doorbell* peer_bell_ = nullptr;
+};
+
+/*!
+ * A Group of processes on the same machine communicating via a shared memory
+ * Segment. The Segment is either an anonymous mapping shared by threads, as
+ * constructed by ConstructLoopbackMesh(), or a file in /dev/shm which is mapped
+ * by all processes, as constructed by Construct().
+ */
+class Group final : public net::Group
+{
+    static constexpr bool debug = false;
+
+public:
+    //! size of each directed ring buffer between two hosts
+    static constexpr size_t kRingSize = 1024 * 1024;
+
+    //! \name Base Functions
+    //! \{
+
+    //! Initialize a Group for the given rank on a shared memory Segment
+    Group(size_t my_rank, std::shared_ptr<Segment> segment);
+
+    ~Group();
+
+    size_t num_hosts() const final;
+
+    net::Connection& connection(size_t peer) final;
+
+    void Close() final;
+
+    std::unique_ptr<net::Dispatcher> ConstructDispatcher(
+        mem::Manager& mem_manager) const final;
+
+    //! \}
+
+    /*!
+     * Construct a shared memory network with num_hosts peers in this process
+     * and deliver Group contexts for each of them.
+     */
+    static std::vector<std::unique_ptr<Group> > ConstructLoopbackMesh(
+        size_t num_hosts);
+
+    /*!
+     * Construct the Group of host my_rank out of num_hosts processes on this
+     * machine, which meet in the shared memory file at path. Host 0 creates
+     * the file and removes it again once all hosts have mapped it.
+     */
+    static std::unique_ptr<Group> Construct(
+        size_t my_rank, size_t num_hosts, const std::string& path);
+
+    /*!
+     * Sleep on this host's doorbell until ready() returns true, or until the
+     * timeout expires. Returns the last result of ready().
+     */
+    bool Wait(const std::function<bool()>& ready,
+              const std::chrono::milliseconds& timeout) const;
+
+    //! Wake all threads sleeping on this host's doorbell.
+    void Interrupt() const;
+
+private:
+    //! shared memory mapping
+    std::shared_ptr<Segment> segment_;
+
+    //! this host's doorbell
+    Doorbell* bell_;
+
+    //! vector of virtual connection objects to remote peers
+    std::unique_ptr<Connection[]> conns_;
+
+    //! for access to segment_
+    friend class Connection;
+};
+
+/*!
+ * A Dispatcher which polls the ring buffers of watched Connections for
+ * readiness, and sleeps on the host's doorbell while none are ready.
+ */
+class Dispatcher final : public net::Dispatcher
+{
+    static constexpr bool debug = false;
+
+public:
+    //! type for file descriptor readiness callbacks
+    using Callback = AsyncCallback;
+
+    Dispatcher(mem::Manager& mem_manager, const Group& group);
+
+    //! \name Implementation of Virtual Methods
+    //! \{
+
+    void AddRead(net::Connection& c, const Callback& read_cb) final;
+
+    void AddWrite(net::Connection& c, const Callback& write_cb) final;
+
+    void Cancel(net::Connection& c) final;
+
+    void Interrupt() final;
+
+    void DispatchOne(const std::chrono::milliseconds& timeout) final;
+
+    //! \}
+
+private:
+    //! the Group whose doorbell we sleep on
+    const Group& group_;
+
+    //! callback vectors per watched connection
+    struct Watch {
+        //! the Connection to the peer, set by the first Add*() call.
+        Connection           * conn = nullptr;
+        //! queue of callbacks for the connection
+        mem::deque<Callback> read_cb, write_cb;
+
+        explicit Watch(mem::Manager& mem_manager)
+            : read_cb(mem::Allocator<Callback>(mem_manager)),
+              write_cb(mem::Allocator<Callback>(mem_manager)) { }
+    };
+
+    //! callbacks indexed by peer id
+    std::vector<Watch> watch_;
+
+    //! flag set by Interrupt(), such that it is not lost if the dispatcher
+    //! thread is currently not sleeping.
+    std::atomic<bool> interrupt_ { false };
+
+    //! lookup method
+    Watch& GetWatch(net::Connection& c);
+
+    //! check whether any watched connection has a pending event
+    bool AnyReady() const;
+
+    //! run the callbacks of all ready connections. returns true if any ran.
+    bool RunReady();
+};
+
+//! \}
+
+} // namespace shm
+} // namespace net
+} // namespace thrill
+
+#endif // THRILL_HAVE_NET_SHM
+
+#endif // !THRILL_NET_SHM_GROUP_HEADER
+
+/******************************************************************************/
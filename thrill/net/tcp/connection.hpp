@@ -19,6 +19,7 @@
 #include <thrill/net/connection.hpp>
 #include <thrill/net/tcp/socket.hpp>
 
+#include <algorithm>
 #include <cassert>
 #include <cerrno>
 #include <cstdio>
@@ -180,6 +181,25 @@ public:
         return wb;
     }
 
+    ssize_t SendVec(const IoVec* vec, size_t count, Flags flags) final {
+#if __APPLE__
+        // MacOSX has no MSG_DONTWAIT
+        SetNonBlocking(true);
+#endif
+        static constexpr size_t max_count = 64;
+        struct iovec iov[max_count];
+        count = std::min(count, max_count);
+        for (size_t i = 0; i < count; ++i) {
+            iov[i].iov_base = const_cast<void*>(vec[i].data);
+            iov[i].iov_len = vec[i].size;
+        }
+        int f = MSG_DONTWAIT;
+        if (flags & MsgMore) f |= MSG_MORE;
+        ssize_t wb = socket_.sendmsg_one(iov, count, f);
+        if (wb > 0) tx_bytes_ += wb;
+        return wb;
+    }
+
     void SyncRecv(void* out_data, size_t size) final {
         SetNonBlocking(false);
         if (socket_.recv(out_data, size) != static_cast<ssize_t>(size))
@@ -0,0 +1,217 @@
+/*******************************************************************************
+ * thrill/net/tcp/epoll_dispatcher.cpp
+ *
+ * Asynchronous callback wrapper around epoll()
+ *
+ * Part of Project Thrill - http://project-thrill.org
+ *
+ * Copyright (C) 2016 Timo Bingmann <tb@panthema.net>
+ *
+ * All rights reserved. Published under the BSD-2 license in the LICENSE file.
+ ******************************************************************************/
+
+#include <thrill/net/tcp/epoll_dispatcher.hpp>
+
+#if THRILL_HAVE_NET_TCP_EPOLL
+
+#include <algorithm>
+#include <limits>
+
+namespace thrill {
+namespace net {
+namespace tcp {
+
+EpollDispatcher::EpollDispatcher(mem::Manager& mem_manager)
+    : net::Dispatcher(mem_manager) {
+
+    epoll_fd_ = epoll_create1(EPOLL_CLOEXEC);
+    if (epoll_fd_ < 0)
+        throw Exception("EpollDispatcher() could not create epoll fd", errno);
+
+    // allocate self-pipe
+    common::MakePipe(self_pipe_);
+
+    if (!Socket::SetNonBlocking(self_pipe_[0], true)) {
+        LOG1 << "EpollDispatcher() cannot set up self-pipe for non-blocking reads";
+    }
+
+    // Ignore PIPE signals (received when writing to closed sockets)
+    signal(SIGPIPE, SIG_IGN);
+
+    // wait interrupts via self-pipe.
+    AddRead(self_pipe_[0],
+            Callback::make<EpollDispatcher,
+                           & EpollDispatcher::SelfPipeCallback>(this));
+}
+
+EpollDispatcher::~EpollDispatcher() {
+    ::close(epoll_fd_);
+    ::close(self_pipe_[0]);
+    ::close(self_pipe_[1]);
+}
+
+void EpollDispatcher::Update(int fd) {
+    Watch& w = watch_[fd];
+
+    uint32_t events = 0;
+    if (w.read_cb.size()) events |= EPOLLIN;
+    if (w.write_cb.size()) events |= EPOLLOUT;
+    if (events || w.except_cb) events |= EPOLLPRI;
+
+    if (events == w.events) return;
+
+    if (events == 0)
+        return Unregister(fd);
+
+    struct epoll_event ev;
+    ev.events = events;
+    ev.data.fd = fd;
+
+    int op = w.events ? EPOLL_CTL_MOD : EPOLL_CTL_ADD;
+    int r = epoll_ctl(epoll_fd_, op, fd, &ev);
+
+    // a closed fd is removed from the epoll set implicitly, hence the fd
+    // number may be reused without us knowing.
+    if (r != 0 && op == EPOLL_CTL_MOD && errno == ENOENT)
+        r = epoll_ctl(epoll_fd_, EPOLL_CTL_ADD, fd, &ev);
+
+    if (r != 0)
+        throw Exception("EpollDispatcher() epoll_ctl() failed", errno);
+
+    w.events = events;
+}
+
+void EpollDispatcher::Unregister(int fd) {
+    Watch& w = watch_[fd];
+    if (w.events == 0) return;
+
+    struct epoll_event ev;
+    ev.events = 0;
+    ev.data.fd = fd;
+
+    // ignore errors from already closed fds.
+    if (epoll_ctl(epoll_fd_, EPOLL_CTL_DEL, fd, &ev) != 0 &&
+        errno != ENOENT && errno != EBADF) {
+        throw Exception("EpollDispatcher() epoll_ctl() failed", errno);
+    }
+
+    w.events = 0;
+}
+
+//! Run one iteration of dispatching epoll_wait().
+void EpollDispatcher::DispatchOne(const std::chrono::milliseconds& timeout) {
+
+    int timeout_ms = static_cast<int>(
+        std::min<std::chrono::milliseconds::rep>(
+            timeout.count(), std::numeric_limits<int>::max()));
+
+    LOG << "Performing epoll_wait() with timeout " << timeout_ms;
+
+    int r = epoll_wait(epoll_fd_, events_, max_events_, timeout_ms);
+
+    if (r < 0) {
+        // if we caught a signal, this is intended to interrupt a epoll_wait().
+        if (errno == EINTR) {
+            LOG << "Dispatch(): epoll_wait() was interrupted due to a signal.";
+            return;
+        }
+
+        throw Exception("Dispatch::EpollWait() failed!", errno);
+    }
+
+    for (int i = 0; i < r; ++i)
+    {
+        int fd = events_[i].data.fd;
+        uint32_t ev = events_[i].events;
+
+        // we use a pointer into the watch_ table. however, since the
+        // std::vector may regrow when callback handlers are called, this
+        // pointer is reset a lot of times.
+        Watch* w = &watch_[fd];
+
+        if (!w->active) continue;
+
+        // errors and hang-ups are reported by select() as readability and
+        // writability, which lets the callbacks discover them.
+        bool hangup = (ev & (EPOLLERR | EPOLLHUP)) != 0;
+
+        if (hangup && w->read_cb.size() == 0 && w->write_cb.size() == 0) {
+            // epoll reports these events even if not registered, stop
+            // listening until new callbacks are added.
+            LOG << "EpollDispatcher: got hang-up on fd " << fd
+                << " without read or write handler.";
+            Unregister(fd);
+            continue;
+        }
+
+        if ((ev & EPOLLIN) || (hangup && w->read_cb.size()))
+        {
+            // run read callbacks until one returns true (in which case it
+            // wants to be called again), or the read_cb list is empty.
+            while (w->read_cb.size() && w->read_cb.front()() == false) {
+                w = &watch_[fd];
+                w->read_cb.pop_front();
+            }
+            w = &watch_[fd];
+        }
+
+        if ((ev & EPOLLOUT) || (hangup && w->write_cb.size()))
+        {
+            // run write callbacks until one returns true (in which case it
+            // wants to be called again), or the write_cb list is empty.
+            while (w->write_cb.size() && w->write_cb.front()() == false) {
+                w = &watch_[fd];
+                w->write_cb.pop_front();
+            }
+            w = &watch_[fd];
+        }
+
+        if (ev & EPOLLPRI)
+        {
+            if (w->except_cb) {
+                if (!w->except_cb()) {
+                    // callback returned false: remove exception callback
+                    w = &watch_[fd];
+                    w->except_cb = Callback();
+                }
+                w = &watch_[fd];
+            }
+            else {
+                DefaultExceptionCallback();
+            }
+        }
+
+        if (w->read_cb.size() == 0 && w->write_cb.size() == 0 &&
+            !w->except_cb) {
+            // if all callbacks are done, stop listening.
+            w->active = false;
+        }
+
+        Update(fd);
+    }
+}
+
+void EpollDispatcher::Interrupt() {
+    // send one byte to wake up the epoll_wait() handler.
+    ssize_t wb;
+    while ((wb = write(self_pipe_[1], this, 1)) == 0) {
+        LOG1 << "WakeUp: error sending to self-pipe: " << errno;
+    }
+    die_unless(wb == 1);
+}
+
+bool EpollDispatcher::SelfPipeCallback() {
+    while (read(self_pipe_[0],
+                self_pipe_buffer_, sizeof(self_pipe_buffer_)) > 0) {
+        /* repeat, until empty pipe */
+    }
+    return true;
+}
+
+} // namespace tcp
+} // namespace net
+} // namespace thrill
+
+#endif // THRILL_HAVE_NET_TCP_EPOLL
+
+/******************************************************************************/
@@ -0,0 +1,207 @@
+/*******************************************************************************
+ * thrill/net/tcp/epoll_dispatcher.hpp
+ *
+ * Asynchronous callback wrapper around epoll()
+ *
+ * Part of Project Thrill - http://project-thrill.org
+ *
+ * Copyright (C) 2016 Timo Bingmann <tb@panthema.net>
+ *
+ * All rights reserved. Published under the BSD-2 license in the LICENSE file.
+ ******************************************************************************/
+
+#pragma once
+#ifndef THRILL_NET_TCP_EPOLL_DISPATCHER_HEADER
+#define THRILL_NET_TCP_EPOLL_DISPATCHER_HEADER
+
+#include <thrill/common/config.hpp>
+
+#if THRILL_HAVE_NET_TCP_EPOLL
+
+#include <thrill/common/delegate.hpp>
+#include <thrill/common/die.hpp>
+#include <thrill/common/logger.hpp>
+#include <thrill/common/porting.hpp>
+#include <thrill/mem/allocator.hpp>
+#include <thrill/net/connection.hpp>
+#include <thrill/net/dispatcher.hpp>
+#include <thrill/net/exception.hpp>
+#include <thrill/net/tcp/connection.hpp>
+#include <thrill/net/tcp/socket.hpp>
+
+#include <sys/epoll.h>
+#include <unistd.h>
+
+#include <cerrno>
+#include <chrono>
+#include <csignal>
+#include <deque>
+#include <functional>
+#include <vector>
+
+namespace thrill {
+namespace net {
+namespace tcp {
+
+//! \addtogroup net_tcp TCP Socket API
+//! \{
+
+/*!
+ * EpollDispatcher is a drop-in replacement for SelectDispatcher using Linux's
+ * epoll() interface. It has no limit on file descriptor numbers, and the cost
+ * of one dispatch iteration depends only on the number of ready file
+ * descriptors, not on the number of watched ones.
+ *
+ * The file descriptors are registered level-triggered, which keeps the exact
+ * semantics of SelectDispatcher: a callback which returns true is called again
+ * as long as its file descriptor is ready. Edge-triggered notification would
+ * require callbacks to drain the socket until EAGAIN, which the asynchronous
+ * read and write callbacks of net::Dispatcher do not.
+ */
+class EpollDispatcher final : public net::Dispatcher
+{
+    static constexpr bool debug = false;
+
+public:
+    //! type for file descriptor readiness callbacks
+    using Callback = AsyncCallback;
+
+    //! constructor
+    explicit EpollDispatcher(mem::Manager& mem_manager);
+
+    ~EpollDispatcher();
+
+    //! Grow table if needed
+    void CheckSize(int fd) {
+        assert(fd >= 0);
+        if (static_cast<size_t>(fd) >= watch_.size())
+            watch_.resize(fd + 1, Watch(mem_manager_));
+    }
+
+    //! Register a buffered read callback and a default exception callback.
+    void AddRead(int fd, const Callback& read_cb) {
+        CheckSize(fd);
+        watch_[fd].active = true;
+        watch_[fd].read_cb.emplace_back(read_cb);
+        Update(fd);
+    }
+
+    //! Register a buffered read callback and a default exception callback.
+    void AddRead(net::Connection& c, const Callback& read_cb) final {
+        assert(dynamic_cast<Connection*>(&c));
+        Connection& tc = static_cast<Connection&>(c);
+        int fd = tc.GetSocket().fd();
+        return AddRead(fd, read_cb);
+    }
+
+    //! Register a buffered write callback and a default exception callback.
+    void AddWrite(net::Connection& c, const Callback& write_cb) final {
+        assert(dynamic_cast<Connection*>(&c));
+        Connection& tc = static_cast<Connection&>(c);
+        int fd = tc.GetSocket().fd();
+        CheckSize(fd);
+        watch_[fd].active = true;
+        watch_[fd].write_cb.emplace_back(write_cb);
+        Update(fd);
+    }
+
+    //! Register a buffered write callback and a default exception callback.
+    void SetExcept(net::Connection& c, const Callback& except_cb) {
+        assert(dynamic_cast<Connection*>(&c));
+        Connection& tc = static_cast<Connection&>(c);
+        int fd = tc.GetSocket().fd();
+        CheckSize(fd);
+        watch_[fd].active = true;
+        watch_[fd].except_cb = except_cb;
+        Update(fd);
+    }
+
+    //! Cancel all callbacks on a given fd.
+    void Cancel(net::Connection& c) final {
+        assert(dynamic_cast<Connection*>(&c));
+        Connection& tc = static_cast<Connection&>(c);
+        int fd = tc.GetSocket().fd();
+        CheckSize(fd);
+
+        if (watch_[fd].read_cb.size() == 0 &&
+            watch_[fd].write_cb.size() == 0)
+            LOG << "EpollDispatcher::Cancel() fd=" << fd
+                << " called with no callbacks registered.";
+
+        Watch& w = watch_[fd];
+        w.read_cb.clear();
+        w.write_cb.clear();
+        w.except_cb = Callback();
+        w.active = false;
+        Update(fd);
+    }
+
+    //! Run one iteration of dispatching epoll_wait().
+    void DispatchOne(const std::chrono::milliseconds& timeout) final;
+
+    //! Interrupt the current epoll_wait() via self-pipe
+    void Interrupt() final;
+
+private:
+    //! epoll file descriptor
+    int epoll_fd_;
+
+    //! self-pipe to wake up epoll_wait().
+    int self_pipe_[2];
+
+    //! buffer to receive one byte signals from self-pipe
+    char self_pipe_buffer_[32];
+
+    //! callback vectors per watched file descriptor
+    struct Watch {
+        //! boolean check whether any callbacks are registered
+        bool                 active = false;
+        //! events currently registered with epoll for fd, zero if none.
+        uint32_t             events = 0;
+        //! queue of callbacks for fd.
+        mem::deque<Callback> read_cb, write_cb;
+        //! only one exception callback for the fd.
+        Callback             except_cb;
+
+        explicit Watch(mem::Manager& mem_manager)
+            : read_cb(mem::Allocator<Callback>(mem_manager)),
+              write_cb(mem::Allocator<Callback>(mem_manager)) { }
+    };
+
+    //! handlers for all registered file descriptors.
+    mem::vector<Watch> watch_ { mem::Allocator<Watch>(mem_manager_) };
+
+    //! maximum number of events returned by one epoll_wait()
+    static constexpr size_t max_events_ = 256;
+
+    //! buffer for events returned by epoll_wait()
+    struct epoll_event events_[max_events_];
+
+    //! Register the events for which fd has callbacks with epoll: readability
+    //! for read callbacks, writability for write callbacks, and exceptions if
+    //! any callback exists (like SelectDispatcher).
+    void Update(int fd);
+
+    //! Remove fd from the epoll set, regardless of its callbacks.
+    void Unregister(int fd);
+
+    //! Default exception handler
+    static bool DefaultExceptionCallback() {
+        throw Exception("EpollDispatcher() exception on socket!", errno);
+    }
+
+    //! Self-pipe callback
+    bool SelfPipeCallback();
+};
+
+//! \}
+
+} // namespace tcp
+} // namespace net
+} // namespace thrill
+
+#endif // THRILL_HAVE_NET_TCP_EPOLL
+
+#endif // !THRILL_NET_TCP_EPOLL_DISPATCHER_HEADER
+
+/******************************************************************************/
@@ -13,10 +13,15 @@
  ******************************************************************************/
 
 #include <thrill/common/logger.hpp>
+#include <thrill/common/die.hpp>
 #include <thrill/net/tcp/construct.hpp>
+#include <thrill/net/tcp/epoll_dispatcher.hpp>
 #include <thrill/net/tcp/group.hpp>
 #include <thrill/net/tcp/select_dispatcher.hpp>
+#include <thrill/net/tcp/uring_dispatcher.hpp>
 
+#include <cstdlib>
+#include <cstring>
 #include <random>
 #include <string>
 #include <thread>
@@ -29,8 +34,31 @@ namespace tcp {
 
 std::unique_ptr<Dispatcher>
 Group::ConstructDispatcher(mem::Manager& mem_manager) const {
-    // construct tcp::SelectDispatcher
-    return std::make_unique<SelectDispatcher>(mem_manager);
+    // parse environment: THRILL_NET_DISPATCHER
+    const char* env_dispatcher = getenv("THRILL_NET_DISPATCHER");
+
+    if (!env_dispatcher || !*env_dispatcher ||
+        strcmp(env_dispatcher, "select") == 0) {
+        // construct tcp::SelectDispatcher
+        return std::make_unique<SelectDispatcher>(mem_manager);
+    }
+
+#if THRILL_HAVE_NET_TCP_EPOLL
+    if (strcmp(env_dispatcher, "epoll") == 0) {
+        // construct tcp::EpollDispatcher
+        return std::make_unique<EpollDispatcher>(mem_manager);
+    }
+#endif
+
+#if THRILL_HAVE_IO_URING
+    if (strcmp(env_dispatcher, "uring") == 0) {
+        // construct tcp::UringDispatcher
+        return std::make_unique<UringDispatcher>(mem_manager);
+    }
+#endif
+
+    die("ERROR: network dispatcher THRILL_NET_DISPATCHER=" << env_dispatcher
+        << " is not supported.");
 }
 
 std::vector<std::unique_ptr<Group> > Group::ConstructLoopbackMesh(
@@ -22,6 +22,7 @@
 #include <fcntl.h>
 #include <netinet/in.h>
 #include <sys/socket.h>
+#include <sys/uio.h>
 #include <unistd.h>
 
 #include <cassert>
@@ -365,6 +366,30 @@ public:
         return r;
     }
 
+    //! Gather send of iovcnt pieces from iov in one sendmsg() call, may
+    //! return short-sends.
+    ssize_t sendmsg_one(const struct iovec* iov, size_t iovcnt, int flags = 0) {
+        assert(IsValid());
+
+        struct msghdr msg;
+        memset(&msg, 0, sizeof(msg));
+        msg.msg_iov = const_cast<struct iovec*>(iov);
+        msg.msg_iovlen = iovcnt;
+
+        LOG << "Socket::sendmsg_one()"
+            << " fd_=" << fd_
+            << " iovcnt=" << iovcnt
+            << " flags=" << flags;
+
+        ssize_t r = ::sendmsg(fd_, &msg, flags);
+
+        LOG << "done Socket::sendmsg_one()"
+            << " fd_=" << fd_
+            << " return=" << r;
+
+        return r;
+    }
+
     //! Send (data,size) to socket, retry sends if short-sends occur.
     ssize_t send(const void* data, size_t size, int flags = 0) {
         assert(IsValid());
@@ -0,0 +1,229 @@
+/*******************************************************************************
+ * thrill/net/tcp/uring_dispatcher.cpp
+ *
+ * Asynchronous callback wrapper around io_uring poll requests
+ *
+ * Part of Project Thrill - http://project-thrill.org
+ *
+ * Copyright (C) 2016 Timo Bingmann <tb@panthema.net>
+ *
+ * All rights reserved. Published under the BSD-2 license in the LICENSE file.
+ ******************************************************************************/
+
+#include <thrill/net/tcp/uring_dispatcher.hpp>
+
+#if THRILL_HAVE_IO_URING
+
+#include <poll.h>
+
+#include <algorithm>
+#include <limits>
+
+namespace thrill {
+namespace net {
+namespace tcp {
+
+UringDispatcher::UringDispatcher(mem::Manager& mem_manager)
+    : net::Dispatcher(mem_manager), ring_(max_events_) {
+
+    if (!ring_.has_ext_arg())
+        throw Exception("UringDispatcher() requires io_uring_enter() "
+                        "with timeout argument (Linux 5.11)");
+
+    // allocate self-pipe
+    common::MakePipe(self_pipe_);
+
+    if (!Socket::SetNonBlocking(self_pipe_[0], true)) {
+        LOG1 << "UringDispatcher() cannot set up self-pipe for non-blocking reads";
+    }
+
+    // Ignore PIPE signals (received when writing to closed sockets)
+    signal(SIGPIPE, SIG_IGN);
+
+    // wait interrupts via self-pipe.
+    AddRead(self_pipe_[0],
+            Callback::make<UringDispatcher,
+                           & UringDispatcher::SelfPipeCallback>(this));
+}
+
+UringDispatcher::~UringDispatcher() {
+    ::close(self_pipe_[0]);
+    ::close(self_pipe_[1]);
+}
+
+struct io_uring_sqe* UringDispatcher::GetSqe() {
+    struct io_uring_sqe* sqe;
+    while ((sqe = ring_.GetSqe()) == nullptr) {
+        if (ring_.Submit() < 0 && errno != EINTR && errno != EAGAIN &&
+            errno != EBUSY)
+            throw Exception("UringDispatcher() io_uring_enter() failed", errno);
+    }
+    return sqe;
+}
+
+void UringDispatcher::Arm(int fd) {
+    Watch& w = watch_[fd];
+    w.dirty = false;
+
+    uint32_t events = 0;
+    if (w.read_cb.size()) events |= POLLIN;
+    if (w.write_cb.size()) events |= POLLOUT;
+    // unlike epoll, io_uring reports the wake-up mask of a socket, which
+    // includes POLLPRI for any incoming data. Hence urgent data is only
+    // watched if an exception callback was set.
+    if (w.except_cb) events |= POLLPRI;
+
+    if (events == w.armed) return;
+
+    if (w.armed != 0) {
+        // remove the armed poll request, it is re-armed with the new events
+        // when its cancellation completes. This also removes polls of fds
+        // without callbacks, which may be closed and reused.
+        if (!w.removing) {
+            struct io_uring_sqe* sqe = GetSqe();
+            sqe->opcode = IORING_OP_POLL_REMOVE;
+            sqe->fd = -1;
+            sqe->addr = static_cast<uint64_t>(fd);
+            sqe->user_data = remove_tag_;
+            w.removing = true;
+        }
+        return;
+    }
+
+    struct io_uring_sqe* sqe = GetSqe();
+    sqe->opcode = IORING_OP_POLL_ADD;
+    sqe->fd = fd;
+    sqe->poll32_events = events;
+    sqe->user_data = static_cast<uint64_t>(fd);
+    w.armed = events;
+}
+
+//! Run one iteration of dispatching io_uring poll completions.
+void UringDispatcher::DispatchOne(const std::chrono::milliseconds& timeout) {
+
+    // prepare poll requests of all changed fds.
+    for (size_t i = 0; i < dirty_.size(); ++i)
+        Arm(dirty_[i]);
+    dirty_.clear();
+
+    LOG << "Performing io_uring_enter() with timeout " << timeout.count();
+
+    // submit them and wait for at least one completion.
+    int64_t timeout_ns = std::min<int64_t>(
+        timeout.count(), std::numeric_limits<int64_t>::max() / 1000000);
+    timeout_ns *= 1000000;
+
+    if (ring_.SubmitAndWait(1, timeout_ns) < 0) {
+        // timeouts and signals are intended to interrupt the wait.
+        if (errno == ETIME || errno == EINTR) {
+            LOG << "Dispatch(): io_uring_enter() timed out or interrupted.";
+        }
+        else {
+            throw Exception("Dispatch::UringWait() failed!", errno);
+        }
+    }
+
+    // copy out completions, since callbacks may change the poll requests.
+    size_t num_events = 0;
+    struct io_uring_cqe* cqe;
+    while (num_events < max_events_ && (cqe = ring_.PeekCqe()) != nullptr) {
+        events_[num_events].user_data = cqe->user_data;
+        events_[num_events].res = cqe->res;
+        ring_.SeenCqe();
+        ++num_events;
+    }
+
+    for (size_t i = 0; i < num_events; ++i)
+    {
+        if (events_[i].user_data == remove_tag_) continue;
+
+        int fd = static_cast<int>(events_[i].user_data);
+        int res = events_[i].res;
+
+        // we use a pointer into the watch_ table. however, since the
+        // std::vector may regrow when callback handlers are called, this
+        // pointer is reset a lot of times.
+        Watch* w = &watch_[fd];
+
+        // the one-shot poll request is done.
+        w->armed = 0;
+        w->removing = false;
+
+        if (res == -ECANCELED || !w->active) {
+            // removed poll request: re-arm if callbacks remain.
+            Update(fd);
+            continue;
+        }
+
+        // errors are reported like hang-ups, which lets the callbacks discover
+        // them.
+        uint32_t ev = res < 0 ? POLLERR : static_cast<uint32_t>(res);
+        bool hangup = (ev & (POLLERR | POLLHUP)) != 0;
+
+        if ((ev & POLLIN) || (hangup && w->read_cb.size()))
+        {
+            // run read callbacks until one returns true (in which case it
+            // wants to be called again), or the read_cb list is empty.
+            while (w->read_cb.size() && w->read_cb.front()() == false) {
+                w = &watch_[fd];
+                w->read_cb.pop_front();
+            }
+            w = &watch_[fd];
+        }
+
+        if ((ev & POLLOUT) || (hangup && w->write_cb.size()))
+        {
+            // run write callbacks until one returns true (in which case it
+            // wants to be called again), or the write_cb list is empty.
+            while (w->write_cb.size() && w->write_cb.front()() == false) {
+                w = &watch_[fd];
+                w->write_cb.pop_front();
+            }
+            w = &watch_[fd];
+        }
+
+        if ((ev & POLLPRI) && w->except_cb)
+        {
+            if (!w->except_cb()) {
+                // callback returned false: remove exception callback
+                w = &watch_[fd];
+                w->except_cb = Callback();
+            }
+            w = &watch_[fd];
+        }
+
+        if (w->read_cb.size() == 0 && w->write_cb.size() == 0 &&
+            !w->except_cb) {
+            // if all callbacks are done, stop listening.
+            w->active = false;
+        }
+
+        // re-arm the poll request in the next iteration.
+        Update(fd);
+    }
+}
+
+void UringDispatcher::Interrupt() {
+    // send one byte to wake up the io_uring_enter() handler.
+    ssize_t wb;
+    while ((wb = write(self_pipe_[1], this, 1)) == 0) {
+        LOG1 << "WakeUp: error sending to self-pipe: " << errno;
+    }
+    die_unless(wb == 1);
+}
+
+bool UringDispatcher::SelfPipeCallback() {
+    while (read(self_pipe_[0],
+                self_pipe_buffer_, sizeof(self_pipe_buffer_)) > 0) {
+        /* repeat, until empty pipe */
+    }
+    return true;
+}
+
+} // namespace tcp
+} // namespace net
+} // namespace thrill
+
+#endif // THRILL_HAVE_IO_URING
+
+/******************************************************************************/
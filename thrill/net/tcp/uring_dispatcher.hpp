@@ -0,0 +1,226 @@
+/*******************************************************************************
+ * thrill/net/tcp/uring_dispatcher.hpp
+ *
+ * Asynchronous callback wrapper around io_uring poll requests
+ *
+ * Part of Project Thrill - http://project-thrill.org
+ *
+ * Copyright (C) 2016 Timo Bingmann <tb@panthema.net>
+ *
+ * All rights reserved. Published under the BSD-2 license in the LICENSE file.
+ ******************************************************************************/
+
+#pragma once
+#ifndef THRILL_NET_TCP_URING_DISPATCHER_HEADER
+#define THRILL_NET_TCP_URING_DISPATCHER_HEADER
+
+#include <thrill/common/config.hpp>
+
+#if THRILL_HAVE_IO_URING
+
+#include <thrill/common/delegate.hpp>
+#include <thrill/common/die.hpp>
+#include <thrill/common/io_uring.hpp>
+#include <thrill/common/logger.hpp>
+#include <thrill/common/porting.hpp>
+#include <thrill/mem/allocator.hpp>
+#include <thrill/net/connection.hpp>
+#include <thrill/net/dispatcher.hpp>
+#include <thrill/net/exception.hpp>
+#include <thrill/net/tcp/connection.hpp>
+#include <thrill/net/tcp/socket.hpp>
+
+#include <unistd.h>
+
+#include <cerrno>
+#include <chrono>
+#include <csignal>
+#include <deque>
+#include <functional>
+#include <vector>
+
+namespace thrill {
+namespace net {
+namespace tcp {
+
+//! \addtogroup net_tcp TCP Socket API
+//! \{
+
+/*!
+ * UringDispatcher is a drop-in replacement for SelectDispatcher using Linux's
+ * io_uring interface. Readiness of each file descriptor is watched by a
+ * one-shot IORING_OP_POLL_ADD request, which is re-armed after its callbacks
+ * ran, as long as callbacks remain. All poll requests changed during one
+ * iteration are submitted together with the wait for completions in a single
+ * io_uring_enter() call.
+ *
+ * The asynchronous reads and writes of net::Dispatcher remain readiness based:
+ * the callbacks perform the socket calls once io_uring reports readiness.
+ *
+ * Requires Linux 5.11 for io_uring_enter() with a timeout argument.
+ */
+class UringDispatcher final : public net::Dispatcher
+{
+    static constexpr bool debug = false;
+
+public:
+    //! type for file descriptor readiness callbacks
+    using Callback = AsyncCallback;
+
+    //! constructor
+    explicit UringDispatcher(mem::Manager& mem_manager);
+
+    ~UringDispatcher();
+
+    //! Grow table if needed
+    void CheckSize(int fd) {
+        assert(fd >= 0);
+        if (static_cast<size_t>(fd) >= watch_.size())
+            watch_.resize(fd + 1, Watch(mem_manager_));
+    }
+
+    //! Register a buffered read callback and a default exception callback.
+    void AddRead(int fd, const Callback& read_cb) {
+        CheckSize(fd);
+        watch_[fd].active = true;
+        watch_[fd].read_cb.emplace_back(read_cb);
+        Update(fd);
+    }
+
+    //! Register a buffered read callback and a default exception callback.
+    void AddRead(net::Connection& c, const Callback& read_cb) final {
+        assert(dynamic_cast<Connection*>(&c));
+        Connection& tc = static_cast<Connection&>(c);
+        int fd = tc.GetSocket().fd();
+        return AddRead(fd, read_cb);
+    }
+
+    //! Register a buffered write callback and a default exception callback.
+    void AddWrite(net::Connection& c, const Callback& write_cb) final {
+        assert(dynamic_cast<Connection*>(&c));
+        Connection& tc = static_cast<Connection&>(c);
+        int fd = tc.GetSocket().fd();
+        CheckSize(fd);
+        watch_[fd].active = true;
+        watch_[fd].write_cb.emplace_back(write_cb);
+        Update(fd);
+    }
+
+    //! Register a buffered write callback and a default exception callback.
+    void SetExcept(net::Connection& c, const Callback& except_cb) {
+        assert(dynamic_cast<Connection*>(&c));
+        Connection& tc = static_cast<Connection&>(c);
+        int fd = tc.GetSocket().fd();
+        CheckSize(fd);
+        watch_[fd].active = true;
+        watch_[fd].except_cb = except_cb;
+        Update(fd);
+    }
+
+    //! Cancel all callbacks on a given fd.
+    void Cancel(net::Connection& c) final {
+        assert(dynamic_cast<Connection*>(&c));
+        Connection& tc = static_cast<Connection&>(c);
+        int fd = tc.GetSocket().fd();
+        CheckSize(fd);
+
+        if (watch_[fd].read_cb.size() == 0 &&
+            watch_[fd].write_cb.size() == 0)
+            LOG << "UringDispatcher::Cancel() fd=" << fd
+                << " called with no callbacks registered.";
+
+        Watch& w = watch_[fd];
+        w.read_cb.clear();
+        w.write_cb.clear();
+        w.except_cb = Callback();
+        w.active = false;
+        Update(fd);
+    }
+
+    //! Run one iteration of dispatching io_uring poll completions.
+    void DispatchOne(const std::chrono::milliseconds& timeout) final;
+
+    //! Interrupt the current io_uring_enter() via self-pipe
+    void Interrupt() final;
+
+private:
+    //! io_uring instance
+    common::IoUring ring_;
+
+    //! self-pipe to wake up io_uring_enter().
+    int self_pipe_[2];
+
+    //! buffer to receive one byte signals from self-pipe
+    char self_pipe_buffer_[32];
+
+    //! callback vectors per watched file descriptor
+    struct Watch {
+        //! boolean check whether any callbacks are registered
+        bool                 active = false;
+        //! whether the fd is in the dirty_ list
+        bool                 dirty = false;
+        //! whether a POLL_REMOVE for the armed poll request is pending
+        bool                 removing = false;
+        //! events of the currently armed poll request, zero if none.
+        uint32_t             armed = 0;
+        //! queue of callbacks for fd.
+        mem::deque<Callback> read_cb, write_cb;
+        //! only one exception callback for the fd.
+        Callback             except_cb;
+
+        explicit Watch(mem::Manager& mem_manager)
+            : read_cb(mem::Allocator<Callback>(mem_manager)),
+              write_cb(mem::Allocator<Callback>(mem_manager)) { }
+    };
+
+    //! handlers for all registered file descriptors.
+    mem::vector<Watch> watch_ { mem::Allocator<Watch>(mem_manager_) };
+
+    //! file descriptors whose poll request may need to change
+    mem::vector<int> dirty_ { mem::Allocator<int>(mem_manager_) };
+
+    //! user_data of POLL_REMOVE requests, whose completions are ignored.
+    static constexpr uint64_t remove_tag_ = ~uint64_t(0);
+
+    //! maximum number of completions handled by one DispatchOne()
+    static constexpr size_t max_events_ = 256;
+
+    //! completions copied out of the ring: user_data and result
+    struct Event {
+        uint64_t user_data;
+        int      res;
+    };
+    Event events_[max_events_];
+
+    //! Mark fd for re-evaluation of its poll request in the next iteration.
+    void Update(int fd) {
+        Watch& w = watch_[fd];
+        if (w.dirty) return;
+        w.dirty = true;
+        dirty_.push_back(fd);
+    }
+
+    //! Prepare POLL_ADD or POLL_REMOVE requests such that the armed events
+    //! match the registered callbacks: readability for read callbacks,
+    //! writability for write callbacks, and urgent data only for an exception
+    //! callback.
+    void Arm(int fd);
+
+    //! Get a submission queue entry, flushing the ring if it is full.
+    struct io_uring_sqe * GetSqe();
+
+    //! Self-pipe callback
+    bool SelfPipeCallback();
+};
+
+//! \}
+
+} // namespace tcp
+} // namespace net
+} // namespace thrill
+
+#endif // THRILL_HAVE_IO_URING
+
+#endif // !THRILL_NET_TCP_URING_DISPATCHER_HEADER
+
+/******************************************************************************/